@@ -5,17 +5,60 @@
 #include <lvgl.h>
 #include <kodedot/pin_config.h>
 #include <bb_captouch.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 /**
  * @brief High-level manager that initializes and wires up the display, LVGL, and touch input.
  *
  * Responsibilities:
  * - Bring up the panel using Arduino_GFX
- * - Allocate LVGL draw buffers (prefer PSRAM, fallback to SRAM)
+ * - Allocate LVGL draw buffers: full-height in PSRAM, or small DMA-capable
+ *   internal-SRAM stripes (see RenderStrategy)
  * - Register LVGL display and input drivers
  * - Provide simple helpers for brightness and touch reading
+ * - Optionally flush from a worker task so LVGL renders the next buffer
+ *   while the previous one is still on the QSPI bus
  */
 class DisplayManager {
+public:
+    /**
+     * @brief Where LVGL renders.
+     *
+     * PSRAM_FULL: two full-frame buffers (~800 KB) in PSRAM; few, large flushes,
+     * but every rendered pixel is written to and DMA-read from PSRAM, competing
+     * with audio buffers for PSRAM bandwidth.
+     * SRAM_STRIPES: two buffers of a few dozen lines in DMA-capable internal
+     * SRAM; more flushes per frame, no PSRAM traffic for rendering.
+     */
+    enum RenderStrategy : uint8_t {
+        RENDER_PSRAM_FULL = 0,
+        RENDER_SRAM_STRIPES = 1
+    };
+
+    /**
+     * @brief Full-screen redraw benchmark of the current buffers.
+     */
+    struct RenderBenchResult {
+        RenderStrategy strategy;
+        uint16_t buffer_lines;
+        float fps;
+        uint32_t frame_us;
+        uint32_t psram_bytes_per_s;  // estimated draw-buffer PSRAM traffic (render writes + DMA reads)
+    };
+
+    /**
+     * @brief Panel transfer timing. A frame ends with LVGL's last flushed area.
+     */
+    struct FlushStats {
+        uint32_t frames;
+        uint32_t last_frame_us;   // QSPI transfer time of the last complete frame
+        uint32_t max_frame_us;
+        uint64_t total_us;        // all transfers since init()
+        uint32_t render_wait_us;  // time LVGL spent blocked waiting on a busy flush (async only)
+    };
+
 private:
     // Hardware interfaces
     Arduino_DataBus *bus;
@@ -27,10 +70,39 @@ private:
     lv_color_t *buf;
     lv_color_t *buf2;
     uint32_t last_tick_ms;
+    RenderStrategy render_strategy;
+    uint16_t buffer_lines;
+
+    // Async flush: LVGL hands the area to flush_task and keeps rendering into the other buffer
+    struct FlushJob {
+        lv_display_t *disp;
+        lv_area_t area;
+        uint8_t *px_map;
+        bool last;
+    };
+    TaskHandle_t flush_task;
+    QueueHandle_t flush_queue;
+    SemaphoreHandle_t flush_done;
+    SemaphoreHandle_t panel_mutex;   // QSPI bus: flush transfers vs. panel commands (brightness)
+    volatile bool flush_busy;
+
+    // Flush timing (written by whichever context performs the transfer)
+    FlushStats flush_stats;
+    uint32_t frame_accum_us;
+
+    // Touch sample cached by pollTouch(): bit 31 = pressed, bits 30..16 = y, 15..0 = x
+    volatile uint32_t touch_cache;
+    bool external_touch_polling;
     
     // Static callbacks required by LVGL v9
     static void disp_flush_callback(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
     static void touchpad_read_callback(lv_indev_t *indev, lv_indev_data_t *data);
+    static void flush_wait_callback(lv_display_t *disp);
+    static void flushTaskEntry(void *arg);
+
+    void writeArea(const lv_area_t *area, uint8_t *px_map, bool last);
+    void waitFlushIdle();
+    bool allocateBuffers(RenderStrategy strategy, uint16_t lines);
     
     // Singleton-like back-reference used by static callbacks
     static DisplayManager* instance;
@@ -41,9 +113,31 @@ public:
     
     /**
      * @brief Fully initialize display, LVGL, and touch.
+     * @param strategy Draw buffer placement (falls back to PSRAM_FULL if SRAM is short)
+     * @param stripe_lines Stripe height for RENDER_SRAM_STRIPES
      * @return true on success, false otherwise
      */
-    bool init();
+    bool init(RenderStrategy strategy = RENDER_PSRAM_FULL, uint16_t stripe_lines = LCD_STRIPE_DEFAULT_LINES);
+
+    /**
+     * @brief Reallocate the draw buffers with another strategy (waits for pending flushes).
+     */
+    bool setRenderStrategy(RenderStrategy strategy, uint16_t stripe_lines = LCD_STRIPE_DEFAULT_LINES);
+    RenderStrategy getRenderStrategy() const { return render_strategy; }
+    uint16_t getBufferLines() const { return buffer_lines; }
+
+    /**
+     * @brief Time @p frames full-screen redraws of the active screen with the current buffers.
+     */
+    RenderBenchResult benchmarkRender(uint32_t frames);
+
+    /**
+     * @brief Benchmark every stripe height from LCD_STRIPE_MIN_LINES to
+     * LCD_STRIPE_MAX_LINES and keep the fastest (switches to SRAM stripes).
+     * Call once the UI exists so the benchmark renders real content.
+     * @return Chosen stripe height, or 0 if internal SRAM could not hold the stripes
+     */
+    uint16_t tuneStripeHeight(uint32_t frames_per_candidate);
     
     /**
      * @brief Get the underlying Arduino_GFX panel instance.
@@ -79,6 +173,35 @@ public:
      * @return true if there is an active touch
      */
     bool getTouchCoordinates(int16_t &x, int16_t &y);
+
+    /**
+     * @brief Move panel transfers to a worker task (call after init()).
+     *
+     * The flush callback only queues the area and returns; the worker sends
+     * it and calls lv_display_flush_ready() on completion. With two draw
+     * buffers LVGL renders into one while the other is being transferred.
+     * The QSPI driver waits for its DMA by polling, so put the worker on the
+     * core that is not running LVGL.
+     * @return true if the worker is running
+     */
+    bool enableAsyncFlush(BaseType_t core, UBaseType_t priority);
+
+    /**
+     * @brief Snapshot of panel transfer timing.
+     */
+    FlushStats getFlushStats() const { return flush_stats; }
+
+    /**
+     * @brief Let another task own touch I2C traffic (see I2CBusManager).
+     * When enabled, LVGL reads the sample cached by pollTouch() and never touches the bus.
+     */
+    void setExternalTouchPolling(bool enabled) { external_touch_polling = enabled; }
+
+    /**
+     * @brief Read the touch controller once and cache the result for LVGL.
+     * @return true if the controller answered
+     */
+    bool pollTouch();
 };
 
 
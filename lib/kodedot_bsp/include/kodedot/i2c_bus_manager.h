@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+/**
+ * @brief Single owner of the shared I2C bus (touch, IO expander, PMIC/fuel gauge).
+ *
+ * Every device registers a job: one function that performs that device's
+ * whole batched transaction (e.g. both expander ports in one read16()).
+ * A dedicated task runs the jobs one at a time, so transactions from
+ * different cores never interleave. Jobs run when triggered (task or ISR),
+ * when their period elapses, or when they rescheduled themselves; when
+ * several are due the highest priority (lowest value) runs first.
+ *
+ * Bus time is accounted per device.
+ */
+class I2CBusManager {
+public:
+    /**
+     * @brief Device job. Runs on the bus task; returns false on a bus error.
+     */
+    typedef bool (*JobFn)(void *ctx);
+
+    enum Priority : uint8_t {
+        PRIORITY_INPUT = 0,     // buttons: key-up latency
+        PRIORITY_TOUCH = 1,     // touch: UI responsiveness
+        PRIORITY_TELEMETRY = 2  // battery / charger: best effort
+    };
+
+    struct DeviceStats {
+        const char *name;
+        uint32_t runs;
+        uint32_t errors;
+        uint64_t busy_us;  // total time spent in the job
+        uint32_t max_us;   // longest single run
+    };
+
+    static const int MAX_DEVICES = 8;
+
+    I2CBusManager();
+
+    /**
+     * @brief Register a device job (call before begin()).
+     * @param period_ms Run at least this often (0 = only when triggered)
+     * @return Device id, or -1 if the table is full
+     */
+    int registerDevice(const char *name, Priority priority, JobFn fn, void *ctx, uint32_t period_ms);
+
+    /**
+     * @brief Start the bus task.
+     */
+    bool begin(UBaseType_t task_priority, BaseType_t core);
+
+    /**
+     * @brief Ask for a device job to run as soon as possible. Repeated triggers coalesce.
+     */
+    void trigger(int id);
+
+    /**
+     * @brief ISR-safe variant of trigger().
+     */
+    void IRAM_ATTR triggerFromISR(int id);
+
+    /**
+     * @brief From inside a job: run the same job again after @p delay_ms.
+     */
+    void schedule(int id, uint32_t delay_ms);
+
+    /**
+     * @brief Exclusive bus access for code outside the jobs (e.g. late driver init).
+     */
+    bool lock(TickType_t timeout = portMAX_DELAY);
+    void unlock();
+
+    /**
+     * @brief Snapshot of a device's bus-time counters.
+     */
+    DeviceStats getStats(int id) const;
+    int deviceCount() const { return device_count; }
+
+    /**
+     * @brief Print per-device bus time (and share of wall time since the last call).
+     */
+    void logStats();
+
+private:
+    struct Device {
+        const char *name;
+        Priority priority;
+        JobFn fn;
+        void *ctx;
+        uint32_t period_ms;
+        uint32_t next_due_ms;
+        bool has_deadline;
+        volatile bool pending;
+        DeviceStats stats;
+        uint64_t logged_busy_us;
+    };
+
+    Device devices[MAX_DEVICES];
+    int device_count;
+    TaskHandle_t task;
+    SemaphoreHandle_t mutex;
+    uint32_t last_log_ms;
+
+    static void taskEntry(void *arg);
+    void run();
+};
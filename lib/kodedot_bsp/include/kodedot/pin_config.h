@@ -28,6 +28,11 @@
 #define LCD_DRAW_BUFF_DOUBLE  1
 // Use full-height buffer (PSRAM available)
 #define LCD_DRAW_BUFF_HEIGHT  LCD_HEIGHT
+// Internal-SRAM stripe render mode: line counts tried by the stripe benchmark (even: panel rounder)
+#define LCD_STRIPE_MIN_LINES      20
+#define LCD_STRIPE_MAX_LINES      60
+#define LCD_STRIPE_STEP_LINES     10
+#define LCD_STRIPE_DEFAULT_LINES  40
 
 // LCD pins (QSPI)
 #define LCD_SCLK              17
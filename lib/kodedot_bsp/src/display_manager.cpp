@@ -1,5 +1,6 @@
 #include <kodedot/display_manager.h>
 #include <Preferences.h>
+#include <esp_timer.h>
 
 // Forward declarations for internal helpers
 extern "C" void __wrap_esp_ota_mark_app_valid_cancel_rollback(void);
@@ -43,11 +44,19 @@ static void display_rounder_event_cb(lv_event_t *e) {
     }
 }
 
-DisplayManager::DisplayManager() : bus(nullptr), gfx(nullptr), display(nullptr), buf(nullptr), buf2(nullptr), last_tick_ms(0) {
+DisplayManager::DisplayManager() : bus(nullptr), gfx(nullptr), display(nullptr), buf(nullptr), buf2(nullptr), last_tick_ms(0),
+                                   render_strategy(RENDER_PSRAM_FULL), buffer_lines(0),
+                                   flush_task(nullptr), flush_queue(nullptr), flush_done(nullptr), panel_mutex(nullptr),
+                                   flush_busy(false), flush_stats{0, 0, 0, 0, 0}, frame_accum_us(0),
+                                   touch_cache(0), external_touch_polling(false) {
     instance = this;
 }
 
 DisplayManager::~DisplayManager() {
+    if (flush_task) vTaskDelete(flush_task);
+    if (flush_queue) vQueueDelete(flush_queue);
+    if (flush_done) vSemaphoreDelete(flush_done);
+    if (panel_mutex) vSemaphoreDelete(panel_mutex);
     if (buf) free(buf);
     if (buf2) free(buf2);
     if (gfx) {
@@ -59,7 +68,7 @@ DisplayManager::~DisplayManager() {
     instance = nullptr;
 }
 
-bool DisplayManager::init() {
+bool DisplayManager::init(RenderStrategy strategy, uint16_t stripe_lines) {
     Serial.println("Bringing up display subsystem...");
     
     // Initialize NVS (preferences)
@@ -116,46 +125,17 @@ bool DisplayManager::init() {
     lv_init();
     last_tick_ms = millis();
 
-    // Allocate draw buffers (prefer PSRAM; fallback to internal SRAM)
-    size_t draw_buf_pixels = (size_t)LCD_WIDTH * (size_t)LCD_DRAW_BUFF_HEIGHT;
-    size_t draw_buf_bytes = draw_buf_pixels * sizeof(lv_color_t);
-    Serial.printf("Requesting LVGL draw buffer: %u bytes\n", (unsigned)draw_buf_bytes);
-
-    buf = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (!buf) {
-        // Fallback to internal SRAM with reduced height window
-        size_t fallback_height = 100; // small window to avoid exhausting SRAM
-        draw_buf_pixels = (size_t)LCD_WIDTH * fallback_height;
-        draw_buf_bytes = draw_buf_pixels * sizeof(lv_color_t);
-        Serial.printf("PSRAM not available, using SRAM fallback: %u bytes\n", (unsigned)draw_buf_bytes);
-        buf = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-        if (!buf) {
-            Serial.println("Error: unable to allocate draw buffer in SRAM");
-            return false;
-        }
-    }
-
-    // Try double buffering in PSRAM if there is room
-    buf2 = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    if (!buf2) {
-        // If not enough memory, keep single buffer
-        buf2 = NULL;
-    }
-
     // Create LVGL display and configure rendering
     display = lv_display_create(LCD_WIDTH, LCD_HEIGHT);
     lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
     lv_display_set_flush_cb(display, disp_flush_callback);
     // v9: rounder se implementa como event callback sobre INVALIDATE_AREA
     lv_display_add_event_cb(display, display_rounder_event_cb, LV_EVENT_INVALIDATE_AREA, nullptr);
-    // Provide draw buffers (bytes)
-    lv_display_set_buffers(
-        display,
-        buf,
-        buf2,
-        (uint32_t)draw_buf_bytes,
-        LV_DISPLAY_RENDER_MODE_PARTIAL
-    );
+
+    // Allocate and attach draw buffers
+    if (!allocateBuffers(strategy, stripe_lines)) {
+        return false;
+    }
     Serial.println("LVGL initialized");
 
     // Initialize capacitive touch
@@ -178,6 +158,139 @@ bool DisplayManager::init() {
     return true;
 }
 
+// Allocate both draw buffers for @p strategy and hand them to LVGL
+bool DisplayManager::allocateBuffers(RenderStrategy strategy, uint16_t lines) {
+    waitFlushIdle();
+    if (buf) free(buf);
+    if (buf2) free(buf2);
+    buf = nullptr;
+    buf2 = nullptr;
+
+    size_t draw_buf_bytes = 0;
+
+    if (strategy == RENDER_SRAM_STRIPES) {
+        // Even line count keeps stripe edges aligned with the panel rounder
+        if (lines < 2) lines = 2;
+        if (lines > LCD_STRIPE_MAX_LINES) lines = LCD_STRIPE_MAX_LINES;
+        lines &= ~1;
+        draw_buf_bytes = (size_t)LCD_WIDTH * lines * sizeof(lv_color_t);
+        buf = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        buf2 = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!buf || !buf2) {
+            // No double-buffered stripes in SRAM: go back to PSRAM
+            Serial.printf("SRAM stripes (%u lines) not available, using PSRAM\n", (unsigned)lines);
+            if (buf) free(buf);
+            if (buf2) free(buf2);
+            buf = nullptr;
+            buf2 = nullptr;
+            strategy = RENDER_PSRAM_FULL;
+        } else {
+            Serial.printf("LVGL draw buffers: 2 x %u bytes SRAM stripes (%u lines)\n",
+                          (unsigned)draw_buf_bytes, (unsigned)lines);
+        }
+    }
+
+    if (strategy == RENDER_PSRAM_FULL) {
+        // Allocate draw buffers (prefer PSRAM; fallback to internal SRAM)
+        lines = LCD_DRAW_BUFF_HEIGHT;
+        draw_buf_bytes = (size_t)LCD_WIDTH * lines * sizeof(lv_color_t);
+        Serial.printf("Requesting LVGL draw buffer: %u bytes\n", (unsigned)draw_buf_bytes);
+
+        buf = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!buf) {
+            // Fallback to internal SRAM with reduced height window
+            lines = 100; // small window to avoid exhausting SRAM
+            draw_buf_bytes = (size_t)LCD_WIDTH * lines * sizeof(lv_color_t);
+            Serial.printf("PSRAM not available, using SRAM fallback: %u bytes\n", (unsigned)draw_buf_bytes);
+            buf = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (!buf) {
+                Serial.println("Error: unable to allocate draw buffer in SRAM");
+                return false;
+            }
+        }
+
+        // Try double buffering in PSRAM if there is room (single buffer otherwise)
+        buf2 = (lv_color_t*)heap_caps_malloc(draw_buf_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+
+    render_strategy = strategy;
+    buffer_lines = lines;
+
+    // Provide draw buffers (bytes)
+    lv_display_set_buffers(
+        display,
+        buf,
+        buf2,
+        (uint32_t)draw_buf_bytes,
+        LV_DISPLAY_RENDER_MODE_PARTIAL
+    );
+    return true;
+}
+
+bool DisplayManager::setRenderStrategy(RenderStrategy strategy, uint16_t stripe_lines) {
+    if (!display) return false;
+    bool ok = allocateBuffers(strategy, stripe_lines);
+    if (ok) lv_obj_invalidate(lv_screen_active());
+    return ok;
+}
+
+DisplayManager::RenderBenchResult DisplayManager::benchmarkRender(uint32_t frames) {
+    RenderBenchResult r = {render_strategy, buffer_lines, 0.0f, 0, 0};
+    if (!display || frames == 0) return r;
+
+    waitFlushIdle();
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < frames; i++) {
+        lv_obj_invalidate(lv_screen_active());
+        lv_refr_now(display);
+    }
+    waitFlushIdle();
+    int64_t elapsed = esp_timer_get_time() - t0;
+
+    r.frame_us = (uint32_t)(elapsed / frames);
+    r.fps = r.frame_us ? 1000000.0f / (float)r.frame_us : 0.0f;
+    if (render_strategy == RENDER_PSRAM_FULL) {
+        // Each pixel is written by the renderer and read back by the flush
+        float frame_bytes = (float)LCD_WIDTH * LCD_HEIGHT * sizeof(lv_color_t);
+        r.psram_bytes_per_s = (uint32_t)(frame_bytes * 2.0f * r.fps);
+    }
+    return r;
+}
+
+uint16_t DisplayManager::tuneStripeHeight(uint32_t frames_per_candidate) {
+    if (!display) return 0;
+
+    // Allocate the tallest stripe once and present shorter windows of it to LVGL
+    if (!allocateBuffers(RENDER_SRAM_STRIPES, LCD_STRIPE_MAX_LINES) || render_strategy != RENDER_SRAM_STRIPES) {
+        return 0;
+    }
+
+    uint16_t best_lines = buffer_lines;
+    uint32_t best_us = UINT32_MAX;
+    for (uint16_t lines = LCD_STRIPE_MIN_LINES; lines <= LCD_STRIPE_MAX_LINES; lines += LCD_STRIPE_STEP_LINES) {
+        uint16_t even = lines & ~1;
+        waitFlushIdle();
+        lv_display_set_buffers(display, buf, buf2, (uint32_t)LCD_WIDTH * even * sizeof(lv_color_t),
+                               LV_DISPLAY_RENDER_MODE_PARTIAL);
+        buffer_lines = even;
+
+        RenderBenchResult r = benchmarkRender(frames_per_candidate);
+        Serial.printf("Stripe benchmark: %u lines -> %.1f fps (%u us/frame)\n",
+                      (unsigned)even, r.fps, (unsigned)r.frame_us);
+        // Prefer the smaller stripe unless a taller one is clearly faster (>3%)
+        if (r.frame_us * 103ull < best_us * 100ull) {
+            best_us = r.frame_us;
+            best_lines = even;
+        }
+    }
+
+    // Release the unused part of the stripes
+    allocateBuffers(RENDER_SRAM_STRIPES, best_lines);
+    lv_obj_invalidate(lv_screen_active());
+    Serial.printf("Stripe height selected: %u lines\n", (unsigned)buffer_lines);
+    return render_strategy == RENDER_SRAM_STRIPES ? buffer_lines : 0;
+}
+
 void DisplayManager::update() {
     // Advance LVGL tick with real delta
     uint32_t now = millis();
@@ -189,7 +302,10 @@ void DisplayManager::update() {
 
 void DisplayManager::setBrightness(uint8_t brightness) {
     if (gfx) {
+        // Never interleave a panel command with an in-flight pixel transfer
+        if (panel_mutex) xSemaphoreTake(panel_mutex, portMAX_DELAY);
         gfx->setBrightness(brightness);
+        if (panel_mutex) xSemaphoreGive(panel_mutex);
     }
     // Convert hardware brightness (0-255) to percentage (0-100) and persist in NVS using the same key as EEPROMManager
     uint8_t pct = (uint8_t)(((uint16_t)brightness * 100 + 127) / 255); // round to nearest percentage
@@ -216,24 +332,135 @@ bool DisplayManager::getTouchCoordinates(int16_t &x, int16_t &y) {
     return false;
 }
 
+bool DisplayManager::enableAsyncFlush(BaseType_t core, UBaseType_t priority) {
+    if (flush_task) return true;
+    if (!display) return false;
+
+    flush_queue = xQueueCreate(1, sizeof(FlushJob));
+    flush_done = xSemaphoreCreateBinary();
+    panel_mutex = xSemaphoreCreateMutex();
+    if (!flush_queue || !flush_done || !panel_mutex) {
+        Serial.println("Error: async flush allocation failed");
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(flushTaskEntry, "DispFlushTask", 4096, this, priority, &flush_task, core) != pdPASS) {
+        Serial.println("Error: failed to start display flush task");
+        flush_task = nullptr;
+        return false;
+    }
+
+    // Block (instead of spinning) when LVGL needs a buffer that is still being sent
+    lv_display_set_flush_wait_cb(display, flush_wait_callback);
+    Serial.printf("Async display flush enabled (core %d)\n", (int)core);
+    return true;
+}
+
+// Send one area to the panel and account its transfer time
+void DisplayManager::writeArea(const lv_area_t *area, uint8_t *px_map, bool last) {
+    uint32_t w = (area->x2 - area->x1 + 1);
+    uint32_t h = (area->y2 - area->y1 + 1);
+
+    int64_t t0 = esp_timer_get_time();
+    if (panel_mutex) xSemaphoreTake(panel_mutex, portMAX_DELAY);
+    gfx->startWrite();
+    gfx->writeAddrWindow(area->x1, area->y1, w, h);
+    gfx->writePixels((uint16_t *)px_map, w * h);
+    gfx->endWrite();
+    if (panel_mutex) xSemaphoreGive(panel_mutex);
+    uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+
+    flush_stats.total_us += dt;
+    frame_accum_us += dt;
+    if (last) {
+        flush_stats.frames++;
+        flush_stats.last_frame_us = frame_accum_us;
+        if (frame_accum_us > flush_stats.max_frame_us) flush_stats.max_frame_us = frame_accum_us;
+        frame_accum_us = 0;
+    }
+}
+
+void DisplayManager::flushTaskEntry(void *arg) {
+    DisplayManager *self = static_cast<DisplayManager *>(arg);
+    FlushJob job;
+    while (true) {
+        if (xQueueReceive(self->flush_queue, &job, portMAX_DELAY) != pdTRUE) continue;
+        self->writeArea(&job.area, job.px_map, job.last);
+
+        // Completion: the buffer is free for LVGL again
+        self->flush_busy = false;
+        lv_display_flush_ready(job.disp);
+        xSemaphoreGive(self->flush_done);
+    }
+}
+
+// Block until the flush worker has no area in flight
+void DisplayManager::waitFlushIdle() {
+    while (flush_busy) {
+        if (flush_done) {
+            xSemaphoreTake(flush_done, pdMS_TO_TICKS(10));
+        } else {
+            vTaskDelay(1);
+        }
+    }
+}
+
+// LVGL flush wait callback (async mode): sleep until the worker releases the buffer
+void DisplayManager::flush_wait_callback(lv_display_t *disp) {
+    (void)disp;
+    if (!instance || !instance->flush_busy) return;
+
+    int64_t t0 = esp_timer_get_time();
+    while (instance->flush_busy) {
+        xSemaphoreTake(instance->flush_done, pdMS_TO_TICKS(10));
+    }
+    instance->flush_stats.render_wait_us += (uint32_t)(esp_timer_get_time() - t0);
+}
+
 // LVGL display flush callback
 void DisplayManager::disp_flush_callback(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
     if (!instance || !instance->gfx) return;
-    
-    uint32_t w = (area->x2 - area->x1 + 1);
-    uint32_t h = (area->y2 - area->y1 + 1);
 
-    instance->gfx->startWrite();
-    instance->gfx->writeAddrWindow(area->x1, area->y1, w, h);
-    instance->gfx->writePixels((uint16_t *)px_map, w * h);
-    instance->gfx->endWrite();
+    bool last = lv_display_flush_is_last(disp);
+
+    if (instance->flush_task) {
+        FlushJob job = {disp, *area, px_map, last};
+        instance->flush_busy = true;
+        xQueueSend(instance->flush_queue, &job, portMAX_DELAY);
+        return; // flush_ready comes from the worker
+    }
 
+    instance->writeArea(area, px_map, last);
     lv_display_flush_ready(disp);
 }
 
+bool DisplayManager::pollTouch() {
+    TOUCHINFO ti;
+    // getSamples() also returns false when nobody touches; only a NACK is an error
+    bool pressed = bbct.getSamples(&ti) && ti.count > 0;
+    if (pressed) {
+        touch_cache = 0x80000000u | ((uint32_t)(ti.y[0] & 0x7FFF) << 16) | (uint16_t)ti.x[0];
+    } else {
+        touch_cache = 0;
+    }
+    return true;
+}
+
 // LVGL touch read callback
 void DisplayManager::touchpad_read_callback(lv_indev_t *indev, lv_indev_data_t *data) {
     if (!instance) return;
+
+    // Bus owned by another task: use its latest sample
+    if (instance->external_touch_polling) {
+        uint32_t sample = instance->touch_cache;
+        if (sample & 0x80000000u) {
+            data->state = LV_INDEV_STATE_PRESSED;
+            data->point.x = (int16_t)(sample & 0xFFFF);
+            data->point.y = (int16_t)((sample >> 16) & 0x7FFF);
+        } else {
+            data->state = LV_INDEV_STATE_RELEASED;
+        }
+        return;
+    }
     
     TOUCHINFO ti;
     if(instance->bbct.getSamples(&ti) && ti.count > 0) {
@@ -0,0 +1,143 @@
+#include <kodedot/i2c_bus_manager.h>
+#include <esp_timer.h>
+
+I2CBusManager::I2CBusManager() : device_count(0), task(nullptr), mutex(nullptr), last_log_ms(0) {
+}
+
+int I2CBusManager::registerDevice(const char *name, Priority priority, JobFn fn, void *ctx, uint32_t period_ms) {
+    if (task || device_count >= MAX_DEVICES || !fn) return -1;
+
+    Device &d = devices[device_count];
+    d.name = name;
+    d.priority = priority;
+    d.fn = fn;
+    d.ctx = ctx;
+    d.period_ms = period_ms;
+    d.next_due_ms = 0;
+    d.has_deadline = period_ms > 0;
+    d.pending = true; // First run right after begin()
+    d.stats = {name, 0, 0, 0, 0};
+    d.logged_busy_us = 0;
+    return device_count++;
+}
+
+bool I2CBusManager::begin(UBaseType_t task_priority, BaseType_t core) {
+    if (task) return true;
+    mutex = xSemaphoreCreateMutex();
+    if (!mutex) {
+        Serial.println("Error: I2C bus mutex allocation failed");
+        return false;
+    }
+    last_log_ms = millis();
+    if (xTaskCreatePinnedToCore(taskEntry, "I2CBusTask", 4096, this, task_priority, &task, core) != pdPASS) {
+        Serial.println("Error: failed to start I2C bus task");
+        return false;
+    }
+    Serial.printf("I2C bus manager started (%d devices)\n", device_count);
+    return true;
+}
+
+void I2CBusManager::trigger(int id) {
+    if (id < 0 || id >= device_count) return;
+    devices[id].pending = true;
+    if (task) xTaskNotifyGive(task);
+}
+
+void IRAM_ATTR I2CBusManager::triggerFromISR(int id) {
+    if (id < 0 || id >= device_count) return;
+    devices[id].pending = true;
+    if (task) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+void I2CBusManager::schedule(int id, uint32_t delay_ms) {
+    if (id < 0 || id >= device_count) return;
+    Device &d = devices[id];
+    uint32_t due = millis() + delay_ms;
+    if (!d.has_deadline || (int32_t)(due - d.next_due_ms) < 0) {
+        d.next_due_ms = due;
+        d.has_deadline = true;
+    }
+}
+
+bool I2CBusManager::lock(TickType_t timeout) {
+    return mutex && xSemaphoreTake(mutex, timeout) == pdTRUE;
+}
+
+void I2CBusManager::unlock() {
+    if (mutex) xSemaphoreGive(mutex);
+}
+
+I2CBusManager::DeviceStats I2CBusManager::getStats(int id) const {
+    if (id < 0 || id >= device_count) return DeviceStats{nullptr, 0, 0, 0, 0};
+    return devices[id].stats;
+}
+
+void I2CBusManager::logStats() {
+    uint32_t now = millis();
+    uint32_t window_ms = now - last_log_ms;
+    last_log_ms = now;
+
+    for (int i = 0; i < device_count; i++) {
+        Device &d = devices[i];
+        uint64_t busy = d.stats.busy_us;
+        uint64_t delta = busy - d.logged_busy_us;
+        d.logged_busy_us = busy;
+        float share = window_ms ? (float)delta / (window_ms * 10.0f) : 0.0f; // percent
+        Serial.printf("[I2C] %-9s runs=%u errors=%u busy=%llums (%.2f%%) max=%uus\n",
+                      d.name, (unsigned)d.stats.runs, (unsigned)d.stats.errors,
+                      (unsigned long long)(busy / 1000), share, (unsigned)d.stats.max_us);
+    }
+}
+
+void I2CBusManager::taskEntry(void *arg) {
+    static_cast<I2CBusManager *>(arg)->run();
+}
+
+void I2CBusManager::run() {
+    while (true) {
+        uint32_t now = millis();
+
+        // Pick the most urgent due job
+        int best = -1;
+        for (int i = 0; i < device_count; i++) {
+            Device &d = devices[i];
+            bool due = d.pending || (d.has_deadline && (int32_t)(now - d.next_due_ms) >= 0);
+            if (due && (best < 0 || d.priority < devices[best].priority)) best = i;
+        }
+
+        if (best >= 0) {
+            Device &d = devices[best];
+            d.pending = false;
+            d.has_deadline = d.period_ms > 0;
+            d.next_due_ms = now + d.period_ms;
+
+            xSemaphoreTake(mutex, portMAX_DELAY);
+            int64_t t0 = esp_timer_get_time();
+            bool ok = d.fn(d.ctx);
+            uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+            xSemaphoreGive(mutex);
+
+            d.stats.runs++;
+            if (!ok) d.stats.errors++;
+            d.stats.busy_us += dt;
+            if (dt > d.stats.max_us) d.stats.max_us = dt;
+            continue; // Re-evaluate: something more urgent may have been triggered meanwhile
+        }
+
+        // Sleep until the next deadline or a trigger
+        uint32_t wait_ms = 1000;
+        for (int i = 0; i < device_count; i++) {
+            const Device &d = devices[i];
+            if (!d.has_deadline) continue;
+            int32_t left = (int32_t)(d.next_due_ms - now);
+            if (left < 0) left = 0;
+            if ((uint32_t)left < wait_ms) wait_ms = (uint32_t)left;
+        }
+        TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+        ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1);
+    }
+}
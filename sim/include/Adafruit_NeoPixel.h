@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+/**
+ * @brief Stand-in NeoPixel strip: logs the first pixel's colour when shown.
+ */
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type) : count(n), pending(0), shown(0xFFFFFFFFu) {
+        (void)pin;
+        (void)type;
+    }
+
+    void begin() {}
+    void clear() { pending = 0; }
+    void setBrightness(uint8_t b) { (void)b; }
+    void setPixelColor(uint16_t n, uint32_t c) {
+        if (n == 0) pending = c;
+    }
+    void show();
+    uint16_t numPixels() const { return count; }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+private:
+    uint16_t count;
+    uint32_t pending;
+    uint32_t shown;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+/*
+ * Host stand-in for the ESP32 Arduino core (native build, see sim/README.md).
+ * Like the real core it pulls in FreeRTOS, esp_timer and heap_caps, so code
+ * that relies on those transitive includes compiles unchanged.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+#define digitalPinToInterrupt(p) (p)
+
+typedef uint8_t byte;
+typedef void (*voidFuncPtr)(void);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+uint32_t getCpuFrequencyMhz();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, voidFuncPtr isr, int mode);
+void detachInterrupt(uint8_t pin);
+
+
+/**
+ * @brief Console-backed Serial (stdout).
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// --- Simulator hooks (sim/src/arduino_core.cpp) ---
+
+/**
+ * @brief Raise a GPIO edge as the hardware would (runs the attached ISR).
+ */
+void sim_gpio_set(uint8_t pin, uint8_t level);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <WiFi.h>
+
+#define HTTP_SUCCESS 0
+#define HTTP_ERROR_CONNECTION_FAILED -1
+#define HTTP_ERROR_TIMED_OUT -3
+#define HTTP_ERROR_INVALID_RESPONSE -4
+
+/**
+ * @brief HTTP/1.1 client (ArduinoHttpClient API subset) over WiFiClient.
+ *
+ * One request per connection ("Connection: close"). As in the library,
+ * beginRequest() defers sending so headers can be added until endRequest().
+ */
+class HttpClient {
+public:
+    HttpClient(WiFiClient &client, const char *host, uint16_t port) : client(client), host(host), port(port) {}
+    HttpClient(WiFiClient &client, const String &host, uint16_t port) : HttpClient(client, host.c_str(), port) {}
+
+    void beginRequest() { deferred = true; }
+    int get(const char *path) { return startRequest(path, "GET", nullptr, nullptr); }
+    int get(const String &path) { return get(path.c_str()); }
+    int post(const char *path, const char *content_type, const char *body) {
+        return startRequest(path, "POST", content_type, body);
+    }
+    int post(const String &path, const String &content_type, const String &body) {
+        return post(path.c_str(), content_type.c_str(), body.c_str());
+    }
+    void sendHeader(const char *name, const char *value);
+    void sendHeader(const String &name, const String &value) { sendHeader(name.c_str(), value.c_str()); }
+    int endRequest();
+
+    int responseStatusCode();
+    String responseBody();
+    void stop() { client.stop(); }
+
+private:
+    WiFiClient &client;
+    std::string host;
+    uint16_t port;
+
+    bool deferred = false;
+    std::string request;   // request being built (deferred mode)
+    std::string body;
+    int status = 0;
+    std::string response_body;
+    bool response_read = true;
+
+    int startRequest(const char *path, const char *method, const char *content_type, const char *body);
+    int send();
+    int readResponse();
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+#define BLACK 0x0000
+#define WHITE 0xFFFF
+#define GFX_NOT_DEFINED -1
+
+/**
+ * @brief Stand-in for the QSPI data bus; carries no traffic of its own.
+ */
+class Arduino_DataBus {
+public:
+    virtual ~Arduino_DataBus() {}
+};
+
+class Arduino_ESP32QSPI : public Arduino_DataBus {
+public:
+    Arduino_ESP32QSPI(int8_t cs, int8_t sck, int8_t d0, int8_t d1, int8_t d2, int8_t d3) {
+        (void)cs; (void)sck; (void)d0; (void)d1; (void)d2; (void)d3;
+    }
+};
+
+/**
+ * @brief CO5300 panel backed by an RGB565 framebuffer in host memory.
+ *
+ * Transfers are instantaneous; only pixel counts are recorded. The frame can
+ * be dumped as a PPM at exit (--screenshot).
+ */
+class Arduino_CO5300 {
+public:
+    Arduino_CO5300(Arduino_DataBus *bus, int8_t rst, uint8_t r, int16_t w, int16_t h,
+                   uint8_t col_offset1 = 0, uint8_t row_offset1 = 0,
+                   uint8_t col_offset2 = 0, uint8_t row_offset2 = 0);
+
+    bool begin(int32_t speed = GFX_NOT_DEFINED);
+    void setRotation(uint8_t r) { rotation = r; }
+    void setBrightness(uint8_t brightness);
+    void fillScreen(uint16_t color);
+
+    void startWrite() {}
+    void writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h);
+    void writePixels(uint16_t *data, uint32_t len);
+    void endWrite() {}
+
+    int16_t width() const { return w; }
+    int16_t height() const { return h; }
+
+    // Simulator only: current panel contents, row-major RGB565
+    const uint16_t *framebuffer() const { return fb.data(); }
+
+private:
+    int16_t w, h;
+    uint8_t rotation;
+    std::vector<uint16_t> fb;
+    int16_t win_x, win_y;
+    uint16_t win_w, win_h;
+    uint32_t win_pos;
+};
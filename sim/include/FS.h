@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "Print.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct SimFileData;
+
+/**
+ * @brief Open file on a simulated filesystem (Arduino fs::File subset).
+ * Writes become visible to other opens when the file is closed.
+ */
+class File : public Stream {
+public:
+    File() : pos(0), writable(false) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t *buf, size_t len);
+    bool seek(uint32_t p);
+    size_t position() const { return pos; }
+    size_t size() const;
+    void close();
+    const char *name() const { return path.c_str(); }
+    operator bool() const { return (bool)data; }
+
+private:
+    friend class FS;
+    std::shared_ptr<SimFileData> data;
+    std::string path;
+    std::string buffer; // contents seen by this handle
+    size_t pos;
+    bool writable;
+};
+
+/**
+ * @brief In-memory filesystem (path -> contents, directories tracked by name).
+ */
+class FS {
+public:
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool mkdir(const char *path);
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+
+protected:
+    /**
+     * @brief Copy a host directory tree into the filesystem (at "/").
+     */
+    size_t importHostDir(const char *host_dir);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
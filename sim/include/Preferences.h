@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+/**
+ * @brief NVS stand-in: values live in memory for the lifetime of the process.
+ */
+class Preferences {
+public:
+    bool begin(const char *name, bool readOnly = false) {
+        ns = name ? name : "";
+        (void)readOnly;
+        return true;
+    }
+    void end() {}
+
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0) {
+        auto it = store().find(ns + "/" + key);
+        return it == store().end() ? defaultValue : it->second;
+    }
+    size_t putUChar(const char *key, uint8_t value) {
+        store()[ns + "/" + key] = value;
+        return 1;
+    }
+
+private:
+    std::string ns;
+    static std::map<std::string, uint8_t> &store() {
+        static std::map<std::string, uint8_t> s;
+        return s;
+    }
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "WString.h"
+
+/**
+ * @brief Host stand-in for Arduino Print / Stream (byte sinks and sources).
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len) {
+        size_t n = 0;
+        while (n < len && write(buf[n])) n++;
+        return n;
+    }
+    virtual void flush() {}
+
+    size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int decimals = 2) { return printf("%.*f", decimals, v); }
+
+    size_t println() { return write("\n"); }
+    template <typename T>
+    size_t println(const T &v) { return print(v) + println(); }
+
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char stack_buf[256];
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(stack_buf, sizeof(stack_buf), fmt, ap);
+        va_end(ap);
+        if (n < 0) return 0;
+        if ((size_t)n < sizeof(stack_buf)) return write((const uint8_t *)stack_buf, (size_t)n);
+
+        std::string big((size_t)n + 1, '\0');
+        va_start(ap, fmt);
+        vsnprintf(&big[0], big.size(), fmt, ap);
+        va_end(ap);
+        return write((const uint8_t *)big.data(), (size_t)n);
+    }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(char *buf, size_t len) {
+        size_t n = 0;
+        while (n < len) {
+            int c = read();
+            if (c < 0) break;
+            buf[n++] = (char)c;
+        }
+        return n;
+    }
+    size_t readBytes(uint8_t *buf, size_t len) { return readBytes((char *)buf, len); }
+
+    String readString() {
+        String s;
+        int c;
+        while ((c = read()) >= 0) s += (char)c;
+        return s;
+    }
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "FS.h"
+
+/**
+ * @brief Simulated SD card: an in-memory filesystem preloaded from the
+ * host directory given with --sd. Nothing is written back to the host.
+ */
+class SDMMCFS : public fs::FS {
+public:
+    bool setPins(int clk, int cmd, int d0) {
+        (void)clk;
+        (void)cmd;
+        (void)d0;
+        return true;
+    }
+    bool begin(const char *mountpoint = "/sdcard", bool mode1bit = false, bool format_if_mount_failed = false);
+    void end() {}
+};
+
+extern SDMMCFS SD_MMC;
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <Wire.h>
+
+#define TCA9555_OK 0x00
+#define TCA9555_PIN_ERROR 0x81
+#define TCA9555_I2C_ERROR 0x82
+
+/**
+ * @brief Fake 16-bit I/O expander (RobTillaart TCA9555 API subset).
+ *
+ * Inputs idle high (external pull-ups). sim_ioexp_set_input() drives a pin
+ * and, like the chip, pulls the INT line (IOEXP_INT_PIN) low until the
+ * port is read.
+ */
+class TCA9555 {
+public:
+    explicit TCA9555(uint8_t address, TwoWire *wire = &Wire);
+
+    bool begin();
+    bool isConnected() { return true; }
+
+    bool pinMode1(uint8_t pin, uint8_t mode);
+    bool write1(uint8_t pin, uint8_t value);
+    uint8_t read1(uint8_t pin);
+    bool write16(uint16_t mask);
+    uint16_t read16();
+
+    int lastError();
+
+private:
+    uint8_t address;
+    int error;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+/**
+ * @brief Host stand-in for the Arduino String (the subset this project uses).
+ */
+class String {
+public:
+    String() {}
+    String(const char *s) : str(s ? s : "") {}
+    String(const std::string &s) : str(s) {}
+    String(char c) : str(1, c) {}
+    String(int v) : str(std::to_string(v)) {}
+    String(unsigned int v) : str(std::to_string(v)) {}
+    String(long v) : str(std::to_string(v)) {}
+    String(unsigned long v) : str(std::to_string(v)) {}
+    String(float v, unsigned int decimals = 2) : str(format(v, decimals)) {}
+    String(double v, unsigned int decimals = 2) : str(format(v, decimals)) {}
+
+    const char *c_str() const { return str.c_str(); }
+    unsigned int length() const { return (unsigned int)str.size(); }
+    bool isEmpty() const { return str.empty(); }
+    void reserve(unsigned int n) { str.reserve(n); }
+
+    char charAt(unsigned int i) const { return i < str.size() ? str[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+
+    bool concat(const char *s) { str += s ? s : ""; return true; }
+    bool concat(const char *s, unsigned int n) { str.append(s, n); return true; }
+    bool concat(const String &s) { str += s.str; return true; }
+    bool concat(char c) { str += c; return true; }
+
+    String &operator+=(const String &s) { str += s.str; return *this; }
+    String &operator+=(const char *s) { str += s ? s : ""; return *this; }
+    String &operator+=(char c) { str += c; return *this; }
+
+    bool operator==(const String &o) const { return str == o.str; }
+    bool operator==(const char *s) const { return str == (s ? s : ""); }
+    bool operator!=(const String &o) const { return str != o.str; }
+    bool operator!=(const char *s) const { return !(*this == s); }
+    bool operator<(const String &o) const { return str < o.str; }
+
+    bool equals(const String &o) const { return str == o.str; }
+    bool startsWith(const String &p) const { return str.compare(0, p.str.size(), p.str) == 0; }
+    bool endsWith(const String &s) const {
+        return str.size() >= s.str.size() && str.compare(str.size() - s.str.size(), s.str.size(), s.str) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(str.find(c, from)); }
+    int indexOf(const String &s, unsigned int from = 0) const { return pos(str.find(s.str, from)); }
+    int lastIndexOf(char c) const { return pos(str.rfind(c)); }
+
+    String substring(unsigned int from) const { return from < str.size() ? String(str.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { unsigned int t = from; from = to; to = t; }
+        if (from >= str.size()) return String();
+        return String(str.substr(from, to - from));
+    }
+
+    long toInt() const { return strtol(str.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(str.c_str(), nullptr); }
+    void trim() {
+        size_t b = str.find_first_not_of(" \t\r\n");
+        size_t e = str.find_last_not_of(" \t\r\n");
+        str = (b == std::string::npos) ? std::string() : str.substr(b, e - b + 1);
+    }
+
+    friend String operator+(const String &a, const String &b) { return String(a.str + b.str); }
+    friend String operator+(const String &a, const char *b) { return String(a.str + (b ? b : "")); }
+    friend String operator+(const char *a, const String &b) { return String((a ? a : "") + b.str); }
+    friend String operator+(const String &a, char c) { return String(a.str + c); }
+
+private:
+    std::string str;
+
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    static std::string format(double v, unsigned int decimals) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        return buf;
+    }
+};
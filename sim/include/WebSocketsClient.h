@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <WString.h>
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+/**
+ * @brief RFC 6455 client (links2004 WebSocketsClient API subset) over a host socket.
+ *
+ * Like the library, everything happens inside loop(): (re)connecting,
+ * reading frames and dispatching events. Fragmented messages are delivered
+ * whole; TEXT payloads are NUL-terminated.
+ */
+class WebSocketsClient {
+public:
+    typedef std::function<void(WStype_t type, uint8_t *payload, size_t length)> WebSocketClientEvent;
+
+    WebSocketsClient();
+    ~WebSocketsClient();
+
+    void begin(const char *host, uint16_t port, const char *url = "/", const char *protocol = "arduino");
+    void begin(const String &host, uint16_t port, const String &url = "/", const String &protocol = "arduino") {
+        begin(host.c_str(), port, url.c_str(), protocol.c_str());
+    }
+    void onEvent(WebSocketClientEvent cb) { event_cb = cb; }
+    void setReconnectInterval(unsigned long ms) { reconnect_ms = ms; }
+    void loop();
+
+    bool sendTXT(const uint8_t *payload, size_t length) { return sendFrame(0x1, payload, length); }
+    bool sendTXT(const char *payload, size_t length = 0) {
+        return sendTXT((const uint8_t *)payload, length ? length : strlen(payload));
+    }
+    bool sendTXT(const String &payload) { return sendTXT(payload.c_str(), payload.length()); }
+    bool sendBIN(const uint8_t *payload, size_t length) { return sendFrame(0x2, payload, length); }
+    bool sendPing() { return sendFrame(0x9, nullptr, 0); }
+
+    bool isConnected() const { return connected; }
+    void disconnect();
+
+private:
+    std::string host;
+    uint16_t port;
+    std::string url;
+    std::string protocol;
+    bool configured;
+    WebSocketClientEvent event_cb;
+    unsigned long reconnect_ms;
+    unsigned long last_attempt_ms;
+    bool attempted;
+
+    int fd;
+    bool connected;
+    std::vector<uint8_t> rx;       // unparsed bytes from the socket
+    std::vector<uint8_t> message;  // fragments of the message being assembled
+    uint8_t message_opcode;
+    uint32_t mask_seed;
+
+    bool connectNow();
+    bool sendFrame(uint8_t opcode, const uint8_t *payload, size_t length);
+    void parseFrames();
+    void closeSocket(bool notify);
+    void emit(WStype_t type, uint8_t *payload, size_t length);
+};
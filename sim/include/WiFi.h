@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include "Print.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(buf);
+    }
+
+private:
+    uint8_t octets[4];
+};
+
+/**
+ * @brief Simulated station: any SSID "connects" at once; traffic uses the host network.
+ */
+class WiFiClass {
+public:
+    wl_status_t begin(const char *ssid, const char *pass = nullptr);
+    wl_status_t status() const { return state; }
+    bool disconnect(bool wifi_off = false) {
+        (void)wifi_off;
+        state = WL_DISCONNECTED;
+        return true;
+    }
+    IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+    int8_t RSSI() const { return -40; }
+    /**
+     * @brief Station MAC (--mac, or 02:00:<pid> so parallel instances differ).
+     */
+    uint8_t *macAddress(uint8_t *mac);
+
+private:
+    wl_status_t state = WL_IDLE_STATUS;
+};
+
+extern WiFiClass WiFi;
+
+/**
+ * @brief Blocking TCP client over a host socket (Arduino Client subset).
+ */
+class WiFiClient : public Stream {
+public:
+    WiFiClient() : fd(-1), peeked(-1) {}
+    ~WiFiClient() { stop(); }
+
+    int connect(const char *host, uint16_t port);
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t len);
+    int peek() override;
+    uint8_t connected();
+    void stop();
+    operator bool() { return connected(); }
+
+private:
+    int fd;
+    int peeked;
+
+    WiFiClient(const WiFiClient &) = delete;
+    WiFiClient &operator=(const WiFiClient &) = delete;
+};
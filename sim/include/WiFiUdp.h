@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "Print.h"
+
+/**
+ * @brief UDP socket over the host network (arduino-esp32 WiFiUDP subset).
+ *
+ * Like the library: beginPacket()/write()/endPacket() assemble and send one
+ * datagram; parsePacket() never blocks and makes the next datagram available
+ * to read().
+ */
+class WiFiUDP : public Print {
+public:
+    WiFiUDP() : fd(-1), rx_pos(0) {}
+    ~WiFiUDP() { stop(); }
+
+    /**
+     * @brief Open the socket on local @p port (0 = any).
+     * @return 1 on success
+     */
+    uint8_t begin(uint16_t port);
+    void stop();
+
+    int beginPacket(const char *host, uint16_t port);
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+    int endPacket();
+
+    /**
+     * @brief Receive the next datagram, if any.
+     * @return Its size, or 0
+     */
+    int parsePacket();
+    int available() const { return (int)(rx.size() - rx_pos); }
+    int read(uint8_t *buf, size_t len);
+
+private:
+    int fd;
+    std::vector<uint8_t> tx;
+    std::vector<uint8_t> tx_addr; // sockaddr of the packet being assembled
+    std::vector<uint8_t> rx;
+    size_t rx_pos;
+
+    WiFiUDP(const WiFiUDP &) = delete;
+    WiFiUDP &operator=(const WiFiUDP &) = delete;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Host stand-in for the Arduino I2C master. Transactions are served by
+ * simulated register maps (fuel gauge, charger); other addresses NACK.
+ */
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    void setClock(uint32_t frequency) { (void)frequency; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t len);
+    /**
+     * @return 0 on success, 2 on address NACK (as the ESP32 core)
+     */
+    uint8_t endTransmission(bool send_stop = true);
+
+    uint8_t requestFrom(uint8_t address, uint8_t len, bool send_stop = true);
+    int available();
+    int read();
+
+private:
+    uint8_t address = 0;
+    uint8_t reg = 0;
+    bool have_reg = false;
+    uint8_t rx[32];
+    uint8_t rx_len = 0;
+    uint8_t rx_pos = 0;
+};
+
+extern TwoWire Wire;
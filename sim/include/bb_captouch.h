@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define CT_SUCCESS 0
+#define CT_ERROR -1
+
+typedef struct _fttouchinfo {
+    int count;
+    uint16_t x[5], y[5];
+    uint8_t pressure[5], area[5];
+} TOUCHINFO;
+
+/**
+ * @brief Touch controller stand-in: always initializes, never reports a touch.
+ */
+class BBCapTouch {
+public:
+    int init(int iSDA, int iSCL, int iRST = -1, int iINT = -1, uint32_t u32Speed = 400000) {
+        (void)iSDA; (void)iSCL; (void)iRST; (void)iINT; (void)u32Speed;
+        return CT_SUCCESS;
+    }
+    int getSamples(TOUCHINFO *pTI) {
+        if (pTI) pTI->count = 0;
+        return 0;
+    }
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+/*
+ * Host stand-in for the ESP-IDF 5 standard-mode I2S channel driver
+ * (driver/i2s_std.h). An RX channel reads the simulator's microphone WAV
+ * (or silence), a TX channel collects the speaker output; each channel has
+ * its own sample clock and blocks so that it advances at exactly the
+ * configured rate, like the DMA-paced hardware. Event callbacks run on the
+ * calling thread, once per completed DMA buffer.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1, I2S_NUM_AUTO = 2 } i2s_port_t;
+typedef enum { I2S_ROLE_MASTER = 0, I2S_ROLE_SLAVE = 1 } i2s_role_t;
+
+typedef enum {
+    I2S_DATA_BIT_WIDTH_8BIT = 8,
+    I2S_DATA_BIT_WIDTH_16BIT = 16,
+    I2S_DATA_BIT_WIDTH_24BIT = 24,
+    I2S_DATA_BIT_WIDTH_32BIT = 32,
+} i2s_data_bit_width_t;
+
+typedef enum { I2S_SLOT_BIT_WIDTH_AUTO = 0 } i2s_slot_bit_width_t;
+typedef enum { I2S_SLOT_MODE_MONO = 1, I2S_SLOT_MODE_STEREO = 2 } i2s_slot_mode_t;
+typedef enum { I2S_STD_SLOT_LEFT = 1, I2S_STD_SLOT_RIGHT = 2, I2S_STD_SLOT_BOTH = 3 } i2s_std_slot_mask_t;
+typedef enum { I2S_CLK_SRC_DEFAULT = 0 } i2s_clock_src_t;
+typedef enum { I2S_MCLK_MULTIPLE_256 = 256 } i2s_mclk_multiple_t;
+
+typedef int gpio_num_t;
+#define GPIO_NUM_NC (-1)
+#define I2S_GPIO_UNUSED GPIO_NUM_NC
+
+typedef struct i2s_channel_obj_t *i2s_chan_handle_t;
+
+typedef struct {
+    i2s_port_t id;
+    i2s_role_t role;
+    uint32_t dma_desc_num;  // DMA buffers in the ring
+    uint32_t dma_frame_num; // frames (samples per slot) per DMA buffer
+    bool auto_clear;        // TX: send zeros when the application falls behind
+    int intr_priority;
+} i2s_chan_config_t;
+
+#define I2S_CHANNEL_DEFAULT_CONFIG(i2s_num, i2s_role)                                                      \
+    { i2s_num, i2s_role, 6, 240, false, 0 }
+
+typedef struct {
+    uint32_t sample_rate_hz;
+    i2s_clock_src_t clk_src;
+    i2s_mclk_multiple_t mclk_multiple;
+} i2s_std_clk_config_t;
+
+typedef struct {
+    i2s_data_bit_width_t data_bit_width;
+    i2s_slot_bit_width_t slot_bit_width;
+    i2s_slot_mode_t slot_mode;
+    i2s_std_slot_mask_t slot_mask;
+    uint32_t ws_width;
+    bool ws_pol;
+    bool bit_shift;
+    bool msb_right;
+} i2s_std_slot_config_t;
+
+typedef struct {
+    gpio_num_t mclk;
+    gpio_num_t bclk;
+    gpio_num_t ws;
+    gpio_num_t dout;
+    gpio_num_t din;
+    struct {
+        uint32_t mclk_inv : 1;
+        uint32_t bclk_inv : 1;
+        uint32_t ws_inv : 1;
+    } invert_flags;
+} i2s_std_gpio_config_t;
+
+typedef struct {
+    i2s_std_clk_config_t clk_cfg;
+    i2s_std_slot_config_t slot_cfg;
+    i2s_std_gpio_config_t gpio_cfg;
+} i2s_std_config_t;
+
+#define I2S_STD_CLK_DEFAULT_CONFIG(rate) { (uint32_t)(rate), I2S_CLK_SRC_DEFAULT, I2S_MCLK_MULTIPLE_256 }
+#define I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(bits, mode)                                                      \
+    { bits, I2S_SLOT_BIT_WIDTH_AUTO, mode, (mode) == I2S_SLOT_MODE_MONO ? I2S_STD_SLOT_LEFT : I2S_STD_SLOT_BOTH, \
+      (uint32_t)(bits), false, true, false }
+
+typedef struct {
+    void *data;  // the DMA buffer just completed
+    size_t size; // its length in bytes
+} i2s_event_data_t;
+
+typedef bool (*i2s_isr_callback_t)(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx);
+
+typedef struct {
+    i2s_isr_callback_t on_recv;       // RX DMA buffer filled
+    i2s_isr_callback_t on_recv_q_ovf; // RX: oldest buffer overwritten, nobody read it
+    i2s_isr_callback_t on_sent;       // TX DMA buffer played
+    i2s_isr_callback_t on_send_q_ovf; // TX: ran dry, played stale data or zeros
+} i2s_event_callbacks_t;
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *chan_cfg, i2s_chan_handle_t *ret_tx_handle,
+                          i2s_chan_handle_t *ret_rx_handle);
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t *std_cfg);
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t handle, const i2s_event_callbacks_t *callbacks,
+                                              void *user_data);
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_preload_data(i2s_chan_handle_t tx_handle, const void *src, size_t size, size_t *bytes_loaded);
+esp_err_t i2s_channel_read(i2s_chan_handle_t handle, void *dest, size_t size, size_t *bytes_read,
+                           uint32_t timeout_ms);
+esp_err_t i2s_channel_write(i2s_chan_handle_t handle, const void *src, size_t size, size_t *bytes_written,
+                            uint32_t timeout_ms);
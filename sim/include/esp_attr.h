@@ -0,0 +1,7 @@
+#pragma once
+
+// Placement attributes are meaningless on the host
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_ATTR
+#define RTC_DATA_ATTR
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Microseconds since the simulator started (monotonic).
+ */
+int64_t esp_timer_get_time(void);
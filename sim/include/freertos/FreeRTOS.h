@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+ * Host stand-in for the FreeRTOS subset this project uses. Tasks are host
+ * threads (priority and core are recorded but not enforced), one tick is
+ * one millisecond.
+ */
+
+#include <stdint.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE ((BaseType_t)1)
+#define pdFALSE ((BaseType_t)0)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTICKS_TO_MS(t) ((uint32_t)(t))
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+// No real interrupts: "yield from ISR" is a no-op
+#define portYIELD_FROM_ISR(x) ((void)(x))
+#define portENTER_CRITICAL(m) ((void)(m))
+#define portEXIT_CRITICAL(m) ((void)(m))
+#define portMUX_INITIALIZER_UNLOCKED 0
+typedef int portMUX_TYPE;
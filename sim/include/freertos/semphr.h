@@ -0,0 +1,14 @@
+#pragma once
+
+#include "freertos/queue.h"
+
+// As in FreeRTOS, semaphores are queues of zero-size items
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+
+#define vSemaphoreDelete(s) vQueueDelete(s)
+#define xSemaphoreTake(s, ticks) xQueueReceive((s), nullptr, (ticks))
+#define xSemaphoreGive(s) xQueueSend((s), nullptr, 0)
+#define xSemaphoreGiveFromISR(s, woken) xQueueSendFromISR((s), nullptr, (woken))
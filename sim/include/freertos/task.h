@@ -0,0 +1,24 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+struct SimTask;
+typedef SimTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle);
+
+/**
+ * @brief Only self-deletion (NULL) ends a thread; other handles are detached.
+ */
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_woken);
@@ -0,0 +1,245 @@
+#include <Arduino.h>
+#include <kodedot/pin_config.h>
+#include "sim_runtime.h"
+
+#include <signal.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+HardwareSerial Serial;
+
+static const auto start_time = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)esp_timer_get_time();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+// The S3's default clock; only used to put cycle counts in proportion
+uint32_t getCpuFrequencyMhz() {
+    return 240;
+}
+
+// --- Serial (stdout) ---
+
+static std::mutex serial_lock;
+
+size_t HardwareSerial::write(uint8_t c) {
+    std::lock_guard<std::mutex> lk(serial_lock);
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len) {
+    std::lock_guard<std::mutex> lk(serial_lock);
+    return fwrite(buf, 1, len, stdout);
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+// --- GPIO and interrupts ---
+
+static const int GPIO_COUNT = 64;
+static std::atomic<uint8_t> gpio_level[GPIO_COUNT];
+static voidFuncPtr gpio_isr[GPIO_COUNT];
+static int gpio_isr_mode[GPIO_COUNT];
+static std::mutex gpio_lock;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    // Pull-ups idle high, like the real pads
+    if (pin < GPIO_COUNT && (mode == INPUT_PULLUP || mode == INPUT)) gpio_level[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    sim_gpio_set(pin, val);
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < GPIO_COUNT ? gpio_level[pin].load() : LOW;
+}
+
+void attachInterrupt(uint8_t pin, voidFuncPtr isr, int mode) {
+    if (pin >= GPIO_COUNT) return;
+    std::lock_guard<std::mutex> lk(gpio_lock);
+    gpio_isr[pin] = isr;
+    gpio_isr_mode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= GPIO_COUNT) return;
+    std::lock_guard<std::mutex> lk(gpio_lock);
+    gpio_isr[pin] = nullptr;
+}
+
+void sim_gpio_set(uint8_t pin, uint8_t level) {
+    if (pin >= GPIO_COUNT) return;
+    uint8_t old = gpio_level[pin].exchange(level ? HIGH : LOW);
+    if (old == level) return;
+
+    voidFuncPtr isr;
+    int mode;
+    {
+        std::lock_guard<std::mutex> lk(gpio_lock);
+        isr = gpio_isr[pin];
+        mode = gpio_isr_mode[pin];
+    }
+    bool fire = mode == CHANGE || (mode == FALLING && !level) || (mode == RISING && level);
+    // The "ISR" runs on the thread that drove the pin
+    if (isr && fire) isr();
+}
+
+// --- Options, exit hooks and entry point ---
+
+static SimOptions options = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+static std::vector<void (*)(void)> exit_hooks;
+static std::mutex exit_lock;
+
+const SimOptions &sim_options() {
+    return options;
+}
+
+void sim_at_exit(void (*fn)(void)) {
+    std::lock_guard<std::mutex> lk(exit_lock);
+    exit_hooks.push_back(fn);
+}
+
+void sim_exit(int code) {
+    static std::atomic<bool> exiting(false);
+    if (exiting.exchange(true)) {
+        for (;;) pause(); // another thread is already shutting down
+    }
+    fflush(stdout);
+    for (auto fn : exit_hooks) fn();
+    fflush(stdout);
+    _exit(code);
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    // Leave the handler and shut down from a normal thread
+    std::thread([] { sim_exit(0); }).detach();
+}
+
+// Scripted PTT: "start_ms+hold_ms,start_ms+hold_ms,..." (times since boot)
+static void ptt_script_thread(std::string script) {
+    size_t pos = 0;
+    while (pos < script.size()) {
+        size_t end = script.find(',', pos);
+        std::string item = script.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        pos = (end == std::string::npos) ? script.size() : end + 1;
+
+        unsigned long start_ms = 0, hold_ms = 0;
+        if (sscanf(item.c_str(), "%lu+%lu", &start_ms, &hold_ms) != 2) {
+            fprintf(stderr, "[SIM] bad --ptt item '%s' (want start_ms+hold_ms)\n", item.c_str());
+            continue;
+        }
+        while (millis() < start_ms) delay(1);
+        sim_ioexp_set_input(EXPANDER_BUTTON_BOTTOM, true);
+        delay(hold_ms);
+        sim_ioexp_set_input(EXPANDER_BUTTON_BOTTOM, false);
+    }
+}
+
+// Interactive control: p = toggle PTT, t/l/b/r = tap a D-pad key, q = quit
+static void console_thread() {
+    bool ptt = false;
+    int c;
+    while ((c = getchar()) != EOF) {
+        switch (c) {
+        case 'p':
+            ptt = !ptt;
+            sim_ioexp_set_input(EXPANDER_BUTTON_BOTTOM, ptt);
+            break;
+        case 't': case 'l': case 'b': case 'r': {
+            uint8_t pin = c == 't' ? EXPANDER_PAD_TOP : c == 'l' ? EXPANDER_PAD_LEFT
+                        : c == 'b' ? EXPANDER_PAD_BOTTOM : EXPANDER_PAD_RIGHT;
+            sim_ioexp_set_input(pin, true);
+            delay(80);
+            sim_ioexp_set_input(pin, false);
+            break;
+        }
+        case 'q':
+            sim_exit(0);
+        default:
+            break;
+        }
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--sd DIR] [--mic IN.wav] [--speaker OUT.wav] [--echo DB] [--ptt START+HOLD,...]\n"
+            "          [--duration SECONDS] [--mac AABBCCDDEEFF] [--screenshot OUT.ppm]\n"
+            "console: p = toggle PTT, t/l/b/r = tap D-pad, q = quit\n",
+            prog);
+}
+
+void setup();
+void loop();
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!val) {
+            usage(argv[0]);
+            return 2;
+        }
+        if (arg == "--sd") options.sd_dir = val;
+        else if (arg == "--mic") options.mic_wav = val;
+        else if (arg == "--speaker") options.speaker_wav = val;
+        else if (arg == "--echo") options.echo_db = val;
+        else if (arg == "--ptt") options.ptt_script = val;
+        else if (arg == "--duration") options.duration_s = (uint32_t)atoi(val);
+        else if (arg == "--mac") options.mac = val;
+        else if (arg == "--screenshot") options.screenshot = val;
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN); // a dropped socket is reported by send(), not a signal
+    sim_at_exit(sim_i2s_print_stats);
+    sim_at_exit(sim_display_print_stats);
+
+    if (options.ptt_script) std::thread(ptt_script_thread, std::string(options.ptt_script)).detach();
+    std::thread(console_thread).detach();
+    if (options.duration_s) {
+        std::thread([] {
+            delay(options.duration_s * 1000);
+            sim_exit(0);
+        }).detach();
+    }
+
+    setup();
+    for (;;) loop();
+}
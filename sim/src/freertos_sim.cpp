@@ -0,0 +1,204 @@
+#include <Arduino.h>
+
+#include <pthread.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Per-thread task record: name (for logs) and the direct-to-task notification
+ * counter used by ulTaskNotifyTake / xTaskNotifyGive.
+ */
+struct SimTask {
+    std::string name;
+    UBaseType_t priority;
+    BaseType_t core;
+    std::mutex lock;
+    std::condition_variable cv;
+    uint32_t notify;
+};
+
+struct SimQueue {
+    size_t length;
+    size_t item_size;
+    std::deque<std::vector<uint8_t>> items;
+    std::mutex lock;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+};
+
+static thread_local SimTask *current_task = nullptr;
+
+struct TaskStart {
+    SimTask *task;
+    TaskFunction_t fn;
+    void *arg;
+};
+
+static SimTask *self_task() {
+    // setup()/loop() and foreign threads get a record on first use
+    if (!current_task) {
+        current_task = new SimTask();
+        current_task->name = "main";
+        current_task->priority = 1;
+        current_task->core = 1;
+        current_task->notify = 0;
+    }
+    return current_task;
+}
+
+static std::chrono::steady_clock::time_point deadline(TickType_t ticks) {
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(ticks);
+}
+
+static void *task_entry(void *p) {
+    TaskStart start = *(TaskStart *)p;
+    delete (TaskStart *)p;
+    current_task = start.task;
+    pthread_setname_np(pthread_self(), start.task->name.substr(0, 15).c_str());
+    start.fn(start.arg);
+    return nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+    SimTask *task = new SimTask();
+    task->name = name ? name : "task";
+    task->priority = priority;
+    task->core = core;
+    task->notify = 0;
+    if (handle) *handle = task;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    // Host code paths use more stack than the firmware; never go below 256 KB
+    size_t stack = stack_bytes < 256 * 1024 ? 256 * 1024 : stack_bytes;
+    pthread_attr_setstacksize(&attr, stack);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    pthread_t thread;
+    int err = pthread_create(&thread, &attr, task_entry, new TaskStart{task, fn, arg});
+    pthread_attr_destroy(&attr);
+    return err == 0 ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_bytes, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+    return xTaskCreatePinnedToCore(fn, name, stack_bytes, arg, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == current_task) pthread_exit(nullptr);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return self_task();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    SimTask *t = self_task();
+    std::unique_lock<std::mutex> lk(t->lock);
+    if (ticks == portMAX_DELAY) {
+        t->cv.wait(lk, [t] { return t->notify > 0; });
+    } else {
+        t->cv.wait_until(lk, deadline(ticks), [t] { return t->notify > 0; });
+    }
+    uint32_t value = t->notify;
+    if (value > 0) t->notify = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (!task) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lk(task->lock);
+        task->notify++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_woken) {
+    xTaskNotifyGive(task);
+    if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+}
+
+// --- Queues and semaphores ---
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    if (length == 0) return nullptr;
+    SimQueue *q = new SimQueue();
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+    if (!q) return pdFAIL;
+    std::unique_lock<std::mutex> lk(q->lock);
+    auto has_room = [q] { return q->items.size() < q->length; };
+    if (ticks == portMAX_DELAY) {
+        q->not_full.wait(lk, has_room);
+    } else if (!q->not_full.wait_until(lk, deadline(ticks), has_room)) {
+        return pdFAIL;
+    }
+    const uint8_t *src = (const uint8_t *)item;
+    q->items.emplace_back(src && q->item_size ? std::vector<uint8_t>(src, src + q->item_size) : std::vector<uint8_t>());
+    lk.unlock();
+    q->not_empty.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *item, BaseType_t *higher_priority_woken) {
+    if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+    return xQueueSend(q, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+    if (!q) return pdFAIL;
+    std::unique_lock<std::mutex> lk(q->lock);
+    auto has_item = [q] { return !q->items.empty(); };
+    if (ticks == portMAX_DELAY) {
+        q->not_empty.wait(lk, has_item);
+    } else if (!q->not_empty.wait_until(lk, deadline(ticks), has_item)) {
+        return pdFAIL;
+    }
+    if (item && q->item_size) memcpy(item, q->items.front().data(), q->item_size);
+    q->items.pop_front();
+    lk.unlock();
+    q->not_full.notify_one();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    if (!q) return 0;
+    std::lock_guard<std::mutex> lk(q->lock);
+    return (UBaseType_t)q->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    // A mutex starts available: one token in the queue
+    SemaphoreHandle_t s = xQueueCreate(1, 0);
+    if (s) xQueueSend(s, nullptr, 0);
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xQueueCreate(1, 0);
+}
@@ -0,0 +1,77 @@
+#include <Arduino_GFX_Library.h>
+#include "sim_runtime.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+
+static Arduino_CO5300 *panel = nullptr;
+static std::atomic<uint64_t> pixels_written{0};
+static std::atomic<uint32_t> windows{0};
+static std::atomic<uint8_t> last_brightness{0};
+
+Arduino_CO5300::Arduino_CO5300(Arduino_DataBus *bus, int8_t rst, uint8_t r, int16_t w_, int16_t h_,
+                               uint8_t, uint8_t, uint8_t, uint8_t)
+    : w(w_), h(h_), rotation(r), fb((size_t)w_ * h_, BLACK), win_x(0), win_y(0), win_w(0), win_h(0), win_pos(0) {
+    (void)bus;
+    (void)rst;
+    panel = this;
+}
+
+bool Arduino_CO5300::begin(int32_t) {
+    Serial.printf("[SIM] Panel %dx%d (framebuffer in host memory)\n", w, h);
+    return true;
+}
+
+void Arduino_CO5300::setBrightness(uint8_t brightness) {
+    last_brightness = brightness;
+}
+
+void Arduino_CO5300::fillScreen(uint16_t color) {
+    std::fill(fb.begin(), fb.end(), color);
+}
+
+void Arduino_CO5300::writeAddrWindow(int16_t x, int16_t y, uint16_t ww, uint16_t hh) {
+    win_x = x;
+    win_y = y;
+    win_w = ww;
+    win_h = hh;
+    win_pos = 0;
+    windows++;
+}
+
+void Arduino_CO5300::writePixels(uint16_t *data, uint32_t len) {
+    if (win_w == 0) return;
+    for (uint32_t i = 0; i < len; i++, win_pos++) {
+        int32_t px = win_x + (int32_t)(win_pos % win_w);
+        int32_t py = win_y + (int32_t)(win_pos / win_w);
+        if (px >= 0 && px < w && py >= 0 && py < h) fb[(size_t)py * w + px] = data[i];
+    }
+    pixels_written += len;
+}
+
+static void write_screenshot() {
+    const char *path = sim_options().screenshot;
+    if (!path || !panel) return;
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "[SIM] cannot write %s\n", path);
+        return;
+    }
+    int16_t w = panel->width(), h = panel->height();
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    const uint16_t *fb = panel->framebuffer();
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        uint16_t c = fb[i];
+        uint8_t rgb[3] = {(uint8_t)((c >> 8) & 0xF8), (uint8_t)((c >> 3) & 0xFC), (uint8_t)((c << 3) & 0xF8)};
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    printf("[SIM] Screenshot written to %s\n", path);
+}
+
+void sim_display_print_stats() {
+    printf("[SIM] display: %u windows, %llu pixels, brightness %u\n", (unsigned)windows.load(),
+           (unsigned long long)pixels_written.load(), (unsigned)last_brightness.load());
+    write_screenshot();
+}
@@ -0,0 +1,110 @@
+#include <Arduino.h>
+#include <ArduinoHttpClient.h>
+
+#include <ctype.h>
+#include <strings.h>
+
+int HttpClient::startRequest(const char *path, const char *method, const char *content_type, const char *req_body) {
+    request = std::string(method) + " " + path + " HTTP/1.1\r\n";
+    request += "Host: " + host + "\r\n";
+    request += "User-Agent: Arduino/2.2.0\r\n";
+    request += "Connection: close\r\n";
+    body.clear();
+    if (content_type) request += std::string("Content-Type: ") + content_type + "\r\n";
+    if (req_body) body = req_body;
+    if (req_body || strcmp(method, "POST") == 0) request += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+
+    if (deferred) return HTTP_SUCCESS;
+    return send();
+}
+
+void HttpClient::sendHeader(const char *name, const char *value) {
+    request += std::string(name) + ": " + value + "\r\n";
+}
+
+int HttpClient::endRequest() {
+    deferred = false;
+    return send();
+}
+
+int HttpClient::send() {
+    status = 0;
+    response_body.clear();
+    response_read = false;
+
+    if (!client.connect(host.c_str(), port)) {
+        status = HTTP_ERROR_CONNECTION_FAILED;
+        response_read = true;
+        return status;
+    }
+    std::string wire = request + "\r\n" + body;
+    if (client.write((const uint8_t *)wire.data(), wire.size()) != wire.size()) {
+        status = HTTP_ERROR_CONNECTION_FAILED;
+        response_read = true;
+        client.stop();
+        return status;
+    }
+    return HTTP_SUCCESS;
+}
+
+// Read the whole response (the server closes the connection after it)
+int HttpClient::readResponse() {
+    if (response_read) return status;
+    response_read = true;
+
+    std::string raw;
+    uint8_t chunk[2048];
+    for (;;) {
+        int n = client.read(chunk, sizeof(chunk));
+        if (n > 0) {
+            raw.append((const char *)chunk, (size_t)n);
+            // Stop early once Content-Length bytes are in
+            size_t hdr_end = raw.find("\r\n\r\n");
+            if (hdr_end != std::string::npos) {
+                const char *cl = strcasestr(raw.c_str(), "\r\nContent-Length:");
+                if (cl && (size_t)(cl - raw.c_str()) < hdr_end) {
+                    size_t want = strtoul(cl + 17, nullptr, 10);
+                    if (raw.size() >= hdr_end + 4 + want) break;
+                }
+            }
+            continue;
+        }
+        break; // closed, error or receive timeout
+    }
+    client.stop();
+
+    size_t hdr_end = raw.find("\r\n\r\n");
+    if (raw.compare(0, 5, "HTTP/") != 0 || hdr_end == std::string::npos) {
+        status = raw.empty() ? HTTP_ERROR_TIMED_OUT : HTTP_ERROR_INVALID_RESPONSE;
+        return status;
+    }
+    status = atoi(raw.c_str() + raw.find(' ') + 1);
+
+    std::string headers = raw.substr(0, hdr_end);
+    std::string payload = raw.substr(hdr_end + 4);
+    if (strcasestr(headers.c_str(), "Transfer-Encoding: chunked")) {
+        // De-chunk
+        std::string out;
+        size_t pos = 0;
+        while (pos < payload.size()) {
+            size_t line_end = payload.find("\r\n", pos);
+            if (line_end == std::string::npos) break;
+            size_t len = strtoul(payload.c_str() + pos, nullptr, 16);
+            if (len == 0) break;
+            out += payload.substr(line_end + 2, len);
+            pos = line_end + 2 + len + 2;
+        }
+        payload = out;
+    }
+    response_body = payload;
+    return status;
+}
+
+int HttpClient::responseStatusCode() {
+    return readResponse();
+}
+
+String HttpClient::responseBody() {
+    readResponse();
+    return String(response_body);
+}
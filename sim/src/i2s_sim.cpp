@@ -0,0 +1,286 @@
+#include <Arduino.h>
+#include "driver/i2s_std.h"
+#include "sim_runtime.h"
+#include "../../tools/common/wav.h"
+
+#include <chrono>
+#include <math.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * One direction's sample clock: starts on the first transfer and keeps a
+ * running sample count. Each transfer waits until the clock has caught up
+ * with the samples it moves. A caller that falls behind by more than the
+ * channel's DMA ring loses that time (counted), as on the hardware.
+ */
+struct I2sClock {
+    bool started = false;
+    std::chrono::steady_clock::time_point origin;
+    uint64_t samples = 0;
+    uint32_t overruns = 0;
+
+    // @return true if the DMA ring ran over since the last transfer
+    bool pace(size_t count, uint32_t rate, uint32_t slack_us) {
+        bool overrun = false;
+        auto now = std::chrono::steady_clock::now();
+        if (!started) {
+            started = true;
+            origin = now;
+        }
+        auto due = origin + std::chrono::microseconds(samples * 1000000ull / rate);
+        if (now - due > std::chrono::microseconds(slack_us)) {
+            // DMA ran dry / overflowed while nobody serviced it
+            overruns++;
+            overrun = true;
+            origin += std::chrono::duration_cast<std::chrono::steady_clock::duration>(now - due);
+        }
+        samples += count;
+        std::this_thread::sleep_until(origin + std::chrono::microseconds(samples * 1000000ull / rate));
+        return overrun;
+    }
+};
+
+struct i2s_channel_obj_t {
+    bool tx = false;
+    bool initialized = false;
+    bool enabled = false;
+    i2s_chan_config_t config = {};
+    uint32_t sample_rate = 16000;
+    size_t sample_bytes = sizeof(int16_t);
+    i2s_event_callbacks_t callbacks = {};
+    void *user_data = nullptr;
+    I2sClock clock;
+    size_t frame_pos = 0; // samples into the current DMA buffer
+
+    uint32_t slackUs() const {
+        return (uint32_t)((uint64_t)config.dma_desc_num * config.dma_frame_num * 1000000ull / sample_rate);
+    }
+
+    // Account a transfer: overflow and per-buffer completion events
+    void transferred(void *buf, size_t count) {
+        i2s_event_data_t ev = {buf, config.dma_frame_num * sample_bytes};
+        if (clock.pace(count, sample_rate, slackUs())) {
+            i2s_isr_callback_t ovf = tx ? callbacks.on_send_q_ovf : callbacks.on_recv_q_ovf;
+            if (ovf) ovf(this, &ev, user_data);
+        }
+        i2s_isr_callback_t done = tx ? callbacks.on_sent : callbacks.on_recv;
+        for (frame_pos += count; config.dma_frame_num && frame_pos >= config.dma_frame_num;
+             frame_pos -= config.dma_frame_num) {
+            if (done) done(this, &ev, user_data);
+        }
+    }
+};
+
+static uint32_t speaker_rate = 16000;
+static i2s_chan_handle_t rx_chan = nullptr;
+static i2s_chan_handle_t tx_chan = nullptr;
+
+static std::vector<int16_t> mic_samples;
+static size_t mic_pos = 0;
+static bool mic_loaded = false;
+
+static std::vector<int16_t> speaker_samples;
+static std::mutex speaker_lock;
+static uint64_t speaker_nonzero = 0;
+
+/*
+ * Acoustic echo (--echo DB): the speaker reaches the microphone 1 ms after
+ * it plays, with a reflection 4 ms later and 12 dB weaker. A written
+ * sample plays once the rest of the TX DMA ring has, as on the hardware.
+ */
+static const size_t ECHO_HISTORY = 16384;
+static const uint32_t ECHO_DIRECT_US = 1000;
+static const uint32_t ECHO_REFLECTION_US = 5000;
+static std::vector<int16_t> echo_history(ECHO_HISTORY); // speaker ring (speaker_lock)
+static uint64_t echo_written = 0;
+static std::chrono::steady_clock::time_point echo_origin; // when speaker sample 0 plays
+static uint32_t echo_ring_samples = 0;
+
+// Speaker output heard by the microphone at @p t
+static float echo_at(std::chrono::steady_clock::time_point t, uint32_t rate, float gain) {
+    std::lock_guard<std::mutex> lk(speaker_lock);
+    if (!echo_written) return 0.0f;
+    int64_t since_us = std::chrono::duration_cast<std::chrono::microseconds>(t - echo_origin).count();
+    float sum = 0.0f;
+    const uint32_t delays[2] = {ECHO_DIRECT_US, ECHO_REFLECTION_US};
+    const float gains[2] = {gain, gain / 4};
+    for (int p = 0; p < 2; p++) {
+        int64_t j = (since_us - delays[p]) * rate / 1000000 - echo_ring_samples;
+        if (j < 0 || (uint64_t)j >= echo_written || echo_written - (uint64_t)j > ECHO_HISTORY) continue;
+        sum += gains[p] * echo_history[(size_t)j % ECHO_HISTORY];
+    }
+    return sum;
+}
+
+static void load_mic(uint32_t sample_rate) {
+    mic_loaded = true;
+    const char *path = sim_options().mic_wav;
+    if (!path) return;
+
+    uint32_t rate = 0;
+    if (!wav_read_mono16(path, mic_samples, rate)) {
+        fprintf(stderr, "[SIM] cannot read mic WAV %s; using silence\n", path);
+        mic_samples.clear();
+    } else if (rate != sample_rate) {
+        fprintf(stderr, "[SIM] mic WAV is %u Hz, I2S runs at %u Hz; using silence\n", (unsigned)rate,
+                (unsigned)sample_rate);
+        mic_samples.clear();
+    } else {
+        printf("[SIM] mic: %s (%.1f s, looped)\n", path, mic_samples.size() / (double)rate);
+    }
+}
+
+static void write_speaker() {
+    const char *path = sim_options().speaker_wav;
+    std::lock_guard<std::mutex> lk(speaker_lock);
+    if (!path || speaker_samples.empty()) return;
+    if (wav_write_mono16(path, speaker_samples.data(), speaker_samples.size(), speaker_rate)) {
+        printf("[SIM] speaker: %s (%.1f s)\n", path, speaker_samples.size() / (double)speaker_rate);
+    }
+}
+
+void sim_i2s_print_stats() {
+    printf("[SIM] i2s: rx %llu samples (%u overruns), tx %llu samples (%u underruns, %llu non-silent)\n",
+           (unsigned long long)(rx_chan ? rx_chan->clock.samples : 0), (unsigned)(rx_chan ? rx_chan->clock.overruns : 0),
+           (unsigned long long)(tx_chan ? tx_chan->clock.samples : 0), (unsigned)(tx_chan ? tx_chan->clock.overruns : 0),
+           (unsigned long long)speaker_nonzero);
+}
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t *chan_cfg, i2s_chan_handle_t *ret_tx_handle,
+                          i2s_chan_handle_t *ret_rx_handle) {
+    if (!chan_cfg || (!ret_tx_handle && !ret_rx_handle)) return ESP_ERR_INVALID_ARG;
+    if (chan_cfg->dma_desc_num < 2 || chan_cfg->dma_frame_num == 0) return ESP_ERR_INVALID_ARG;
+    if ((ret_tx_handle && tx_chan) || (ret_rx_handle && rx_chan)) return ESP_ERR_NOT_FOUND;
+    if (ret_tx_handle) {
+        tx_chan = new i2s_channel_obj_t();
+        tx_chan->tx = true;
+        tx_chan->config = *chan_cfg;
+        *ret_tx_handle = tx_chan;
+    }
+    if (ret_rx_handle) {
+        rx_chan = new i2s_channel_obj_t();
+        rx_chan->config = *chan_cfg;
+        *ret_rx_handle = rx_chan;
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle) {
+    if (!handle || handle->enabled) return ESP_ERR_INVALID_STATE;
+    if (handle == rx_chan) rx_chan = nullptr;
+    if (handle == tx_chan) tx_chan = nullptr;
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t *std_cfg) {
+    if (!handle || !std_cfg) return ESP_ERR_INVALID_ARG;
+    i2s_data_bit_width_t width = std_cfg->slot_cfg.data_bit_width;
+    // Microphones may deliver 32-bit slots (the WAV's samples, left-justified); the speaker takes 16-bit
+    bool supported = width == I2S_DATA_BIT_WIDTH_16BIT || (!handle->tx && width == I2S_DATA_BIT_WIDTH_32BIT);
+    if (!supported || std_cfg->slot_cfg.slot_mode != I2S_SLOT_MODE_MONO) {
+        fprintf(stderr, "[SIM] i2s: only 16-bit mono (and 32-bit mono RX) slots are simulated\n");
+        return ESP_ERR_INVALID_ARG;
+    }
+    handle->sample_rate = std_cfg->clk_cfg.sample_rate_hz;
+    handle->sample_bytes = width / 8;
+    handle->initialized = true;
+    if (handle->tx) {
+        speaker_rate = handle->sample_rate;
+        sim_at_exit(write_speaker);
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t handle, const i2s_event_callbacks_t *callbacks,
+                                              void *user_data) {
+    if (!handle || !callbacks) return ESP_ERR_INVALID_ARG;
+    if (handle->enabled) return ESP_ERR_INVALID_STATE; // as on the target: register before enabling
+    handle->callbacks = *callbacks;
+    handle->user_data = user_data;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle) {
+    if (!handle || !handle->initialized || handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle) {
+    if (!handle || !handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_preload_data(i2s_chan_handle_t tx_handle, const void *src, size_t size, size_t *bytes_loaded) {
+    (void)src;
+    if (!tx_handle || !tx_handle->tx || tx_handle->enabled) return ESP_ERR_INVALID_STATE;
+    // Preloaded data plays once the channel starts; the simulated DMA holds no samples
+    *bytes_loaded = size;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_read(i2s_chan_handle_t handle, void *dest, size_t size, size_t *bytes_read,
+                           uint32_t timeout_ms) {
+    (void)timeout_ms;
+    if (!handle || handle->tx || !handle->enabled) return ESP_ERR_INVALID_STATE;
+    if (!mic_loaded) load_mic(handle->sample_rate);
+
+    size_t count = size / handle->sample_bytes;
+    // Capture time of the first sample, for the echo
+    const char *echo = sim_options().echo_db;
+    float echo_gain = echo ? powf(10.0f, (float)atof(echo) / 20.0f) : 0.0f;
+    auto first = handle->clock.started
+                     ? handle->clock.origin + std::chrono::microseconds(handle->clock.samples * 1000000ull / handle->sample_rate)
+                     : std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        int16_t sample = 0;
+        if (!mic_samples.empty()) {
+            sample = mic_samples[mic_pos];
+            mic_pos = (mic_pos + 1) % mic_samples.size();
+        }
+        if (echo) {
+            float v = sample + echo_at(first + std::chrono::microseconds(i * 1000000ull / handle->sample_rate),
+                                       handle->sample_rate, echo_gain);
+            sample = (int16_t)(v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v));
+        }
+        if (handle->sample_bytes == sizeof(int32_t)) {
+            ((int32_t *)dest)[i] = (int32_t)((uint32_t)(int32_t)sample << 16);
+        } else {
+            ((int16_t *)dest)[i] = sample;
+        }
+    }
+    handle->transferred(dest, count);
+    if (bytes_read) *bytes_read = count * handle->sample_bytes;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_write(i2s_chan_handle_t handle, const void *src, size_t size, size_t *bytes_written,
+                            uint32_t timeout_ms) {
+    (void)timeout_ms;
+    if (!handle || !handle->tx || !handle->enabled) return ESP_ERR_INVALID_STATE;
+
+    size_t count = size / sizeof(int16_t);
+    const int16_t *in = (const int16_t *)src;
+    {
+        std::lock_guard<std::mutex> lk(speaker_lock);
+        for (size_t i = 0; i < count; i++) {
+            if (in[i]) speaker_nonzero++;
+        }
+        if (sim_options().speaker_wav) speaker_samples.insert(speaker_samples.end(), in, in + count);
+    }
+    handle->transferred((void *)src, count);
+    if (sim_options().echo_db) {
+        // Paced: the clock now covers this block, and its origin is final until the next underrun
+        std::lock_guard<std::mutex> lk(speaker_lock);
+        for (size_t i = 0; i < count; i++) echo_history[(echo_written + i) % ECHO_HISTORY] = in[i];
+        echo_written += count;
+        echo_origin = handle->clock.origin;
+        echo_ring_samples = handle->config.dma_desc_num * handle->config.dma_frame_num;
+    }
+    if (bytes_written) *bytes_written = count * sizeof(int16_t);
+    return ESP_OK;
+}
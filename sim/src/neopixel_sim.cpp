@@ -0,0 +1,9 @@
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+
+void Adafruit_NeoPixel::show() {
+    if (pending == shown) return;
+    shown = pending;
+    Serial.printf("[SIM] LED rgb(%u,%u,%u)\n", (unsigned)((shown >> 16) & 0xFF), (unsigned)((shown >> 8) & 0xFF),
+                  (unsigned)(shown & 0xFF));
+}
@@ -0,0 +1,251 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "net_sim.h"
+#include "sim_runtime.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+int sim_tcp_connect(const char *host, uint16_t port, uint32_t timeout_ms) {
+    char port_str[8];
+    snprintf(port_str, sizeof(port_str), "%u", (unsigned)port);
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *res = nullptr;
+    if (getaddrinfo(host, port_str, &hints, &res) != 0) return -1;
+
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+
+        // Non-blocking connect so the timeout applies
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        int rc = connect(fd, ai->ai_addr, ai->ai_addrlen);
+        if (rc != 0 && errno == EINPROGRESS) {
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (poll(&pfd, 1, (int)timeout_ms) == 1 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) {
+                rc = 0;
+            }
+        }
+        fcntl(fd, F_SETFL, flags);
+        if (rc == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+bool sim_send_all(int fd, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd = {fd, POLLOUT, 0};
+                poll(&pfd, 1, 100);
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+bool sim_wait_readable(int fd, uint32_t timeout_ms) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, (int)timeout_ms) == 1;
+}
+
+// --- WiFi ---
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *pass) {
+    (void)pass;
+    printf("[SIM] WiFi: associated with '%s' (host network)\n", ssid ? ssid : "");
+    state = WL_CONNECTED;
+    return state;
+}
+
+uint8_t *WiFiClass::macAddress(uint8_t *mac) {
+    const char *opt = sim_options().mac;
+    unsigned int b[6];
+    if (opt && sscanf(opt, "%2x%2x%2x%2x%2x%2x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) == 6) {
+        for (int i = 0; i < 6; i++) mac[i] = (uint8_t)b[i];
+    } else {
+        // Locally administered address, unique per process
+        uint32_t pid = (uint32_t)getpid();
+        mac[0] = 0x02;
+        mac[1] = 0x00;
+        mac[2] = (uint8_t)(pid >> 24);
+        mac[3] = (uint8_t)(pid >> 16);
+        mac[4] = (uint8_t)(pid >> 8);
+        mac[5] = (uint8_t)pid;
+    }
+    return mac;
+}
+
+// --- WiFiClient ---
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+    stop();
+    fd = sim_tcp_connect(host, port, 5000);
+    if (fd < 0) return 0;
+    // Blocking reads give up after 5 s, like the library's response timeout
+    struct timeval tv = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t len) {
+    if (fd < 0) return 0;
+    if (!sim_send_all(fd, buf, len)) {
+        stop();
+        return 0;
+    }
+    return len;
+}
+
+int WiFiClient::available() {
+    if (fd < 0) return 0;
+    if (peeked >= 0) return 1;
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) != 1) return 0;
+    int c = read();
+    if (c < 0) return 0;
+    peeked = c;
+    return 1;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t len) {
+    if (len == 0) return 0;
+    if (peeked >= 0) {
+        buf[0] = (uint8_t)peeked;
+        peeked = -1;
+        return 1;
+    }
+    if (fd < 0) return -1;
+    ssize_t n = recv(fd, buf, len, 0);
+    if (n <= 0) {
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) return -1;
+        stop();
+        return -1;
+    }
+    return (int)n;
+}
+
+int WiFiClient::peek() {
+    return available() ? peeked : -1;
+}
+
+uint8_t WiFiClient::connected() {
+    return fd >= 0 || peeked >= 0;
+}
+
+void WiFiClient::stop() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    peeked = -1;
+}
+
+// --- WiFiUDP ---
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return 0;
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+void WiFiUDP::stop() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    tx.clear();
+    rx.clear();
+    rx_pos = 0;
+}
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port) {
+    if (fd < 0) return 0;
+    char port_str[8];
+    snprintf(port_str, sizeof(port_str), "%u", (unsigned)port);
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    struct addrinfo *res = nullptr;
+    if (getaddrinfo(host, port_str, &hints, &res) != 0 || !res) return 0;
+    const uint8_t *a = (const uint8_t *)res->ai_addr;
+    tx_addr.assign(a, a + res->ai_addrlen);
+    freeaddrinfo(res);
+    tx.clear();
+    return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t len) {
+    if (fd < 0 || tx_addr.empty()) return 0;
+    tx.insert(tx.end(), buf, buf + len);
+    return len;
+}
+
+int WiFiUDP::endPacket() {
+    if (fd < 0 || tx_addr.empty()) return 0;
+    ssize_t n = sendto(fd, tx.data(), tx.size(), 0, (const struct sockaddr *)tx_addr.data(),
+                       (socklen_t)tx_addr.size());
+    tx.clear();
+    return n >= 0 ? 1 : 0;
+}
+
+int WiFiUDP::parsePacket() {
+    rx.clear();
+    rx_pos = 0;
+    if (fd < 0) return 0;
+    uint8_t buf[2048];
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) return 0;
+    rx.assign(buf, buf + n);
+    return (int)n;
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t len) {
+    size_t n = rx.size() - rx_pos;
+    if (n > len) n = len;
+    memcpy(buf, rx.data() + rx_pos, n);
+    rx_pos += n;
+    return (int)n;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Host socket helpers shared by the WiFi, HTTP and WebSocket stand-ins.
+ */
+
+/**
+ * @brief Resolve and connect (IPv4/IPv6) with a timeout; TCP_NODELAY is set.
+ * @return Socket fd, or -1
+ */
+int sim_tcp_connect(const char *host, uint16_t port, uint32_t timeout_ms);
+
+/**
+ * @brief Write the whole buffer (waits for socket space).
+ */
+bool sim_send_all(int fd, const void *data, size_t len);
+
+/**
+ * @brief Wait until @p fd is readable.
+ * @return true if readable before the timeout
+ */
+bool sim_wait_readable(int fd, uint32_t timeout_ms);
@@ -0,0 +1,174 @@
+#include <Arduino.h>
+#include <SD_MMC.h>
+#include "sim_runtime.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace fs {
+
+struct SimFileData {
+    std::string contents;
+};
+
+static std::map<std::string, std::shared_ptr<SimFileData>> files;
+static std::set<std::string> dirs = {"/"};
+static std::mutex fs_lock;
+
+static std::string normalize(const char *path) {
+    std::string p = path ? path : "/";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    while (p.size() > 1 && p.back() == '/') p.pop_back();
+    return p;
+}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t len) {
+    if (!data || !writable) return 0;
+    buffer.append((const char *)buf, len);
+    pos = buffer.size();
+    return len;
+}
+
+int File::available() {
+    return data ? (int)(buffer.size() - pos) : 0;
+}
+
+int File::read() {
+    if (!data || pos >= buffer.size()) return -1;
+    return (uint8_t)buffer[pos++];
+}
+
+int File::peek() {
+    if (!data || pos >= buffer.size()) return -1;
+    return (uint8_t)buffer[pos];
+}
+
+size_t File::read(uint8_t *buf, size_t len) {
+    size_t n = 0;
+    while (n < len && pos < buffer.size()) buf[n++] = (uint8_t)buffer[pos++];
+    return n;
+}
+
+bool File::seek(uint32_t p) {
+    if (p > buffer.size()) return false;
+    pos = p;
+    return true;
+}
+
+size_t File::size() const {
+    return buffer.size();
+}
+
+void File::close() {
+    if (data && writable) {
+        std::lock_guard<std::mutex> lk(fs_lock);
+        data->contents = buffer;
+    }
+    data.reset();
+}
+
+File FS::open(const char *path, const char *mode, bool create) {
+    (void)create;
+    std::string p = normalize(path);
+    std::lock_guard<std::mutex> lk(fs_lock);
+    File f;
+
+    bool write_mode = mode && (mode[0] == 'w' || mode[0] == 'a');
+    auto it = files.find(p);
+    if (!write_mode) {
+        if (it == files.end()) return f;
+        f.data = it->second;
+        f.buffer = it->second->contents;
+    } else {
+        std::string parent = p.substr(0, p.rfind('/'));
+        if (!parent.empty() && !dirs.count(parent)) return f; // like FAT: no implicit directories
+        if (it == files.end()) it = files.emplace(p, std::make_shared<SimFileData>()).first;
+        f.data = it->second;
+        if (mode[0] == 'a') f.buffer = it->second->contents;
+        f.writable = true;
+        f.pos = f.buffer.size();
+    }
+    f.path = p;
+    return f;
+}
+
+bool FS::exists(const char *path) {
+    std::string p = normalize(path);
+    std::lock_guard<std::mutex> lk(fs_lock);
+    return files.count(p) || dirs.count(p);
+}
+
+bool FS::mkdir(const char *path) {
+    std::lock_guard<std::mutex> lk(fs_lock);
+    dirs.insert(normalize(path));
+    return true;
+}
+
+bool FS::remove(const char *path) {
+    std::lock_guard<std::mutex> lk(fs_lock);
+    return files.erase(normalize(path)) > 0;
+}
+
+size_t FS::importHostDir(const char *host_dir) {
+    std::lock_guard<std::mutex> lk(fs_lock);
+    size_t imported = 0;
+    std::vector<std::pair<std::string, std::string>> pending = {{host_dir, "/"}};
+
+    while (!pending.empty()) {
+        auto [host, sim] = pending.back();
+        pending.pop_back();
+        DIR *d = opendir(host.c_str());
+        if (!d) continue;
+        while (struct dirent *e = readdir(d)) {
+            std::string name = e->d_name;
+            if (name == "." || name == "..") continue;
+            std::string host_path = host + "/" + name;
+            std::string sim_path = (sim == "/" ? "" : sim) + "/" + name;
+
+            struct stat st;
+            if (stat(host_path.c_str(), &st) != 0) continue;
+            if (S_ISDIR(st.st_mode)) {
+                dirs.insert(sim_path);
+                pending.push_back({host_path, sim_path});
+            } else if (S_ISREG(st.st_mode)) {
+                FILE *hf = fopen(host_path.c_str(), "rb");
+                if (!hf) continue;
+                auto data = std::make_shared<SimFileData>();
+                char chunk[4096];
+                size_t n;
+                while ((n = fread(chunk, 1, sizeof(chunk), hf)) > 0) data->contents.append(chunk, n);
+                fclose(hf);
+                files[sim_path] = data;
+                imported++;
+            }
+        }
+        closedir(d);
+    }
+    return imported;
+}
+
+} // namespace fs
+
+SDMMCFS SD_MMC;
+
+bool SDMMCFS::begin(const char *mountpoint, bool mode1bit, bool format_if_mount_failed) {
+    (void)mountpoint;
+    (void)mode1bit;
+    (void)format_if_mount_failed;
+    const char *dir = sim_options().sd_dir;
+    if (!dir) {
+        printf("[SIM] SD: empty card (use --sd DIR to preload files)\n");
+        return true;
+    }
+    size_t n = importHostDir(dir);
+    printf("[SIM] SD: %u files from %s\n", (unsigned)n, dir);
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Internal glue shared by the simulator modules (not part of the stand-in API).
+ */
+
+struct SimOptions {
+    const char *sd_dir;       // host directory mirrored into the in-memory SD card
+    const char *mic_wav;      // microphone input (16-bit WAV, looped); silence if null
+    const char *speaker_wav;  // speaker output written at exit; discarded if null
+    const char *echo_db;      // speaker fed back into the microphone at this gain (dB); none if null
+    const char *ptt_script;   // "start_ms+hold_ms,..." scripted PTT presses
+    const char *screenshot;   // PPM of the panel framebuffer written at exit
+    const char *mac;          // "AABBCCDDEEFF"; default derives from the process id
+    uint32_t duration_s;      // exit after this long (0 = run until 'q' / Ctrl-C)
+};
+
+const SimOptions &sim_options();
+
+/**
+ * @brief Register a hook that runs once at simulator exit (flush outputs, print stats).
+ */
+void sim_at_exit(void (*fn)(void));
+
+/**
+ * @brief Run the exit hooks and terminate the process.
+ */
+[[noreturn]] void sim_exit(int code);
+
+/**
+ * @brief Press/release an expander input (active-low pin, raises INT).
+ */
+void sim_ioexp_set_input(uint8_t pin, bool pressed);
+
+void sim_i2s_print_stats();
+void sim_display_print_stats();
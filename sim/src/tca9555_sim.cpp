@@ -0,0 +1,75 @@
+#include <Arduino.h>
+#include <TCA9555.h>
+#include <kodedot/pin_config.h>
+#include "sim_runtime.h"
+
+#include <atomic>
+
+// Pin levels of the one simulated expander (bit = 1: high / released)
+static std::atomic<uint16_t> port_levels(0xFFFF);
+static std::atomic<uint16_t> output_levels(0xFFFF);
+
+void sim_ioexp_set_input(uint8_t pin, bool pressed) {
+    if (pin > 15) return;
+    uint16_t bit = (uint16_t)(1u << pin);
+    uint16_t old = pressed ? port_levels.fetch_and((uint16_t)~bit) : port_levels.fetch_or(bit);
+    if (((old & bit) != 0) == !pressed) return;
+
+    // Input change: INT goes low until the port is read
+    sim_gpio_set(IOEXP_INT_PIN, LOW);
+}
+
+TCA9555::TCA9555(uint8_t addr, TwoWire *wire) : address(addr), error(TCA9555_OK) {
+    (void)wire;
+}
+
+bool TCA9555::begin() {
+    error = TCA9555_OK;
+    return true;
+}
+
+bool TCA9555::pinMode1(uint8_t pin, uint8_t mode) {
+    (void)mode;
+    error = pin > 15 ? TCA9555_PIN_ERROR : TCA9555_OK;
+    return error == TCA9555_OK;
+}
+
+bool TCA9555::write1(uint8_t pin, uint8_t value) {
+    if (pin > 15) {
+        error = TCA9555_PIN_ERROR;
+        return false;
+    }
+    uint16_t bit = (uint16_t)(1u << pin);
+    if (value) output_levels |= bit;
+    else output_levels &= (uint16_t)~bit;
+    error = TCA9555_OK;
+    return true;
+}
+
+uint8_t TCA9555::read1(uint8_t pin) {
+    if (pin > 15) {
+        error = TCA9555_PIN_ERROR;
+        return 0;
+    }
+    return (read16() >> pin) & 1;
+}
+
+bool TCA9555::write16(uint16_t mask) {
+    output_levels = mask;
+    error = TCA9555_OK;
+    return true;
+}
+
+uint16_t TCA9555::read16() {
+    error = TCA9555_OK;
+    uint16_t levels = port_levels.load();
+    // Reading the input port releases INT
+    sim_gpio_set(IOEXP_INT_PIN, HIGH);
+    return levels;
+}
+
+int TCA9555::lastError() {
+    int e = error;
+    error = TCA9555_OK;
+    return e;
+}
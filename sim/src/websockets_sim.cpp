@@ -0,0 +1,241 @@
+#include <Arduino.h>
+#include <WebSocketsClient.h>
+#include "net_sim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const uint32_t WS_CONNECT_TIMEOUT_MS = 2000;
+static const uint32_t WS_HANDSHAKE_TIMEOUT_MS = 5000;
+
+static std::string base64(const uint8_t *data, size_t len) {
+    static const char *tbl = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        out += tbl[(v >> 18) & 63];
+        out += tbl[(v >> 12) & 63];
+        out += (i + 1 < len) ? tbl[(v >> 6) & 63] : '=';
+        out += (i + 2 < len) ? tbl[v & 63] : '=';
+    }
+    return out;
+}
+
+WebSocketsClient::WebSocketsClient()
+    : port(0), configured(false), reconnect_ms(500), last_attempt_ms(0), attempted(false), fd(-1), connected(false),
+      message_opcode(0), mask_seed(0x9E3779B9u ^ (uint32_t)getpid()) {}
+
+WebSocketsClient::~WebSocketsClient() {
+    closeSocket(false);
+}
+
+void WebSocketsClient::begin(const char *h, uint16_t p, const char *u, const char *proto) {
+    host = h ? h : "";
+    port = p;
+    url = u ? u : "/";
+    protocol = proto ? proto : "";
+    configured = true;
+    attempted = false;
+}
+
+void WebSocketsClient::emit(WStype_t type, uint8_t *payload, size_t length) {
+    if (event_cb) event_cb(type, payload, length);
+}
+
+bool WebSocketsClient::connectNow() {
+    fd = sim_tcp_connect(host.c_str(), port, WS_CONNECT_TIMEOUT_MS);
+    if (fd < 0) return false;
+
+    uint8_t key[16];
+    for (uint8_t &b : key) {
+        mask_seed ^= mask_seed << 13;
+        mask_seed ^= mask_seed >> 17;
+        mask_seed ^= mask_seed << 5;
+        b = (uint8_t)mask_seed;
+    }
+    std::string req = "GET " + url + " HTTP/1.1\r\n"
+                      "Host: " + host + ":" + std::to_string(port) + "\r\n"
+                      "Connection: Upgrade\r\n"
+                      "Upgrade: websocket\r\n"
+                      "Sec-WebSocket-Version: 13\r\n"
+                      "Sec-WebSocket-Key: " + base64(key, sizeof(key)) + "\r\n";
+    if (!protocol.empty()) req += "Sec-WebSocket-Protocol: " + protocol + "\r\n";
+    req += "User-Agent: arduino-WebSocket-Client\r\n\r\n";
+    if (!sim_send_all(fd, req.data(), req.size())) {
+        closeSocket(false);
+        return false;
+    }
+
+    // Read the handshake response byte-wise so no frame data is consumed
+    std::string resp;
+    unsigned long t0 = millis();
+    while (resp.find("\r\n\r\n") == std::string::npos) {
+        if (millis() - t0 > WS_HANDSHAKE_TIMEOUT_MS || !sim_wait_readable(fd, 100)) {
+            if (millis() - t0 > WS_HANDSHAKE_TIMEOUT_MS) {
+                closeSocket(false);
+                return false;
+            }
+            continue;
+        }
+        char c;
+        if (recv(fd, &c, 1, 0) != 1) {
+            closeSocket(false);
+            return false;
+        }
+        resp += c;
+    }
+    if (resp.compare(0, 12, "HTTP/1.1 101") != 0) {
+        Serial.printf("[SIM] WS handshake rejected: %s\n", resp.substr(0, resp.find("\r\n")).c_str());
+        closeSocket(false);
+        return false;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    connected = true;
+    rx.clear();
+    message.clear();
+    return true;
+}
+
+void WebSocketsClient::loop() {
+    if (!configured) return;
+
+    if (!connected) {
+        unsigned long now = millis();
+        if (attempted && now - last_attempt_ms < reconnect_ms) return;
+        attempted = true;
+        last_attempt_ms = now;
+        if (connectNow()) {
+            emit(WStype_CONNECTED, (uint8_t *)url.c_str(), url.size());
+        }
+        return;
+    }
+
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            rx.insert(rx.end(), buf, buf + n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) break;
+        // Orderly close or error
+        parseFrames();
+        closeSocket(true);
+        return;
+    }
+    parseFrames();
+}
+
+void WebSocketsClient::parseFrames() {
+    size_t pos = 0;
+    while (connected && rx.size() - pos >= 2) {
+        const uint8_t *p = rx.data() + pos;
+        bool fin = p[0] & 0x80;
+        uint8_t opcode = p[0] & 0x0F;
+        bool masked = p[1] & 0x80;
+        uint64_t len = p[1] & 0x7F;
+        size_t hdr = 2;
+        if (len == 126) {
+            if (rx.size() - pos < 4) break;
+            len = ((uint64_t)p[2] << 8) | p[3];
+            hdr = 4;
+        } else if (len == 127) {
+            if (rx.size() - pos < 10) break;
+            len = 0;
+            for (int i = 0; i < 8; i++) len = (len << 8) | p[2 + i];
+            hdr = 10;
+        }
+        size_t mask_at = hdr;
+        if (masked) hdr += 4;
+        if (rx.size() - pos < hdr + len) break;
+
+        std::vector<uint8_t> payload(p + hdr, p + hdr + len);
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); i++) payload[i] ^= p[mask_at + (i & 3)];
+        }
+        pos += hdr + (size_t)len;
+
+        switch (opcode) {
+        case 0x0: // continuation
+        case 0x1:
+        case 0x2:
+            if (opcode != 0x0) {
+                message.clear();
+                message_opcode = opcode;
+            }
+            message.insert(message.end(), payload.begin(), payload.end());
+            if (fin) {
+                size_t mlen = message.size();
+                message.push_back(0); // TEXT payloads are C strings for the callback
+                emit(message_opcode == 0x1 ? WStype_TEXT : WStype_BIN, message.data(), mlen);
+                message.clear();
+            }
+            break;
+        case 0x8: // close
+            sendFrame(0x8, payload.data(), payload.size() >= 2 ? 2 : 0);
+            closeSocket(true);
+            return;
+        case 0x9: // ping
+            sendFrame(0xA, payload.data(), payload.size());
+            emit(WStype_PING, payload.data(), payload.size());
+            break;
+        case 0xA:
+            emit(WStype_PONG, payload.data(), payload.size());
+            break;
+        default:
+            break;
+        }
+    }
+    rx.erase(rx.begin(), rx.begin() + (std::min)(pos, rx.size()));
+}
+
+bool WebSocketsClient::sendFrame(uint8_t opcode, const uint8_t *payload, size_t length) {
+    if (!connected) return false;
+
+    std::vector<uint8_t> frame;
+    frame.reserve(length + 14);
+    frame.push_back(0x80 | opcode);
+    if (length < 126) {
+        frame.push_back(0x80 | (uint8_t)length);
+    } else if (length <= 0xFFFF) {
+        frame.push_back(0x80 | 126);
+        frame.push_back((uint8_t)(length >> 8));
+        frame.push_back((uint8_t)length);
+    } else {
+        frame.push_back(0x80 | 127);
+        for (int i = 7; i >= 0; i--) frame.push_back((uint8_t)((uint64_t)length >> (8 * i)));
+    }
+
+    // Client frames are always masked
+    mask_seed ^= mask_seed << 13;
+    mask_seed ^= mask_seed >> 17;
+    mask_seed ^= mask_seed << 5;
+    uint8_t mask[4] = {(uint8_t)mask_seed, (uint8_t)(mask_seed >> 8), (uint8_t)(mask_seed >> 16),
+                       (uint8_t)(mask_seed >> 24)};
+    frame.insert(frame.end(), mask, mask + 4);
+    for (size_t i = 0; i < length; i++) frame.push_back(payload[i] ^ mask[i & 3]);
+
+    if (!sim_send_all(fd, frame.data(), frame.size())) {
+        closeSocket(true);
+        return false;
+    }
+    return true;
+}
+
+void WebSocketsClient::disconnect() {
+    if (connected) sendFrame(0x8, nullptr, 0);
+    closeSocket(true);
+}
+
+void WebSocketsClient::closeSocket(bool notify) {
+    bool was_connected = connected;
+    if (fd >= 0) close(fd);
+    fd = -1;
+    connected = false;
+    if (notify && was_connected) emit(WStype_DISCONNECTED, nullptr, 0);
+}
@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <kodedot/pin_config.h>
+
+TwoWire Wire;
+
+/*
+ * Simulated I2C devices: a charged battery behind a MAX17048 and a BQ25896
+ * that reports "charge done". Register reads auto-increment.
+ */
+static bool device_present(uint8_t address) {
+    return address == MAX17048_I2C_ADDRESS || address == BQ25896_I2C_ADDRESS;
+}
+
+static uint8_t device_read(uint8_t address, uint8_t reg) {
+    if (address == MAX17048_I2C_ADDRESS) {
+        const uint16_t vcell = (uint16_t)(4100u * 64 / 5); // 4.1 V at 78.125 uV/LSB
+        switch (reg) {
+        case 0x02: return (uint8_t)(vcell >> 8);
+        case 0x03: return (uint8_t)vcell;
+        case 0x04: return 87; // SOC integer percent
+        case 0x05: return 0;
+        default: return 0;
+        }
+    }
+    if (address == BQ25896_I2C_ADDRESS) {
+        if (reg == 0x0B) return 3 << 3; // CHRG_STAT = charge termination done
+        return 0;
+    }
+    return 0xFF;
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    (void)frequency;
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t addr) {
+    address = addr;
+    have_reg = false;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    // First byte selects the register; writes to the simulated registers are ignored
+    if (!have_reg) {
+        reg = data;
+        have_reg = true;
+    }
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) write(data[i]);
+    return len;
+}
+
+uint8_t TwoWire::endTransmission(bool send_stop) {
+    (void)send_stop;
+    return device_present(address) ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t len, bool send_stop) {
+    (void)send_stop;
+    rx_len = 0;
+    rx_pos = 0;
+    if (!device_present(addr)) return 0;
+    if (len > sizeof(rx)) len = sizeof(rx);
+    for (uint8_t i = 0; i < len; i++) rx[i] = device_read(addr, (uint8_t)(reg + i));
+    rx_len = len;
+    return len;
+}
+
+int TwoWire::available() {
+    return rx_len - rx_pos;
+}
+
+int TwoWire::read() {
+    return rx_pos < rx_len ? rx[rx_pos++] : -1;
+}
@@ -0,0 +1,110 @@
+#include "audio/adpcm.h"
+
+static const int16_t STEP_TABLE[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t INDEX_TABLE[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/**
+ * Reconstructed difference for every (step index, 3-bit magnitude) pair,
+ * so decoding is one lookup per sample instead of the shift/add ladder.
+ */
+struct DiffTable {
+    int32_t diff[89][8];
+    DiffTable() {
+        for (int i = 0; i < 89; i++) {
+            int32_t step = STEP_TABLE[i];
+            for (int code = 0; code < 8; code++) {
+                int32_t d = step >> 3;
+                if (code & 4) d += step;
+                if (code & 2) d += step >> 1;
+                if (code & 1) d += step >> 2;
+                diff[i][code] = d;
+            }
+        }
+    }
+};
+
+static const DiffTable &diff_table() {
+    static const DiffTable table;
+    return table;
+}
+
+static inline int32_t clamp16(int32_t v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+
+static inline int clamp_index(int i) {
+    return i < 0 ? 0 : (i > 88 ? 88 : i);
+}
+
+size_t adpcm_encode(AdpcmState *state, const int16_t *pcm, size_t samples, uint8_t *out) {
+    const DiffTable &table = diff_table();
+    int32_t predictor = state->predictor;
+    int index = state->index;
+
+    out[0] = (uint8_t)(predictor & 0xFF);
+    out[1] = (uint8_t)((predictor >> 8) & 0xFF);
+    out[2] = (uint8_t)index;
+    out[3] = 0;
+    uint8_t *dst = out + ADPCM_HEADER_BYTES;
+
+    for (size_t n = 0; n < samples; n++) {
+        int32_t diff = (int32_t)pcm[n] - predictor;
+        uint8_t code = 0;
+        if (diff < 0) {
+            code = 8;
+            diff = -diff;
+        }
+
+        // Quantise |diff| / step to 3 bits without a divide
+        int32_t step = STEP_TABLE[index];
+        if (diff >= step) { code |= 4; diff -= step; }
+        step >>= 1;
+        if (diff >= step) { code |= 2; diff -= step; }
+        step >>= 1;
+        if (diff >= step) { code |= 1; }
+
+        // Track exactly what the decoder will reconstruct
+        int32_t d = table.diff[index][code & 7];
+        predictor = clamp16((code & 8) ? predictor - d : predictor + d);
+        index = clamp_index(index + INDEX_TABLE[code & 7]);
+
+        if (n & 1) {
+            *dst++ |= (uint8_t)(code << 4);
+        } else {
+            *dst = code;
+        }
+    }
+
+    state->predictor = (int16_t)predictor;
+    state->index = (uint8_t)index;
+    return adpcm_packet_bytes(samples);
+}
+
+size_t adpcm_decode(const uint8_t *in, size_t bytes, int16_t *pcm, size_t max_samples) {
+    size_t samples = adpcm_packet_samples(bytes);
+    if (samples == 0 || samples > max_samples || in[2] > 88) return 0;
+
+    const DiffTable &table = diff_table();
+    int32_t predictor = (int16_t)(in[0] | (in[1] << 8));
+    int index = in[2];
+    const uint8_t *src = in + ADPCM_HEADER_BYTES;
+
+    for (size_t n = 0; n < samples; n += 2) {
+        uint8_t byte = *src++;
+        for (int half = 0; half < 2; half++) {
+            uint8_t code = half ? (byte >> 4) : (byte & 0x0F);
+            int32_t d = table.diff[index][code & 7];
+            predictor = clamp16((code & 8) ? predictor - d : predictor + d);
+            index = clamp_index(index + INDEX_TABLE[code & 7]);
+            pcm[n + half] = (int16_t)predictor;
+        }
+    }
+    return samples;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief IMA-ADPCM (4 bits/sample) fixed-point kernels.
+ *
+ * Packets are self-contained so a lost packet does not corrupt the next one:
+ *
+ *   [predictor lo][predictor hi][step index][reserved][nibbles...]
+ *
+ * followed by samples/2 bytes, low nibble first. 256 samples -> 132 bytes.
+ * The kernels have no platform dependencies and build on the host.
+ */
+
+#define ADPCM_HEADER_BYTES 4
+
+struct AdpcmState {
+    int16_t predictor;
+    uint8_t index;
+};
+
+/**
+ * @brief Packet size for @p samples input samples (samples must be even).
+ */
+static inline size_t adpcm_packet_bytes(size_t samples) {
+    return ADPCM_HEADER_BYTES + samples / 2;
+}
+
+/**
+ * @brief Samples carried by a packet of @p bytes (0 if too short).
+ */
+static inline size_t adpcm_packet_samples(size_t bytes) {
+    return bytes > ADPCM_HEADER_BYTES ? (bytes - ADPCM_HEADER_BYTES) * 2 : 0;
+}
+
+/**
+ * @brief Encode @p samples (even) PCM samples into one packet, updating @p state.
+ * @return Bytes written to @p out
+ */
+size_t adpcm_encode(AdpcmState *state, const int16_t *pcm, size_t samples, uint8_t *out);
+
+/**
+ * @brief Decode one packet. The packet header re-seeds the decoder state.
+ * @return Samples written to @p pcm (0 if the packet is malformed or too long)
+ */
+size_t adpcm_decode(const uint8_t *in, size_t bytes, int16_t *pcm, size_t max_samples);
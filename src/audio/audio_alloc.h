@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdlib.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+/**
+ * @brief Allocate a large audio buffer, preferring PSRAM and falling back to the default heap.
+ * Release with free().
+ */
+static inline void *audio_alloc_psram(size_t bytes) {
+#if defined(ESP_PLATFORM)
+    void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (p) return p;
+#endif
+    return malloc(bytes);
+}
@@ -0,0 +1,253 @@
+#include "audio/audio_codec.h"
+#include "audio/adpcm.h"
+
+#include <string.h>
+
+// Opus frame length: 20 ms is the shortest frame with full voice quality
+static const uint32_t OPUS_FRAME_MS = 20;
+// Complexity 0-10; 3 keeps a 16 kHz mono encode well inside one core budget
+static const int OPUS_COMPLEXITY = 3;
+// Longest Opus packet is 120 ms
+static const uint32_t OPUS_MAX_FRAME_MS = 120;
+
+static const char *const CODEC_NAMES[AUDIO_CODEC_COUNT] = {"pcm", "opus", "adpcm"};
+
+const char *audio_codec_name(AudioCodecId id) {
+    return (id < AUDIO_CODEC_COUNT) ? CODEC_NAMES[id] : "unknown";
+}
+
+bool audio_codec_from_name(const char *name, AudioCodecId *id) {
+    if (!name) return false;
+    for (uint8_t i = 0; i < AUDIO_CODEC_COUNT; i++) {
+        if (strcmp(name, CODEC_NAMES[i]) == 0) {
+            *id = (AudioCodecId)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool audio_codec_available(AudioCodecId id) {
+    switch (id) {
+    case AUDIO_CODEC_PCM16:
+        return true;
+    case AUDIO_CODEC_OPUS:
+        return PTT_HAVE_OPUS;
+    case AUDIO_CODEC_ADPCM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// --- Raw PCM (fallback, always available) ---
+
+class PcmEncoder : public AudioEncoder {
+public:
+    PcmEncoder() : last_samples(0) {}
+    AudioCodecId id() const override { return AUDIO_CODEC_PCM16; }
+    void reset() override {}
+    int encode(const int16_t *pcm, size_t samples, uint8_t *out, size_t out_cap) override {
+        size_t bytes = samples * sizeof(int16_t);
+        if (bytes > out_cap) return -1;
+        memcpy(out, pcm, bytes);
+        last_samples = samples;
+        return (int)bytes;
+    }
+    size_t packetSamples() const override { return last_samples; }
+
+private:
+    size_t last_samples;
+};
+
+class PcmDecoder : public AudioDecoder {
+public:
+    AudioCodecId id() const override { return AUDIO_CODEC_PCM16; }
+    int packetSamples(const uint8_t *data, size_t len) const override {
+        (void)data;
+        return (int)(len / sizeof(int16_t));
+    }
+    int decode(const uint8_t *data, size_t len, int16_t *pcm, size_t max_samples) override {
+        size_t samples = len / sizeof(int16_t);
+        if (samples > max_samples) return -1;
+        memcpy(pcm, data, samples * sizeof(int16_t));
+        return (int)samples;
+    }
+};
+
+// --- IMA-ADPCM (low CPU, 4:1) ---
+
+class AdpcmEncoder : public AudioEncoder {
+public:
+    AdpcmEncoder() : last_samples(0) { reset(); }
+    AudioCodecId id() const override { return AUDIO_CODEC_ADPCM; }
+    void reset() override {
+        state.predictor = 0;
+        state.index = 0;
+    }
+    int encode(const int16_t *pcm, size_t samples, uint8_t *out, size_t out_cap) override {
+        samples &= ~(size_t)1;
+        if (adpcm_packet_bytes(samples) > out_cap) return -1;
+        last_samples = samples;
+        return (int)adpcm_encode(&state, pcm, samples, out);
+    }
+    size_t packetSamples() const override { return last_samples; }
+
+private:
+    AdpcmState state;
+    size_t last_samples;
+};
+
+class AdpcmDecoder : public AudioDecoder {
+public:
+    AudioCodecId id() const override { return AUDIO_CODEC_ADPCM; }
+    int packetSamples(const uint8_t *data, size_t len) const override {
+        (void)data;
+        return (int)adpcm_packet_samples(len);
+    }
+    int decode(const uint8_t *data, size_t len, int16_t *pcm, size_t max_samples) override {
+        size_t samples = adpcm_decode(data, len, pcm, max_samples);
+        return samples ? (int)samples : -1;
+    }
+};
+
+#if PTT_HAVE_OPUS
+
+// --- Opus (voice mode, mono) ---
+
+class OpusAudioEncoder : public AudioEncoder {
+public:
+    OpusAudioEncoder() : enc(nullptr), pending(nullptr), frame_samples(0), pending_samples(0) {}
+    ~OpusAudioEncoder() override {
+        if (enc) opus_encoder_destroy(enc);
+        delete[] pending;
+    }
+
+    bool begin(uint32_t sample_rate, uint32_t bitrate) {
+        int err = OPUS_OK;
+        enc = opus_encoder_create((opus_int32)sample_rate, 1, OPUS_APPLICATION_VOIP, &err);
+        if (err != OPUS_OK || !enc) return false;
+        opus_encoder_ctl(enc, OPUS_SET_BITRATE((opus_int32)bitrate));
+        opus_encoder_ctl(enc, OPUS_SET_COMPLEXITY(OPUS_COMPLEXITY));
+        opus_encoder_ctl(enc, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+        frame_samples = sample_rate * OPUS_FRAME_MS / 1000;
+        pending = new int16_t[frame_samples];
+        return true;
+    }
+
+    AudioCodecId id() const override { return AUDIO_CODEC_OPUS; }
+
+    void reset() override {
+        opus_encoder_ctl(enc, OPUS_RESET_STATE);
+        pending_samples = 0;
+    }
+
+    int encode(const int16_t *pcm, size_t samples, uint8_t *out, size_t out_cap) override {
+        if (samples > frame_samples) return -1;
+
+        // Capture blocks (e.g. 256 samples) rarely match the 20 ms Opus frame: accumulate
+        size_t take = frame_samples - pending_samples;
+        if (take > samples) take = samples;
+        memcpy(pending + pending_samples, pcm, take * sizeof(int16_t));
+        pending_samples += take;
+        if (pending_samples < frame_samples) return 0;
+
+        int bytes = opus_encode(enc, pending, (int)frame_samples, out, (opus_int32)out_cap);
+
+        // Carry the remainder of this block into the next frame
+        pending_samples = samples - take;
+        memcpy(pending, pcm + take, pending_samples * sizeof(int16_t));
+        return bytes;
+    }
+
+    size_t packetSamples() const override { return frame_samples; }
+
+private:
+    OpusEncoder *enc;
+    int16_t *pending;
+    size_t frame_samples;
+    size_t pending_samples;
+};
+
+class OpusAudioDecoder : public AudioDecoder {
+public:
+    OpusAudioDecoder() : dec(nullptr), sample_rate(0) {}
+    ~OpusAudioDecoder() override {
+        if (dec) opus_decoder_destroy(dec);
+    }
+
+    bool begin(uint32_t rate) {
+        int err = OPUS_OK;
+        sample_rate = rate;
+        dec = opus_decoder_create((opus_int32)rate, 1, &err);
+        return err == OPUS_OK && dec;
+    }
+
+    AudioCodecId id() const override { return AUDIO_CODEC_OPUS; }
+
+    int packetSamples(const uint8_t *data, size_t len) const override {
+        int n = opus_packet_get_nb_samples(data, (opus_int32)len, (opus_int32)sample_rate);
+        if (n <= 0 || (uint32_t)n > sample_rate * OPUS_MAX_FRAME_MS / 1000) return 0;
+        return n;
+    }
+
+    int decode(const uint8_t *data, size_t len, int16_t *pcm, size_t max_samples) override {
+        return opus_decode(dec, data, (opus_int32)len, pcm, (int)max_samples, 0);
+    }
+
+    int conceal(int16_t *pcm, size_t samples) override {
+        // NULL packet: Opus extrapolates from its internal state
+        return opus_decode(dec, nullptr, 0, pcm, (int)samples, 0);
+    }
+
+private:
+    OpusDecoder *dec;
+    uint32_t sample_rate;
+};
+
+#endif // PTT_HAVE_OPUS
+
+AudioEncoder *audio_encoder_create(AudioCodecId id, uint32_t sample_rate, uint32_t bitrate) {
+    (void)sample_rate;
+    (void)bitrate;
+    switch (id) {
+    case AUDIO_CODEC_PCM16:
+        return new PcmEncoder();
+    case AUDIO_CODEC_ADPCM:
+        return new AdpcmEncoder();
+#if PTT_HAVE_OPUS
+    case AUDIO_CODEC_OPUS: {
+        OpusAudioEncoder *e = new OpusAudioEncoder();
+        if (!e->begin(sample_rate, bitrate)) {
+            delete e;
+            return nullptr;
+        }
+        return e;
+    }
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+AudioDecoder *audio_decoder_create(AudioCodecId id, uint32_t sample_rate) {
+    (void)sample_rate;
+    switch (id) {
+    case AUDIO_CODEC_PCM16:
+        return new PcmDecoder();
+    case AUDIO_CODEC_ADPCM:
+        return new AdpcmDecoder();
+#if PTT_HAVE_OPUS
+    case AUDIO_CODEC_OPUS: {
+        OpusAudioDecoder *d = new OpusAudioDecoder();
+        if (!d->begin(sample_rate)) {
+            delete d;
+            return nullptr;
+        }
+        return d;
+    }
+#endif
+    default:
+        return nullptr;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Opus is optional: only offered when the library is on the include path
+#if __has_include(<opus.h>)
+#include <opus.h>
+#define PTT_HAVE_OPUS 1
+#else
+#define PTT_HAVE_OPUS 0
+#endif
+
+/**
+ * @brief Codec identifiers used on the wire and in the control channel.
+ *
+ * The numeric value is stable (it is carried per frame); the name is what
+ * appears in the JSON "caps"/"caps_ack"/"talk_start" messages.
+ */
+enum AudioCodecId : uint8_t {
+    AUDIO_CODEC_PCM16 = 0, // raw 16-bit little-endian PCM (always available)
+    AUDIO_CODEC_OPUS = 1,  // Opus, 20 ms frames
+    AUDIO_CODEC_ADPCM = 2, // IMA-ADPCM 4:1, one self-contained packet per capture block
+    AUDIO_CODEC_COUNT
+};
+
+/**
+ * @brief Wire name of a codec ("pcm", "opus", "adpcm").
+ */
+const char *audio_codec_name(AudioCodecId id);
+
+/**
+ * @brief Parse a wire name; returns false for unknown names.
+ */
+bool audio_codec_from_name(const char *name, AudioCodecId *id);
+
+/**
+ * @brief Whether this build can encode and decode @p id.
+ */
+bool audio_codec_available(AudioCodecId id);
+
+/**
+ * @brief Capture-side codec state (one instance per encoding task).
+ */
+class AudioEncoder {
+public:
+    virtual ~AudioEncoder() {}
+
+    virtual AudioCodecId id() const = 0;
+
+    /**
+     * @brief Drop buffered input and codec history (call at the start of a talk burst).
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Feed captured PCM. Codecs with a different frame size re-frame
+     * internally, so a call emits at most one packet.
+     * @param samples Input length, at most one codec frame
+     * @return Packet bytes written to @p out, 0 if more input is needed, <0 on error
+     */
+    virtual int encode(const int16_t *pcm, size_t samples, uint8_t *out, size_t out_cap) = 0;
+
+    /**
+     * @brief Playout duration of the packet the last encode() emitted, in samples.
+     */
+    virtual size_t packetSamples() const = 0;
+};
+
+/**
+ * @brief Receive-side codec state (one instance per decoding task).
+ */
+class AudioDecoder {
+public:
+    virtual ~AudioDecoder() {}
+
+    virtual AudioCodecId id() const = 0;
+
+    /**
+     * @brief Playout duration of a packet, without decoding it. Stateless.
+     * @return Samples, or 0 if the packet is malformed
+     */
+    virtual int packetSamples(const uint8_t *data, size_t len) const = 0;
+
+    /**
+     * @return Decoded samples written to @p pcm, <0 on error
+     */
+    virtual int decode(const uint8_t *data, size_t len, int16_t *pcm, size_t max_samples) = 0;
+
+    /**
+     * @brief Synthesize @p samples for a lost packet with the codec's own PLC.
+     * @return Samples written, or <0 if the codec has none (caller conceals instead)
+     */
+    virtual int conceal(int16_t * /*pcm*/, size_t /*samples*/) { return -1; }
+};
+
+/**
+ * @brief Create an encoder, or nullptr if the codec is not available.
+ * @param bitrate Target bitrate in bit/s (ignored by fixed-rate codecs)
+ */
+AudioEncoder *audio_encoder_create(AudioCodecId id, uint32_t sample_rate, uint32_t bitrate);
+
+/**
+ * @brief Create a decoder, or nullptr if the codec is not available.
+ */
+AudioDecoder *audio_decoder_create(AudioCodecId id, uint32_t sample_rate);
@@ -0,0 +1,88 @@
+#include "audio/audio_frame.h"
+
+void audio_frame_write_header(const AudioFrameHeader &h, uint8_t *out) {
+    out[0] = (uint8_t)((h.version & 0x03) << 6) | (uint8_t)((h.flags & 0x03) << 4) | (h.codec & 0x0F);
+    out[1] = h.burst;
+    out[2] = (uint8_t)h.seq;
+    out[3] = (uint8_t)(h.seq >> 8);
+    out[4] = (uint8_t)h.capture_us;
+    out[5] = (uint8_t)(h.capture_us >> 8);
+    out[6] = (uint8_t)(h.capture_us >> 16);
+    out[7] = (uint8_t)(h.capture_us >> 24);
+}
+
+bool audio_frame_parse_header(const uint8_t *data, size_t len, AudioFrameHeader *h) {
+    if (len < AUDIO_FRAME_HEADER_BYTES) return false;
+    h->version = data[0] >> 6;
+    if (h->version != AUDIO_FRAME_VERSION) return false;
+    h->flags = (data[0] >> 4) & 0x03;
+    h->codec = data[0] & 0x0F;
+    h->burst = data[1];
+    h->seq = (uint16_t)(data[2] | (data[3] << 8));
+    h->capture_us = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) |
+                    ((uint32_t)data[7] << 24);
+    return true;
+}
+
+AudioRxStats::AudioRxStats()
+    : active(false), burst(0), highest_seq(0), seen_mask(0), last_gap(0), last_arrival_us(0), last_capture_us(0),
+      jitter_q4(0), received(0), lost(0), late(0), duplicates(0), bursts(0), jitter_us(0) {
+}
+
+AudioRxStats::Verdict AudioRxStats::onFrame(const AudioFrameHeader &h, uint32_t arrival_us) {
+    received.fetch_add(1, std::memory_order_relaxed);
+
+    // A new burst restarts sequence tracking (the sender may have dropped frames in between)
+    if (!active || h.burst != burst || (h.flags & AUDIO_FRAME_FLAG_FIRST)) {
+        if (!active || h.burst != burst) bursts.fetch_add(1, std::memory_order_relaxed);
+        active = true;
+        burst = h.burst;
+        highest_seq = h.seq;
+        seen_mask = 1;
+        last_arrival_us = arrival_us;
+        last_capture_us = h.capture_us;
+        return FRAME_IN_ORDER;
+    }
+
+    int16_t delta = (int16_t)(h.seq - highest_seq);
+    if (delta <= 0) {
+        uint32_t back = (uint32_t)(-delta);
+        if (back < 64 && (seen_mask & (1ULL << back))) {
+            duplicates.fetch_add(1, std::memory_order_relaxed);
+            return FRAME_DUPLICATE;
+        }
+        // Counted as lost when the gap was seen; it did arrive, just too late to play
+        if (back < 64) seen_mask |= 1ULL << back;
+        late.fetch_add(1, std::memory_order_relaxed);
+        if (lost.load(std::memory_order_relaxed) > 0) lost.fetch_sub(1, std::memory_order_relaxed);
+        return FRAME_LATE;
+    }
+
+    // RFC 3550 interarrival jitter between consecutive in-order frames
+    int32_t d = (int32_t)(arrival_us - last_arrival_us) - (int32_t)(h.capture_us - last_capture_us);
+    if (d < 0) d = -d;
+    jitter_q4 += (uint32_t)d - (jitter_q4 >> 4);
+    jitter_us.store(jitter_q4 >> 4, std::memory_order_relaxed);
+    last_arrival_us = arrival_us;
+    last_capture_us = h.capture_us;
+
+    seen_mask = delta < 64 ? (seen_mask << delta) | 1 : 1;
+    highest_seq = h.seq;
+    last_gap = (uint16_t)(delta - 1);
+    if (delta > 1) {
+        lost.fetch_add((uint32_t)(delta - 1), std::memory_order_relaxed);
+        return FRAME_AFTER_GAP;
+    }
+    return FRAME_IN_ORDER;
+}
+
+AudioRxStats::Stats AudioRxStats::getStats() const {
+    Stats st;
+    st.received = received.load(std::memory_order_relaxed);
+    st.lost = lost.load(std::memory_order_relaxed);
+    st.late = late.load(std::memory_order_relaxed);
+    st.duplicates = duplicates.load(std::memory_order_relaxed);
+    st.bursts = bursts.load(std::memory_order_relaxed);
+    st.jitter_us = jitter_us.load(std::memory_order_relaxed);
+    return st;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Header version spoken by this build ("frame" in caps / caps_ack / talk_start)
+#define AUDIO_FRAME_VERSION 1
+#define AUDIO_FRAME_HEADER_BYTES 8
+
+enum AudioFrameFlags : uint8_t {
+    AUDIO_FRAME_FLAG_FIRST = 0x1, // first frame of a talk burst
+    AUDIO_FRAME_FLAG_PROBE = 0x2  // latency probe: listeners answer with "lat_report"
+};
+
+// Codec id of a comfort noise descriptor (audio/comfort_noise.h), sent in
+// place of silent frames by talkers using DTX. Outside AudioCodecId, so
+// builds that predate it drop the frame as an unknown codec.
+#define AUDIO_FRAME_CODEC_CN 15
+
+// With several talkers at once, a server that confirmed "mix":1 in
+// "caps_ack" puts one byte in front of every frame it relays (before the
+// header, also in datagrams): the talker's source id, which its
+// "talk_start" / "talk_stop" carry as "src". Ids are 1..255, unique among
+// the members of a talk group while they are connected.
+#define AUDIO_FRAME_SOURCE_BYTES 1
+
+/**
+ * @brief Metadata carried in front of every binary audio frame (version 1).
+ *
+ * Wire layout, 8 bytes, little-endian:
+ *   byte 0    version (bits 7-6) | flags (bits 5-4) | codec id (bits 3-0)
+ *   byte 1    burst id, incremented per talk_start
+ *   bytes 2-3 sequence number, per sender, continuous across bursts
+ *   bytes 4-7 capture time on the sender's microsecond clock
+ *
+ * Headers are only sent once both ends agreed on them: the client offers
+ * "frame":1 in "caps", the server confirms in "caps_ack" and announces the
+ * talker's choice in "talk_start". Peers that never negotiated receive the
+ * bare payload (old servers never ack, so old setups stay headerless).
+ */
+struct AudioFrameHeader {
+    uint8_t version;
+    uint8_t flags;
+    uint8_t codec;
+    uint8_t burst;
+    uint16_t seq;
+    uint32_t capture_us;
+};
+
+/**
+ * @brief Serialize @p h into AUDIO_FRAME_HEADER_BYTES bytes at @p out.
+ */
+void audio_frame_write_header(const AudioFrameHeader &h, uint8_t *out);
+
+/**
+ * @brief Parse the header at the start of a received frame.
+ * @return false if the frame is too short or carries another version
+ */
+bool audio_frame_parse_header(const uint8_t *data, size_t len, AudioFrameHeader *h);
+
+/**
+ * @brief Receive-side loss / reorder / jitter accounting from frame headers.
+ *
+ * Sequence numbers are tracked per burst. A gap counts the skipped frames as
+ * lost; a frame older than the newest one seen is late (it arrived after
+ * audio behind it was already queued for playout) or a duplicate, and the
+ * caller drops it. A late frame is taken back out of the loss count.
+ * Jitter is the RFC 3550 interarrival estimate on the sender's capture
+ * clock, so it reflects network delay variation rather than frame pacing.
+ *
+ * Single writer (the receive path); counters may be read from other tasks.
+ */
+class AudioRxStats {
+public:
+    enum Verdict : uint8_t {
+        FRAME_IN_ORDER = 0,
+        FRAME_AFTER_GAP = 1, // accepted; frames before it are missing
+        FRAME_LATE = 2,      // drop: older than audio already queued
+        FRAME_DUPLICATE = 3  // drop: already received
+    };
+
+    struct Stats {
+        uint32_t received;
+        uint32_t lost;
+        uint32_t late;
+        uint32_t duplicates;
+        uint32_t bursts;
+        uint32_t jitter_us;
+    };
+
+    AudioRxStats();
+
+    /**
+     * @brief Account one received frame.
+     * @param arrival_us Receive time on the local microsecond clock
+     */
+    Verdict onFrame(const AudioFrameHeader &h, uint32_t arrival_us);
+
+    /**
+     * @brief Frames missing right before the last FRAME_AFTER_GAP frame.
+     */
+    uint16_t lastGap() const { return last_gap; }
+
+    Stats getStats() const;
+
+private:
+    bool active;
+    uint8_t burst;
+    uint16_t highest_seq;
+    uint64_t seen_mask;       // bit i: highest_seq - i was received
+    uint16_t last_gap;
+    uint32_t last_arrival_us;
+    uint32_t last_capture_us;
+    uint32_t jitter_q4;       // RFC 3550 J, microseconds << 4
+
+    std::atomic<uint32_t> received;
+    std::atomic<uint32_t> lost;
+    std::atomic<uint32_t> late;
+    std::atomic<uint32_t> duplicates;
+    std::atomic<uint32_t> bursts;
+    std::atomic<uint32_t> jitter_us;
+};
@@ -0,0 +1,142 @@
+#include "audio/audio_mixer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "audio/cycle_count.h"
+#include "audio/pcm_convert.h"
+
+#if defined(__XTENSA__) && __has_include(<dsps_mulc.h>)
+#include <dsps_mulc.h>
+#define AUDIO_MIX_ESP_DSP 1
+#endif
+
+// Kept one sample at a time on purpose: it is the baseline the kernel is measured against
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
+void audio_mix_accumulate_ref(int32_t *acc, const int16_t *pcm, size_t samples, uint16_t gain_q15) {
+    for (size_t i = 0; i < samples; i++) {
+        if (gain_q15 >= AUDIO_MIX_UNITY_Q15) {
+            acc[i] += pcm[i];
+        } else {
+            acc[i] += ((int32_t)pcm[i] * gain_q15) >> 15;
+        }
+    }
+}
+
+static void widen_add(int32_t *acc, const int16_t *pcm, size_t samples) {
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        acc[i] += pcm[i];
+        acc[i + 1] += pcm[i + 1];
+        acc[i + 2] += pcm[i + 2];
+        acc[i + 3] += pcm[i + 3];
+    }
+    for (; i < samples; i++) acc[i] += pcm[i];
+}
+
+void audio_mix_accumulate(int32_t *acc, const int16_t *pcm, size_t samples, uint16_t gain_q15) {
+    if (gain_q15 >= AUDIO_MIX_UNITY_Q15) {
+        widen_add(acc, pcm, samples);
+        return;
+    }
+    // Below unity the gain fits a signed 16-bit operand
+    const int16_t g = (int16_t)gain_q15;
+#if AUDIO_MIX_ESP_DSP
+    // (pcm * g) >> 15 into 16 bits, exactly as below; the sum still widens to 32
+    alignas(16) int16_t scaled[AUDIO_MIX_MAX_BLOCK];
+    while (samples > 0) {
+        size_t n = samples < AUDIO_MIX_MAX_BLOCK ? samples : AUDIO_MIX_MAX_BLOCK;
+        dsps_mulc_s16(pcm, scaled, (int)n, g, 1, 1);
+        widen_add(acc, scaled, n);
+        acc += n;
+        pcm += n;
+        samples -= n;
+    }
+#else
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        acc[i] += ((int32_t)pcm[i] * g) >> 15;
+        acc[i + 1] += ((int32_t)pcm[i + 1] * g) >> 15;
+        acc[i + 2] += ((int32_t)pcm[i + 2] * g) >> 15;
+        acc[i + 3] += ((int32_t)pcm[i + 3] * g) >> 15;
+    }
+    for (; i < samples; i++) acc[i] += ((int32_t)pcm[i] * g) >> 15;
+#endif
+}
+
+void audio_mix_accumulate_ramp(int32_t *acc, const int16_t *pcm, size_t samples, uint16_t from_q15,
+                               uint16_t to_q15) {
+    if (from_q15 == to_q15 || samples == 0) {
+        audio_mix_accumulate(acc, pcm, samples, to_q15);
+        return;
+    }
+    // Gain in Q15 << 8, so the per-sample step keeps its fraction over a whole block
+    int32_t g = (int32_t)from_q15 << 8;
+    int32_t step = (((int32_t)to_q15 - (int32_t)from_q15) << 8) / (int32_t)samples;
+    for (size_t i = 0; i < samples; i++) {
+        g += step;
+        acc[i] += ((int32_t)pcm[i] * (g >> 8)) >> 15;
+    }
+}
+
+AudioMixer::AudioMixer()
+    : block(0), block_streams(0), block_cycles(0), blocks(0), streams(0), max_streams(0), avg_cycles(0),
+      max_cycles(0) {
+}
+
+uint16_t AudioMixer::shareGain(size_t streams) {
+    if (streams <= 1) return AUDIO_MIX_UNITY_Q15;
+    return (uint16_t)lrintf((float)AUDIO_MIX_UNITY_Q15 / sqrtf((float)streams));
+}
+
+uint16_t AudioMixer::applyGain(uint16_t share_q15, uint16_t gain_q15) {
+    if (gain_q15 >= AUDIO_MIX_UNITY_Q15) return share_q15;
+    return (uint16_t)(((uint32_t)share_q15 * gain_q15) >> 15);
+}
+
+void AudioMixer::start(size_t samples) {
+    uint32_t t0 = audio_cycles_now();
+    block = samples < AUDIO_MIX_MAX_BLOCK ? samples : AUDIO_MIX_MAX_BLOCK;
+    memset(acc, 0, block * sizeof(int32_t));
+    block_streams = 0;
+    block_cycles = audio_cycles_now() - t0;
+}
+
+void AudioMixer::add(const int16_t *pcm, size_t samples, uint16_t from_q15, uint16_t to_q15) {
+    uint32_t t0 = audio_cycles_now();
+    if (samples > block) samples = block;
+    audio_mix_accumulate_ramp(acc, pcm, samples, from_q15, to_q15);
+    block_streams++;
+    block_cycles += audio_cycles_now() - t0;
+}
+
+size_t AudioMixer::finish(int16_t *out) {
+    uint32_t t0 = audio_cycles_now();
+    // The accumulator is already at output scale: saturate only
+    pcm_s32_to_s16(acc, out, block, 0);
+    uint32_t cost = block_cycles + (audio_cycles_now() - t0);
+
+    if (block_streams > 0) {
+        blocks.fetch_add(1, std::memory_order_relaxed);
+        streams.fetch_add(block_streams, std::memory_order_relaxed);
+        if (block_streams > max_streams.load(std::memory_order_relaxed)) {
+            max_streams.store(block_streams, std::memory_order_relaxed);
+        }
+        uint32_t avg = avg_cycles.load(std::memory_order_relaxed);
+        avg_cycles.store((uint32_t)((int32_t)avg + (((int32_t)cost - (int32_t)avg) >> 4)), std::memory_order_relaxed);
+        if (cost > max_cycles.load(std::memory_order_relaxed)) max_cycles.store(cost, std::memory_order_relaxed);
+    }
+    return block_streams;
+}
+
+AudioMixer::Stats AudioMixer::getStats() const {
+    Stats st;
+    st.blocks = blocks.load(std::memory_order_relaxed);
+    st.streams = streams.load(std::memory_order_relaxed);
+    st.max_streams = (uint8_t)max_streams.load(std::memory_order_relaxed);
+    st.avg_cycles = avg_cycles.load(std::memory_order_relaxed);
+    st.max_cycles = max_cycles.load(std::memory_order_relaxed);
+    return st;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest block mixed in one pass
+#define AUDIO_MIX_MAX_BLOCK 256
+// Gains are Q15 with unity as 32768 (a plain add)
+#define AUDIO_MIX_UNITY_Q15 32768
+
+/**
+ * @brief Scalar reference: one sample at a time, obviously correct.
+ */
+void audio_mix_accumulate_ref(int32_t *acc, const int16_t *pcm, size_t samples, uint16_t gain_q15);
+
+/**
+ * @brief Add @p pcm scaled by @p gain_q15 into a 32-bit accumulator; same
+ * result as audio_mix_accumulate_ref(), bit for bit.
+ *
+ * Unity gain is a plain widening add. Other gains are a 16x16 multiply
+ * per sample: on the ESP32-S3 with esp-dsp, its vector kernel
+ * (dsps_mulc_s16) scales the block and an unrolled loop widens it into the
+ * accumulator; elsewhere one loop, unrolled by four with no data-dependent
+ * branches, that the host compiler vectorizes.
+ */
+void audio_mix_accumulate(int32_t *acc, const int16_t *pcm, size_t samples, uint16_t gain_q15);
+
+/**
+ * @brief As audio_mix_accumulate(), with the gain ramped linearly from
+ * @p from_q15 to @p to_q15 across the block, so a talker joining or
+ * leaving does not click.
+ */
+void audio_mix_accumulate_ramp(int32_t *acc, const int16_t *pcm, size_t samples, uint16_t from_q15,
+                               uint16_t to_q15);
+
+/**
+ * @brief Sums several 16-bit streams into one output block, saturating once at the end.
+ *
+ * Streams are added into a 32-bit accumulator and only the sum is
+ * saturated to 16 bits (pcm_s32_to_s16, the CLAMPS kernel on the S3). The
+ * result is the same whatever order the streams are added in. The cost is
+ * one accumulate pass per stream plus one saturating pass, so mixing N
+ * talkers is bounded by N + 1 passes over the block; getStats() reports
+ * the cycles actually spent.
+ *
+ * Single-threaded: owned by the playback task; counters may be read elsewhere.
+ */
+class AudioMixer {
+public:
+    struct Stats {
+        uint32_t blocks;       // blocks with at least one stream
+        uint32_t streams;      // stream-blocks mixed (streams / blocks = average talkers)
+        uint8_t max_streams;   // most streams in one block
+        uint32_t avg_cycles;   // per block, smoothed over ~16 blocks
+        uint32_t max_cycles;   // worst block since boot
+    };
+
+    AudioMixer();
+
+    /**
+     * @brief Equal-power share of the output for each of @p streams talkers
+     * (unity / sqrt(streams)): two talkers at a normal level rarely clip.
+     */
+    static uint16_t shareGain(size_t streams);
+
+    /**
+     * @brief A stream's own gain (the listener's level for that talker,
+     * at most unity) applied on top of its share.
+     */
+    static uint16_t applyGain(uint16_t share_q15, uint16_t gain_q15);
+
+    /**
+     * @brief Begin a block of @p samples (at most AUDIO_MIX_MAX_BLOCK).
+     */
+    void start(size_t samples);
+
+    /**
+     * @brief Add one stream. Shorter streams leave the rest of the block silent.
+     */
+    void add(const int16_t *pcm, size_t samples, uint16_t from_q15, uint16_t to_q15);
+
+    /**
+     * @brief Write the saturated sum (start()'s length) to @p out.
+     * @return Number of streams mixed
+     */
+    size_t finish(int16_t *out);
+
+    Stats getStats() const;
+
+private:
+    int32_t acc[AUDIO_MIX_MAX_BLOCK];
+    size_t block;
+    uint8_t block_streams;
+    uint32_t block_cycles;
+
+    std::atomic<uint32_t> blocks;
+    std::atomic<uint32_t> streams;
+    std::atomic<uint32_t> max_streams;
+    std::atomic<uint32_t> avg_cycles;
+    std::atomic<uint32_t> max_cycles;
+};
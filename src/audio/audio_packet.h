@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include "audio/audio_frame.h"
+
+// Largest payload carried by one packet on the capture -> network path
+#define AUDIO_PACKET_MAX_BYTES 1024
+
+/**
+ * @brief What the network task should do with a queued packet.
+ *
+ * Talk markers travel in-band with the audio so "talk_start" is always sent
+ * before the first frame of a burst and "talk_stop" after the last one.
+ */
+enum AudioPacketKind : uint8_t {
+    AUDIO_PACKET_FRAME = 0,      // binary audio frame (data/len)
+    AUDIO_PACKET_TALK_START = 1, // control: {"type":"talk_start"}
+    AUDIO_PACKET_TALK_STOP = 2   // control: {"type":"talk_stop"}
+};
+
+// AudioPacket::flags of a talk_start marker: the burst's frames carry redundant
+// copies (audio/redundancy.h). Frame packets only use AudioFrameFlags there.
+#define AUDIO_PACKET_BURST_RED 0x80
+
+/**
+ * @brief One element of the capture -> network ring.
+ */
+struct AudioPacket {
+    uint32_t capture_us; // micros() when the I2S DMA completed the frame
+    uint16_t len;        // valid bytes in data
+    uint16_t seq;        // frame counter assigned at capture (ring overflows show up as gaps)
+    uint8_t kind;        // AudioPacketKind
+    uint8_t codec;       // AudioCodecId of data (talk_start: codec of the burst)
+    uint8_t flags;       // AudioFrameFlags to set in the wire header (latency probe)
+    uint32_t encoded_us; // micros() when encoding finished
+    uint16_t samples;    // playout duration of the primary frame (0: comfort noise descriptor)
+    // Wire header, filled in by the network task; directly followed by data so
+    // header + payload go out as one contiguous buffer
+    uint8_t header[AUDIO_FRAME_HEADER_BYTES];
+    uint8_t data[AUDIO_PACKET_MAX_BYTES];
+};
@@ -0,0 +1,276 @@
+#include "audio/capture_dsp.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "audio/cycle_count.h"
+
+static const float DC_CORNER_HZ = 10.0f;
+static const int HPF_Q_BITS = 28;
+// AGC: frames below -50 dBFS hold the gain; it may also cut loud talkers by up to 12 dB
+static const uint64_t AGC_GATE_ENERGY = 10737;
+static const uint32_t AGC_MIN_GAIN_Q16 = 16423;
+static const uint8_t AGC_MAX_GAIN_DB = 24;
+// Per block: half way down at once, 1/16 of the way up (about 0.25 s at 16 ms blocks)
+static const uint32_t AGC_ATTACK_SHIFT = 1;
+static const uint32_t AGC_RELEASE_SHIFT = 4;
+static const float LIMITER_RELEASE_S = 0.05f;
+static const int32_t UNITY_Q15 = 1 << 15;
+
+// Shift k for a one-pole smoother y += (x - y) >> k with the given time constant
+static uint8_t shift_for_time_constant(uint32_t sample_rate, float seconds) {
+    float k = log2f(sample_rate * seconds);
+    if (k < 1.0f) return 1;
+    if (k > 16.0f) return 16;
+    return (uint8_t)lrintf(k);
+}
+
+static inline int16_t sat16(int32_t v) {
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+CaptureDsp::CaptureDsp()
+    : cfg(), dc_q14(0), dc_shift(8), b0(0), b1(0), b2(0), a1(0), a2(0), x1(0), x2(0), y1(0), y2(0), hpf_err(0),
+      agc_target_energy(0), agc_max_gain_q16(65536), agc_gain_q16(65536), lookahead(1), lookahead_shift(0),
+      ceiling(INT16_MAX), env(0), limiter_release_shift(10), pos(0), gain_sum(0), max_head(0), max_count(0), last_peak(-1),
+      last_gain(UNITY_Q15), blocks(0), gain_snapshot(65536), limited_blocks(0) {
+    for (int s = 0; s < CAPTURE_DSP_STAGES; s++) {
+        avg_cycles[s].store(0, std::memory_order_relaxed);
+        max_cycles[s].store(0, std::memory_order_relaxed);
+    }
+}
+
+void CaptureDsp::begin(const Config &config, uint32_t sample_rate) {
+    cfg = config;
+
+    dc_q14 = 0;
+    dc_shift = shift_for_time_constant(sample_rate, 1.0f / (2.0f * (float)M_PI * DC_CORNER_HZ));
+
+    // RBJ cookbook high-pass, Q = 1/sqrt(2) (Butterworth); computed once, in double
+    x1 = x2 = y1 = y2 = 0;
+    hpf_err = 0;
+    if (cfg.hpf_hz > 0 && cfg.hpf_hz * 2 < sample_rate) {
+        double w0 = 2.0 * M_PI * cfg.hpf_hz / sample_rate;
+        double alpha = sin(w0) / (2.0 * M_SQRT1_2);
+        double a0 = 1.0 + alpha;
+        double scale = (double)(1 << HPF_Q_BITS) / a0;
+        b0 = (int32_t)llround((1.0 + cos(w0)) / 2.0 * scale);
+        b1 = (int32_t)llround(-(1.0 + cos(w0)) * scale);
+        b2 = b0;
+        a1 = (int32_t)llround(-2.0 * cos(w0) * scale);
+        a2 = (int32_t)llround((1.0 - alpha) * scale);
+    } else {
+        cfg.hpf_hz = 0;
+    }
+
+    // Energies relative to a full-scale square wave (2^30), like dBov elsewhere
+    if (cfg.agc_target_dbfs > 0) cfg.agc_target_dbfs = 0;
+    agc_target_energy = (uint64_t)(1073741824.0 * pow(10.0, cfg.agc_target_dbfs / 10.0));
+    uint8_t max_db = cfg.agc_max_gain_db < AGC_MAX_GAIN_DB ? cfg.agc_max_gain_db : AGC_MAX_GAIN_DB;
+    agc_max_gain_q16 = (uint32_t)lrint(65536.0 * pow(10.0, max_db / 20.0));
+    agc_gain_q16 = 65536;
+    gain_snapshot.store(agc_gain_q16, std::memory_order_relaxed);
+
+    size_t want = (size_t)sample_rate * cfg.lookahead_ms / 1000;
+    lookahead = 1;
+    lookahead_shift = 0;
+    while (lookahead * 2 <= want && lookahead * 2 <= CAPTURE_DSP_MAX_LOOKAHEAD) {
+        lookahead *= 2;
+        lookahead_shift++;
+    }
+    if (cfg.limiter_ceiling_dbfs > 0) cfg.limiter_ceiling_dbfs = 0;
+    double c = 32768.0 * pow(10.0, cfg.limiter_ceiling_dbfs / 20.0);
+    ceiling = c >= INT16_MAX ? INT16_MAX : (int32_t)c;
+    env = 0;
+    pos = 0;
+    memset(delay, 0, sizeof(delay));
+    for (size_t i = 0; i < CAPTURE_DSP_MAX_LOOKAHEAD; i++) gains[i] = UNITY_Q15;
+    gain_sum = (int32_t)lookahead * UNITY_Q15;
+    max_head = 0;
+    max_count = 0;
+    last_peak = -1;
+    last_gain = UNITY_Q15;
+    limiter_release_shift = shift_for_time_constant(sample_rate, LIMITER_RELEASE_S);
+}
+
+void CaptureDsp::process(int16_t *pcm, size_t samples) {
+    uint32_t cost[CAPTURE_DSP_STAGES] = {0, 0, 0, 0};
+    bool limited = false;
+
+    while (samples > 0) {
+        size_t n = samples < CAPTURE_DSP_MAX_BLOCK ? samples : CAPTURE_DSP_MAX_BLOCK;
+        uint32_t t0 = audio_cycles_now();
+        if (cfg.dc_block) dcBlock(pcm, n);
+        uint32_t t1 = audio_cycles_now();
+        if (cfg.hpf_hz) highPass(pcm, n);
+        uint32_t t2 = audio_cycles_now();
+        uint32_t t3 = t2;
+        uint32_t t4 = t2;
+        if (cfg.agc || cfg.limiter) {
+            agc(pcm, n);
+            t3 = audio_cycles_now();
+            limited |= limit(pcm, n);
+            t4 = audio_cycles_now();
+        }
+        cost[CAPTURE_DSP_DC] += t1 - t0;
+        cost[CAPTURE_DSP_HPF] += t2 - t1;
+        cost[CAPTURE_DSP_AGC] += t3 - t2;
+        cost[CAPTURE_DSP_LIMITER] += t4 - t3;
+        pcm += n;
+        samples -= n;
+    }
+
+    for (int s = 0; s < CAPTURE_DSP_STAGES; s++) {
+        uint32_t avg = avg_cycles[s].load(std::memory_order_relaxed);
+        avg = (uint32_t)((int32_t)avg + (((int32_t)cost[s] - (int32_t)avg) >> 4));
+        avg_cycles[s].store(avg, std::memory_order_relaxed);
+        if (cost[s] > max_cycles[s].load(std::memory_order_relaxed)) {
+            max_cycles[s].store(cost[s], std::memory_order_relaxed);
+        }
+    }
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    if (limited) limited_blocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CaptureDsp::dcBlock(int16_t *pcm, size_t n) {
+    // Mean tracked in Q14, so the update never overflows 32 bits
+    int32_t dc = dc_q14;
+    const uint8_t k = dc_shift;
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = pcm[i];
+        dc += (x * (1 << 14) - dc) >> k;
+        pcm[i] = sat16(x - ((dc + (1 << 13)) >> 14));
+    }
+    dc_q14 = dc;
+}
+
+void CaptureDsp::highPass(int16_t *pcm, size_t n) {
+    int32_t xm1 = x1, xm2 = x2, ym1 = y1, ym2 = y2;
+    int64_t err = hpf_err;
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = pcm[i];
+        // The fraction dropped from the last output goes into this one (first-order noise shaping)
+        int64_t acc = (int64_t)b0 * x + (int64_t)b1 * xm1 + (int64_t)b2 * xm2 - (int64_t)a1 * ym1 -
+                      (int64_t)a2 * ym2 + err;
+        int32_t y = (int32_t)(acc >> HPF_Q_BITS);
+        err = acc - ((int64_t)y << HPF_Q_BITS);
+        xm2 = xm1;
+        xm1 = x;
+        ym2 = ym1;
+        ym1 = y;
+        pcm[i] = sat16(y);
+    }
+    x1 = xm1;
+    x2 = xm2;
+    y1 = ym1;
+    y2 = ym2;
+    hpf_err = err;
+}
+
+void CaptureDsp::agc(const int16_t *pcm, size_t n) {
+    if (!cfg.agc) {
+        for (size_t i = 0; i < n; i++) work[i] = pcm[i];
+        return;
+    }
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += (uint32_t)((int32_t)pcm[i] * pcm[i]);
+    uint64_t energy = sum / n;
+
+    uint32_t g0 = agc_gain_q16;
+    uint32_t g1 = g0;
+    if (energy >= AGC_GATE_ENERGY) {
+        // sqrt(target / energy) in Q16
+        uint32_t want = isqrt64((agc_target_energy << 32) / energy);
+        if (want > agc_max_gain_q16) want = agc_max_gain_q16;
+        if (want < AGC_MIN_GAIN_Q16) want = AGC_MIN_GAIN_Q16;
+        if (want < g0) g1 = g0 - ((g0 - want) >> AGC_ATTACK_SHIFT);
+        else g1 = g0 + ((want - g0) >> AGC_RELEASE_SHIFT);
+    }
+
+    // Ramp across the block so gain changes do not click; Q10 keeps x * g within 32 bits at +24 dB
+    int32_t g = (int32_t)g0;
+    int32_t step = ((int32_t)g1 - (int32_t)g0) / (int32_t)n;
+    for (size_t i = 0; i < n; i++) {
+        g += step;
+        work[i] = ((int32_t)pcm[i] * (g >> 6)) >> 10;
+    }
+    agc_gain_q16 = g1;
+    gain_snapshot.store(g1, std::memory_order_relaxed);
+}
+
+bool CaptureDsp::limit(int16_t *pcm, size_t n) {
+    if (!cfg.limiter) {
+        for (size_t i = 0; i < n; i++) pcm[i] = sat16(work[i]);
+        return false;
+    }
+
+    const size_t mask = lookahead - 1;
+    bool limited = false;
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = work[i];
+        int32_t a = x < 0 ? -x : x;
+        env -= env >> limiter_release_shift;
+        if (a > env) env = a;
+
+        // Sliding maximum of the envelope over the last `lookahead` samples
+        if (max_count && pos - max_pos[max_head] >= lookahead) {
+            max_head = (max_head + 1) & mask;
+            max_count--;
+        }
+        while (max_count && max_val[(max_head + max_count - 1) & mask] <= env) max_count--;
+        size_t back = (max_head + max_count) & mask;
+        max_pos[back] = pos;
+        max_val[back] = env;
+        max_count++;
+
+        int32_t peak = max_val[max_head];
+        if (peak != last_peak) {
+            last_peak = peak;
+            last_gain = peak > ceiling ? (int32_t)(((uint32_t)ceiling << 15) / (uint32_t)peak) : UNITY_Q15;
+        }
+
+        // Boxcar over the window: the gain reaches every peak's own limit by the time it comes out
+        size_t slot = pos & mask;
+        gain_sum += last_gain - gains[slot];
+        gains[slot] = last_gain;
+        int32_t gain = gain_sum >> lookahead_shift;
+        if (gain < UNITY_Q15) limited = true;
+
+        delay[slot] = x;
+        // The sample from lookahead - 1 ago; |out| * gain <= ceiling << 15, so 32 bits suffice
+        int32_t out = delay[(pos + 1) & mask];
+        pcm[i] = sat16((out * gain) >> 15);
+        pos++;
+    }
+    return limited;
+}
+
+CaptureDsp::Stats CaptureDsp::getStats() const {
+    Stats st;
+    st.blocks = blocks.load(std::memory_order_relaxed);
+    for (int s = 0; s < CAPTURE_DSP_STAGES; s++) {
+        st.avg_cycles[s] = avg_cycles[s].load(std::memory_order_relaxed);
+        st.max_cycles[s] = max_cycles[s].load(std::memory_order_relaxed);
+    }
+    uint32_t g = gain_snapshot.load(std::memory_order_relaxed);
+    st.agc_gain_db = (int8_t)lrintf(20.0f * log10f((float)g / 65536.0f));
+    st.limited_blocks = limited_blocks.load(std::memory_order_relaxed);
+    return st;
+}
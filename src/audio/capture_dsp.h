@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest block processed in one pass; longer blocks are split
+#define CAPTURE_DSP_MAX_BLOCK 256
+#define CAPTURE_DSP_MAX_LOOKAHEAD 64
+
+enum CaptureDspStage {
+    CAPTURE_DSP_DC = 0,
+    CAPTURE_DSP_HPF,
+    CAPTURE_DSP_AGC,
+    CAPTURE_DSP_LIMITER,
+    CAPTURE_DSP_STAGES
+};
+
+/**
+ * @brief Microphone clean-up before the VAD and the encoder, in fixed point.
+ *
+ * Four stages, each optional, run in place on every captured block:
+ *   - DC blocker: subtracts a slowly tracked mean (about 10 Hz, shifts only);
+ *   - high-pass: 2nd order Butterworth biquad (Q28 coefficients, 64-bit
+ *     accumulator with error feedback) against handling noise and rumble;
+ *   - AGC: one gain per block toward a target RMS level, fast down and slow
+ *     up, ramped across the block; quiet frames hold the gain, so room
+ *     noise is not pumped up between words;
+ *   - look-ahead limiter: a peak envelope, a sliding maximum over the
+ *     look-ahead window and a boxcar-smoothed gain, so no output sample
+ *     exceeds the ceiling and the gain is already down when a peak arrives.
+ *     Delays the audio by latencySamples().
+ *
+ * Works out of fixed buffers (no allocation after construction) and times
+ * each stage with the CPU cycle counter; getStats() reports the per-stage
+ * cost per block. On the host the counter is the TSC instead.
+ *
+ * Single-threaded: owned by the capture task; counters may be read elsewhere.
+ */
+class CaptureDsp {
+public:
+    struct Config {
+        bool dc_block;
+        uint16_t hpf_hz;              // high-pass corner, 0 = off
+        bool agc;
+        int8_t agc_target_dbfs;       // RMS level the AGC aims for
+        uint8_t agc_max_gain_db;      // 0..24
+        bool limiter;
+        int8_t limiter_ceiling_dbfs;  // peak level never exceeded
+        uint8_t lookahead_ms;         // rounded down to a power of two in samples
+    };
+
+    struct Stats {
+        uint32_t blocks;
+        uint32_t avg_cycles[CAPTURE_DSP_STAGES]; // per block, smoothed over ~16 blocks
+        uint32_t max_cycles[CAPTURE_DSP_STAGES]; // worst block since boot
+        int8_t agc_gain_db;
+        uint32_t limited_blocks;                 // blocks where the limiter reduced the gain
+    };
+
+    CaptureDsp();
+
+    /**
+     * @brief Apply a configuration and clear all filter state.
+     */
+    void begin(const Config &config, uint32_t sample_rate);
+
+    void process(int16_t *pcm, size_t samples);
+
+    /**
+     * @brief Audio delay added by the limiter's look-ahead.
+     */
+    size_t latencySamples() const { return cfg.limiter ? lookahead - 1 : 0; }
+
+    Stats getStats() const;
+
+private:
+    void dcBlock(int16_t *pcm, size_t n);
+    void highPass(int16_t *pcm, size_t n);
+    void agc(const int16_t *pcm, size_t n);
+    bool limit(int16_t *pcm, size_t n);
+
+    Config cfg;
+
+    // DC blocker: running mean in Q14
+    int32_t dc_q14;
+    uint8_t dc_shift;
+
+    // Biquad (direct form I), Q28 coefficients
+    int32_t b0, b1, b2, a1, a2;
+    int32_t x1, x2, y1, y2;
+    int64_t hpf_err; // low bits dropped from the last output (error feedback)
+
+    // AGC
+    uint64_t agc_target_energy;
+    uint32_t agc_max_gain_q16;
+    uint32_t agc_gain_q16;
+
+    // Limiter
+    size_t lookahead;          // power of two
+    uint8_t lookahead_shift;
+    int32_t ceiling;
+    int32_t env;               // peak envelope
+    uint8_t limiter_release_shift;
+    uint32_t pos;              // samples seen (ring index)
+    int32_t delay[CAPTURE_DSP_MAX_LOOKAHEAD];
+    int32_t gains[CAPTURE_DSP_MAX_LOOKAHEAD]; // Q15, boxcar history
+    int32_t gain_sum;
+    // Sliding maximum of the envelope: a deque of (position, value), values decreasing
+    uint32_t max_pos[CAPTURE_DSP_MAX_LOOKAHEAD];
+    int32_t max_val[CAPTURE_DSP_MAX_LOOKAHEAD];
+    size_t max_head, max_count;
+    int32_t last_peak;         // gain cache: the window maximum often stays put
+    int32_t last_gain;
+
+    int32_t work[CAPTURE_DSP_MAX_BLOCK]; // AGC output: unsaturated, for the limiter
+
+    std::atomic<uint32_t> blocks;
+    std::atomic<uint32_t> avg_cycles[CAPTURE_DSP_STAGES];
+    std::atomic<uint32_t> max_cycles[CAPTURE_DSP_STAGES];
+    std::atomic<uint32_t> gain_snapshot;
+    std::atomic<uint32_t> limited_blocks;
+};
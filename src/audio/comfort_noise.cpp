@@ -0,0 +1,129 @@
+#include "audio/comfort_noise.h"
+#include "audio/vad.h"
+
+#include <math.h>
+
+// SID refresh while a pause lasts (also the receiver's evidence the talker is still there)
+static const uint32_t SID_INTERVAL_MS = 400;
+// A level change larger than this sends a SID before the interval is up
+static const int LEVEL_STEP_DB = 3;
+// Smoothing of the background estimate over a pause (per frame)
+static const float AVERAGE_GAIN = 0.25f;
+// Keeps the synthesis filter clearly stable
+static const float MAX_K1 = 0.95f;
+
+static float clamp_k1(float k) {
+    if (k > MAX_K1) return MAX_K1;
+    if (k < -MAX_K1) return -MAX_K1;
+    return k;
+}
+
+size_t cn_write_sid(const ComfortNoiseParams &p, uint8_t *out) {
+    out[0] = p.level_dbov > 127 ? 127 : p.level_dbov;
+    out[1] = (uint8_t)lrintf((clamp_k1(p.k1) + 1.0f) * 127.0f);
+    return CN_SID_BYTES;
+}
+
+bool cn_parse_sid(const uint8_t *data, size_t len, ComfortNoiseParams *p) {
+    if (len < 1) return false;
+    p->level_dbov = data[0] & 0x7F;
+    // Level-only descriptors (RFC 3389 allows them) mean white noise
+    p->k1 = len >= CN_SID_BYTES ? clamp_k1(data[1] / 127.0f - 1.0f) : 0.0f;
+    return true;
+}
+
+ComfortNoiseEncoder::ComfortNoiseEncoder()
+    : interval_samples(0), since_sid(0), in_pause(false), sent_level(127), r0(0.0f), r1(0.0f) {
+}
+
+void ComfortNoiseEncoder::begin(uint32_t sample_rate) {
+    interval_samples = (size_t)sample_rate * SID_INTERVAL_MS / 1000;
+    reset();
+}
+
+void ComfortNoiseEncoder::reset() {
+    in_pause = false;
+    since_sid = 0;
+}
+
+bool ComfortNoiseEncoder::silentFrame(const int16_t *pcm, size_t samples, ComfortNoiseParams *sid) {
+    if (samples < 2) return false;
+    float e0 = 0.0f, e1 = 0.0f;
+    for (size_t i = 1; i < samples; i++) {
+        float x = pcm[i];
+        e0 += x * x;
+        e1 += x * (float)pcm[i - 1];
+    }
+    e0 /= (float)(samples - 1);
+    e1 /= (float)(samples - 1);
+
+    bool first = !in_pause;
+    if (first) {
+        r0 = e0;
+        r1 = e1;
+        in_pause = true;
+    } else {
+        r0 += AVERAGE_GAIN * (e0 - r0);
+        r1 += AVERAGE_GAIN * (e1 - r1);
+    }
+    since_sid += samples;
+
+    uint8_t level = vad_energy_to_dbov(r0 >= 4294967295.0f ? UINT32_MAX : (uint32_t)r0);
+    int step = (int)level - (int)sent_level;
+    if (!first && since_sid < interval_samples && step <= LEVEL_STEP_DB && step >= -LEVEL_STEP_DB) return false;
+
+    sid->level_dbov = level;
+    sid->k1 = r0 > 0.0f ? clamp_k1(r1 / r0) : 0.0f;
+    sent_level = level;
+    since_sid = 0;
+    return true;
+}
+
+ComfortNoiseGenerator::ComfortNoiseGenerator()
+    : params(127 << 8 | 127), pending(false), seed(0x1234567u), gain(0.0f), state(0.0f), sids(0),
+      generated_frames(0) {
+}
+
+void ComfortNoiseGenerator::update(const ComfortNoiseParams &p) {
+    uint8_t sid[CN_SID_BYTES];
+    cn_write_sid(p, sid);
+    params.store((uint16_t)(sid[0] << 8 | sid[1]), std::memory_order_relaxed);
+    pending.store(true, std::memory_order_relaxed);
+    sids.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ComfortNoiseGenerator::generate(int16_t *out, size_t samples) {
+    uint16_t packed = params.load(std::memory_order_relaxed);
+    uint8_t sid[CN_SID_BYTES] = {(uint8_t)(packed >> 8), (uint8_t)packed};
+    ComfortNoiseParams p;
+    cn_parse_sid(sid, sizeof(sid), &p);
+
+    // One-pole synthesis y = g*x + k1*y[-1] of uniform x in [-1, 1) (variance 1/3):
+    // g = rms * sqrt(3 * (1 - k1^2)) gives the SID's rms
+    float rms = p.level_dbov >= 127 ? 0.0f : 32768.0f * powf(10.0f, -(float)p.level_dbov / 20.0f);
+    float target = rms * sqrtf(3.0f * (1.0f - p.k1 * p.k1));
+    float step = samples ? (target - gain) / (float)samples : 0.0f;
+
+    for (size_t i = 0; i < samples; i++) {
+        // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        float x = (float)(int32_t)seed * (1.0f / 2147483648.0f);
+        gain += step;
+        state = gain * x + p.k1 * state;
+        float y = state;
+        if (y > 32767.0f) y = 32767.0f;
+        if (y < -32768.0f) y = -32768.0f;
+        out[i] = (int16_t)y;
+    }
+    gain = target;
+    generated_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+ComfortNoiseGenerator::Stats ComfortNoiseGenerator::getStats() const {
+    Stats st;
+    st.sids = sids.load(std::memory_order_relaxed);
+    st.generated_frames = generated_frames.load(std::memory_order_relaxed);
+    return st;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Comfort noise for discontinuous transmission (DTX). While the talker's
+ * VAD reports silence, no audio frames are sent; a silence descriptor
+ * (SID) goes out at the start of the pause and then every few hundred ms.
+ * It is a frame of its own codec id (AUDIO_FRAME_CODEC_CN, audio_frame.h)
+ * and keeps its sequence number, so receivers see no gap. Listeners play
+ * noise shaped like the talker's background until speech resumes, instead
+ * of dead silence.
+ *
+ * SID payload (after RFC 3389):
+ *   byte 0  noise level in -dBov (0..127)
+ *   byte 1  first reflection coefficient k1, as round((k1 + 1) * 127)
+ */
+#define CN_SID_BYTES 2
+
+struct ComfortNoiseParams {
+    uint8_t level_dbov; // 127: silence
+    float k1;           // spectral tilt, -1 (bright) .. 1 (dark)
+};
+
+/**
+ * @brief Serialize a SID payload (CN_SID_BYTES bytes).
+ */
+size_t cn_write_sid(const ComfortNoiseParams &p, uint8_t *out);
+
+/**
+ * @brief Parse a SID payload. Extra bytes (higher-order coefficients) are ignored.
+ * @return false if too short
+ */
+bool cn_parse_sid(const uint8_t *data, size_t len, ComfortNoiseParams *p);
+
+/**
+ * @brief Sender side: averages the background over a pause and decides
+ * when the next SID is due.
+ *
+ * Single-threaded: owned by the capture task.
+ */
+class ComfortNoiseEncoder {
+public:
+    ComfortNoiseEncoder();
+
+    void begin(uint32_t sample_rate);
+
+    /**
+     * @brief Speech resumed: the next silent frame sends a SID at once.
+     */
+    void reset();
+
+    /**
+     * @brief Account one silent frame.
+     * @param sid Receives the descriptor when one is due
+     * @return true if a SID should be sent now (start of a pause, every
+     *         SID interval, or when the level moved by more than 3 dB)
+     */
+    bool silentFrame(const int16_t *pcm, size_t samples, ComfortNoiseParams *sid);
+
+private:
+    size_t interval_samples;
+    size_t since_sid;   // samples since the last SID (0 = none sent in this pause)
+    bool in_pause;
+    uint8_t sent_level;
+    // Running averages over the pause (autocorrelation at lags 0 and 1)
+    float r0;
+    float r1;
+};
+
+/**
+ * @brief Receiver side: synthesizes comfort noise from SIDs.
+ *
+ * White noise through a one-pole filter set by k1, scaled to the SID level.
+ * The gain glides between descriptors so level updates are not audible as
+ * steps. update()/stop() come from the receive path; generate() runs in
+ * the playback task.
+ */
+class ComfortNoiseGenerator {
+public:
+    struct Stats {
+        uint32_t sids;             // descriptors received
+        uint32_t generated_frames; // frames of comfort noise played
+    };
+
+    ComfortNoiseGenerator();
+
+    /**
+     * @brief A SID arrived: the talker is in a pause with this background.
+     */
+    void update(const ComfortNoiseParams &p);
+
+    /**
+     * @brief Speech (or the end of the burst) arrived: no pause pending.
+     */
+    void stop() { pending.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether the talker announced a pause that has not ended yet.
+     */
+    bool active() const { return pending.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Fill @p out with @p samples of comfort noise.
+     */
+    void generate(int16_t *out, size_t samples);
+
+    Stats getStats() const;
+
+private:
+    std::atomic<uint16_t> params; // level << 8 | k1 byte, from the latest SID
+    std::atomic<bool> pending;
+
+    // Playback task state
+    uint32_t seed;
+    float gain;
+    float state;
+
+    std::atomic<uint32_t> sids;
+    std::atomic<uint32_t> generated_frames;
+};
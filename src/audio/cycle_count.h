@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_cpu.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Free-running cycle counter for cost measurements: CCOUNT on the
+ * ESP32-S3, the TSC on x86 hosts, a nanosecond clock elsewhere. Wraps, so
+ * only differences of nearby readings mean anything.
+ */
+static inline uint32_t audio_cycles_now() {
+#if defined(ESP_PLATFORM)
+    return (uint32_t)esp_cpu_get_cycle_count();
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return (uint32_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
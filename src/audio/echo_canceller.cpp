@@ -0,0 +1,257 @@
+#include "audio/echo_canceller.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "audio/cycle_count.h"
+
+// Background weights are Q28 (+-8); the foreground keeps their upper half, Q12
+static const int FOREGROUND_SHIFT = 16;
+static const int FOREGROUND_Q = 12;
+// NLMS step size 1/2
+static const int STEP_MU_SHIFT = 1;
+// References quieter than about -54 dBFS do not adapt (and set the regularization);
+// below about -78 dBFS their echo is under the microphone's own noise and is not filtered
+static const uint32_t FAR_FLOOR_RMS = 64;
+static const uint32_t SILENT_RMS = 4;
+// Foreground takes the background after two better blocks; the background
+// is reset after three far worse ones
+static const uint8_t TAKEOVER_BLOCKS = 2;
+static const uint8_t RESET_BLOCKS = 3;
+static const int32_t UNITY_Q15 = 1 << 15;
+
+static inline int16_t sat16(int32_t v) {
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+static inline int bit_length(uint64_t v) {
+    return v ? 64 - __builtin_clzll(v) : 0;
+}
+
+// Foreground echo estimate, Q12
+static int64_t fir_q12(const int16_t *w, const int16_t *x, size_t taps) {
+    int64_t acc = 0;
+    for (size_t k = 0; k < taps; k += 4) {
+        acc += (int32_t)w[k] * x[k];
+        acc += (int32_t)w[k + 1] * x[k + 1];
+        acc += (int32_t)w[k + 2] * x[k + 2];
+        acc += (int32_t)w[k + 3] * x[k + 3];
+    }
+    return acc;
+}
+
+// Background echo estimate from the upper half of the weights, Q12
+static int64_t fir_q28(const int32_t *w, const int16_t *x, size_t taps) {
+    int64_t acc = 0;
+    for (size_t k = 0; k < taps; k += 4) {
+        acc += (w[k] >> FOREGROUND_SHIFT) * x[k];
+        acc += (w[k + 1] >> FOREGROUND_SHIFT) * x[k + 1];
+        acc += (w[k + 2] >> FOREGROUND_SHIFT) * x[k + 2];
+        acc += (w[k + 3] >> FOREGROUND_SHIFT) * x[k + 3];
+    }
+    return acc;
+}
+
+// The previous sample's NLMS update (its window is x + 1) fused with this sample's estimate
+static int64_t update_fir_q28(int32_t *w, const int16_t *x, size_t taps, int16_t step, uint8_t shift) {
+    int64_t acc = 0;
+    for (size_t k = 0; k < taps; k += 4) {
+        w[k] += ((int32_t)step * x[k + 1]) >> shift;
+        w[k + 1] += ((int32_t)step * x[k + 2]) >> shift;
+        w[k + 2] += ((int32_t)step * x[k + 3]) >> shift;
+        w[k + 3] += ((int32_t)step * x[k + 4]) >> shift;
+        acc += (w[k] >> FOREGROUND_SHIFT) * x[k];
+        acc += (w[k + 1] >> FOREGROUND_SHIFT) * x[k + 1];
+        acc += (w[k + 2] >> FOREGROUND_SHIFT) * x[k + 2];
+        acc += (w[k + 3] >> FOREGROUND_SHIFT) * x[k + 3];
+    }
+    return acc;
+}
+
+/*
+ * mu * err / den in Q28 as step * 2^-shift, with one 32-bit division: both
+ * operands are normalized to 15 and 16 significant bits first, so the step
+ * keeps 14-15 bits whatever the levels. Steps too large to represent are
+ * clamped (slower, never unstable); negligible ones become 0.
+ */
+static void nlms_step(int32_t err, uint64_t den, int16_t *step, uint8_t *shift) {
+    *step = 0;
+    if (err == 0) return;
+    uint32_t num = (uint32_t)(err < 0 ? -err : err);
+    if (num > INT16_MAX) num = INT16_MAX;
+    int nb = bit_length(num);
+    int db = bit_length(den);
+    uint32_t num_top = num << (15 - nb);
+    uint32_t den_top = (uint32_t)(den >> (db - 16));
+    int32_t q = (int32_t)((num_top << 15) / den_top);
+    // num = num_top * 2^(nb - 15), den ~ den_top * 2^(db - 16): the step is q * 2^(nb - db + 14 - mu)
+    int sh = db - nb - 14 + STEP_MU_SHIFT;
+    if (sh > 31) return;
+    if (sh < 0) {
+        q = INT16_MAX;
+        sh = 0;
+    }
+    *step = (int16_t)(err < 0 ? -q : q);
+    *shift = (uint8_t)sh;
+}
+
+EchoCanceller::EchoCanceller()
+    : cfg(), taps(8), period(9), pos(0), energy(0), delta(0), step(0), step_shift(0), better_blocks(0),
+      worse_blocks(0), suppress_q15(UNITY_Q15), gain_q15(UNITY_Q15), erle_mic(0), erle_out(0), blocks(0),
+      avg_cycles(0), max_cycles(0), erle_snapshot(256), double_talk_blocks(0), copies(0), resets(0) {
+    memset(background, 0, sizeof(background));
+    memset(foreground, 0, sizeof(foreground));
+    memset(hist, 0, sizeof(hist));
+}
+
+void EchoCanceller::begin(const Config &config, uint32_t sample_rate) {
+    cfg = config;
+    taps = ((size_t)cfg.tail_ms * sample_rate / 1000 + 7) & ~(size_t)7;
+    if (taps < 8) taps = 8;
+    if (taps > ECHO_CANCELLER_MAX_TAPS) taps = ECHO_CANCELLER_MAX_TAPS;
+    period = taps + 1;
+    pos = 0;
+    energy = 0;
+    delta = (uint64_t)taps * FAR_FLOOR_RMS * FAR_FLOOR_RMS;
+    step = 0;
+    step_shift = 0;
+    memset(background, 0, sizeof(background));
+    memset(foreground, 0, sizeof(foreground));
+    memset(hist, 0, sizeof(hist));
+    better_blocks = 0;
+    worse_blocks = 0;
+    suppress_q15 = cfg.suppress_db ? (int32_t)lrintf(UNITY_Q15 * powf(10.0f, -cfg.suppress_db / 20.0f)) : UNITY_Q15;
+    gain_q15 = UNITY_Q15;
+    erle_mic = 0;
+    erle_out = 0;
+    erle_snapshot.store(256, std::memory_order_relaxed);
+}
+
+void EchoCanceller::process(int16_t *mic, const int16_t *ref, size_t samples) {
+    uint32_t t0 = audio_cycles_now();
+    bool far = false;
+    while (samples > 0) {
+        size_t n = samples < ECHO_CANCELLER_MAX_BLOCK ? samples : ECHO_CANCELLER_MAX_BLOCK;
+        far |= processBlock(mic, ref, n);
+        mic += n;
+        ref += n;
+        samples -= n;
+    }
+    uint32_t cost = audio_cycles_now() - t0;
+
+    // Blocks without a reference cost next to nothing and would only dilute the average
+    if (!far) return;
+    uint32_t avg = avg_cycles.load(std::memory_order_relaxed);
+    avg_cycles.store((uint32_t)((int32_t)avg + (((int32_t)cost - (int32_t)avg) >> 4)), std::memory_order_relaxed);
+    if (cost > max_cycles.load(std::memory_order_relaxed)) max_cycles.store(cost, std::memory_order_relaxed);
+    blocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool EchoCanceller::processBlock(int16_t *mic, const int16_t *ref, size_t n) {
+    const uint64_t silent = (uint64_t)taps * SILENT_RMS * SILENT_RMS;
+    uint64_t e_mic = 0;
+    uint64_t e_fg = 0;
+    uint64_t e_bg = 0;
+    uint64_t e_echo = 0;
+    size_t adapted = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        // Newest reference sample in front; the one leaving the window is still right behind it
+        pos = pos ? pos - 1 : period - 1;
+        int32_t x = ref[i];
+        hist[pos] = (int16_t)x;
+        hist[pos + period] = (int16_t)x;
+        int32_t old = hist[pos + taps];
+        energy = energy + (uint64_t)(x * x) - (uint64_t)(old * old);
+
+        int32_t d = mic[i];
+        e_mic += (uint64_t)((int64_t)d * d);
+        if (energy < silent) {
+            step = 0;
+            e_fg += (uint64_t)((int64_t)d * d);
+            e_bg += (uint64_t)((int64_t)d * d);
+            continue;
+        }
+
+        const int16_t *w = hist + pos;
+        int64_t y_bg = step ? update_fir_q28(background, w, taps, step, step_shift) : fir_q28(background, w, taps);
+        int32_t echo = (int32_t)(fir_q12(foreground, w, taps) >> FOREGROUND_Q);
+        int32_t err_bg = d - (int32_t)(y_bg >> FOREGROUND_Q);
+        int32_t err_fg = d - echo;
+        mic[i] = sat16(err_fg);
+
+        // Applied with the next sample, on this sample's window
+        step = 0;
+        if (energy >= delta) {
+            nlms_step(err_bg, energy + delta, &step, &step_shift);
+            adapted++;
+        }
+        e_fg += (uint64_t)((int64_t)err_fg * err_fg);
+        e_bg += (uint64_t)((int64_t)err_bg * err_bg);
+        e_echo += (uint64_t)((int64_t)echo * echo);
+    }
+
+    bool far = adapted * 2 >= n;
+    if (far) {
+        if (e_bg < e_fg - (e_fg >> 3) && e_bg < (e_mic >> 3)) {
+            if (++better_blocks >= TAKEOVER_BLOCKS) {
+                for (size_t k = 0; k < taps; k++) foreground[k] = sat16(background[k] >> FOREGROUND_SHIFT);
+                better_blocks = 0;
+                copies.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            better_blocks = 0;
+        }
+        if (e_bg > 4 * e_fg) {
+            // Lost (most likely adapted on the near end): start again from the foreground
+            if (++worse_blocks >= RESET_BLOCKS) {
+                for (size_t k = 0; k < taps; k++) background[k] = (int32_t)foreground[k] << FOREGROUND_SHIFT;
+                step = 0;
+                worse_blocks = 0;
+                resets.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            worse_blocks = 0;
+        }
+    } else {
+        better_blocks = 0;
+        worse_blocks = 0;
+    }
+
+    // More left over than the filter takes out: the near end is talking, leave it alone
+    bool double_talk = far && e_fg > e_echo;
+    if (far && !double_talk) {
+        erle_mic = erle_mic - (erle_mic >> 2) + (e_mic >> 2);
+        erle_out = erle_out - (erle_out >> 2) + (e_fg >> 2);
+        uint64_t ratio = erle_out ? (erle_mic << 8) / erle_out : 256;
+        erle_snapshot.store(ratio > UINT32_MAX ? UINT32_MAX : (uint32_t)ratio, std::memory_order_relaxed);
+    }
+    if (double_talk) double_talk_blocks.fetch_add(1, std::memory_order_relaxed);
+
+    // Residual echo suppression, ramped from the last block's gain (Q15 << 8 keeps the step's fraction)
+    int32_t target = (far && !double_talk) ? suppress_q15 : UNITY_Q15;
+    if (target != UNITY_Q15 || gain_q15 != UNITY_Q15) {
+        int32_t g = gain_q15 << 8;
+        int32_t inc = ((target - gain_q15) << 8) / (int32_t)n;
+        for (size_t i = 0; i < n; i++) {
+            g += inc;
+            mic[i] = (int16_t)((mic[i] * (g >> 8)) >> 15);
+        }
+        gain_q15 = target;
+    }
+    return far;
+}
+
+EchoCanceller::Stats EchoCanceller::getStats() const {
+    Stats st;
+    st.taps = (uint16_t)taps;
+    st.blocks = blocks.load(std::memory_order_relaxed);
+    st.avg_cycles = avg_cycles.load(std::memory_order_relaxed);
+    st.max_cycles = max_cycles.load(std::memory_order_relaxed);
+    uint32_t ratio = erle_snapshot.load(std::memory_order_relaxed);
+    st.erle_db = (int8_t)lrintf(10.0f * log10f(ratio ? (float)ratio / 256.0f : 1.0f / 256.0f));
+    st.double_talk_blocks = double_talk_blocks.load(std::memory_order_relaxed);
+    st.copies = copies.load(std::memory_order_relaxed);
+    st.resets = resets.load(std::memory_order_relaxed);
+    return st;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest echo path the filter can cover: 32 ms at 16 kHz
+#define ECHO_CANCELLER_MAX_TAPS 512
+// Largest block processed in one pass; longer blocks are split
+#define ECHO_CANCELLER_MAX_BLOCK 256
+
+/**
+ * @brief Acoustic echo canceller for full-duplex operation, in fixed point.
+ *
+ * Removes what the speaker adds to the microphone, given the speaker
+ * signal as a reference already aligned to the capture (EchoReference).
+ * Two FIR filters model the echo path (two-path structure, as in speexdsp's
+ * MDF):
+ *   - background: NLMS, adapting on every sample while the far end talks.
+ *     The weight update and the next sample's filtering share one pass over
+ *     the taps (the update lags by a sample), so each tap is loaded and
+ *     stored once per sample;
+ *   - foreground: the filter whose residual is output. It takes the
+ *     background's weights once they beat it for two blocks in a row, so a
+ *     background knocked off course by the near end talking (double talk)
+ *     never reaches the output; a background that stays much worse is
+ *     reset to the foreground.
+ * What the foreground leaves of the echo while only the far end talks is
+ * attenuated by a residual suppressor, ramped across the block.
+ *
+ * Weights are Q28 (background, 32 bits) and Q12 (foreground, the
+ * background's upper 16 bits); products are 16x16 with 64-bit sums. The
+ * per-sample step is one 32-bit division. Blocks whose reference is
+ * silent cost a pass over the samples and nothing more.
+ *
+ * Works out of fixed buffers and times every block with the CPU cycle
+ * counter; getStats() reports the cost. Single-threaded: owned by the
+ * capture task; counters may be read elsewhere.
+ */
+class EchoCanceller {
+public:
+    struct Config {
+        uint16_t tail_ms;     // echo path length covered, rounded up to 8 taps
+        uint8_t suppress_db;  // residual echo attenuation while only the far end talks, 0 = off
+    };
+
+    struct Stats {
+        uint16_t taps;
+        uint32_t blocks;             // blocks with far-end audio
+        uint32_t avg_cycles;         // per block with far-end audio, smoothed over ~16 blocks
+        uint32_t max_cycles;         // worst block since boot
+        int8_t erle_db;              // echo removed by the foreground filter (far end only)
+        uint32_t double_talk_blocks; // far-end blocks left unsuppressed (near end talking, or still converging)
+        uint32_t copies;             // background weights taken over by the foreground
+        uint32_t resets;             // background reset after diverging
+    };
+
+    EchoCanceller();
+
+    /**
+     * @brief Apply a configuration and clear the filters and history.
+     */
+    void begin(const Config &config, uint32_t sample_rate);
+
+    /**
+     * @brief Cancel the echo of @p ref in @p mic, in place.
+     * @param ref Speaker samples played while each @p mic sample was captured
+     */
+    void process(int16_t *mic, const int16_t *ref, size_t samples);
+
+    Stats getStats() const;
+
+private:
+    bool processBlock(int16_t *mic, const int16_t *ref, size_t n); // true: far end active
+
+    Config cfg;
+    size_t taps;
+    size_t period;       // history ring period (taps + 1)
+    size_t pos;          // newest sample in hist
+    uint64_t energy;     // reference energy over the taps
+    uint64_t delta;      // regularization, and the far-end activity floor
+    int16_t step;        // pending background update: step * x >> step_shift
+    uint8_t step_shift;
+
+    int32_t background[ECHO_CANCELLER_MAX_TAPS];
+    int16_t foreground[ECHO_CANCELLER_MAX_TAPS];
+    // Reference history, newest first, stored twice so every window is contiguous
+    int16_t hist[2 * (ECHO_CANCELLER_MAX_TAPS + 1)];
+
+    uint8_t better_blocks;  // background ahead of the foreground
+    uint8_t worse_blocks;   // background far behind
+    int32_t suppress_q15;
+    int32_t gain_q15;       // residual suppressor gain at the end of the last block
+    uint64_t erle_mic;      // smoothed far-end-only energies for the ERLE
+    uint64_t erle_out;
+
+    std::atomic<uint32_t> blocks;
+    std::atomic<uint32_t> avg_cycles;
+    std::atomic<uint32_t> max_cycles;
+    std::atomic<uint32_t> erle_snapshot; // mic / output energy, Q8
+    std::atomic<uint32_t> double_talk_blocks;
+    std::atomic<uint32_t> copies;
+    std::atomic<uint32_t> resets;
+};
@@ -0,0 +1,82 @@
+#include "audio/echo_reference.h"
+
+#include <string.h>
+
+static const uint32_t RING_MASK = ECHO_REFERENCE_SAMPLES - 1;
+
+EchoReference::EchoReference()
+    : rate(16000), tolerance(0), head(0), anchor_seq(0), anchor_index(0), anchor_us(0), aligned(false), cursor(0),
+      reads(0), resyncs(0), misses(0) {
+    memset(ring, 0, sizeof(ring));
+}
+
+void EchoReference::begin(uint32_t sample_rate, uint32_t tolerance_us) {
+    rate = sample_rate;
+    tolerance = (int32_t)((uint64_t)tolerance_us * sample_rate / 1000000);
+    aligned = false;
+}
+
+void EchoReference::write(const int16_t *pcm, size_t samples, uint32_t play_us) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < samples; i++) ring[(h + i) & RING_MASK] = pcm[i];
+
+    uint32_t seq = anchor_seq.load(std::memory_order_relaxed);
+    anchor_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    anchor_index.store(h, std::memory_order_relaxed);
+    anchor_us.store(play_us, std::memory_order_relaxed);
+    anchor_seq.store(seq + 2, std::memory_order_release);
+    head.store(h + (uint32_t)samples, std::memory_order_release);
+}
+
+bool EchoReference::read(int16_t *out, size_t samples, uint32_t start_us) {
+    reads.fetch_add(1, std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (h == 0) {
+        memset(out, 0, samples * sizeof(int16_t));
+        return false;
+    }
+
+    uint32_t seq;
+    uint32_t index;
+    uint32_t us;
+    do {
+        seq = anchor_seq.load(std::memory_order_acquire);
+        index = anchor_index.load(std::memory_order_relaxed);
+        us = anchor_us.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || anchor_seq.load(std::memory_order_relaxed) != seq);
+
+    // Where the timestamps put start_us; the cursor stays unless they disagree by more than jitter
+    int64_t offset = (int64_t)(int32_t)(start_us - us) * rate / 1000000;
+    uint32_t wanted = index + (uint32_t)(int32_t)offset;
+    int32_t drift = (int32_t)(wanted - cursor);
+    if (!aligned || drift > tolerance || drift < -tolerance) {
+        if (aligned) resyncs.fetch_add(1, std::memory_order_relaxed);
+        cursor = wanted;
+        aligned = true;
+    }
+
+    // Valid: written, and not in the part the producer may be overwriting
+    bool complete = true;
+    for (size_t i = 0; i < samples; i++) {
+        uint32_t age = h - (cursor + (uint32_t)i);
+        if (age == 0 || age > ECHO_REFERENCE_SAMPLES - ECHO_REFERENCE_MAX_WRITE) {
+            out[i] = 0;
+            complete = false;
+        } else {
+            out[i] = ring[(cursor + i) & RING_MASK];
+        }
+    }
+    cursor += (uint32_t)samples;
+    if (!complete) misses.fetch_add(1, std::memory_order_relaxed);
+    return complete;
+}
+
+EchoReference::Stats EchoReference::getStats() const {
+    Stats st;
+    st.reads = reads.load(std::memory_order_relaxed);
+    st.resyncs = resyncs.load(std::memory_order_relaxed);
+    st.misses = misses.load(std::memory_order_relaxed);
+    return st;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Speaker history kept: 256 ms at 16 kHz (power of two)
+#define ECHO_REFERENCE_SAMPLES 4096
+// Longest block written at once; the reader keeps clear of the part being overwritten
+#define ECHO_REFERENCE_MAX_WRITE 512
+
+/**
+ * @brief The speaker's output on a sample timeline, as the echo canceller's reference.
+ *
+ * The playback task appends every block it hands to the I2S TX DMA with
+ * the time its first sample will play; the capture task asks for the
+ * samples that played while a microphone block was being captured. The
+ * two channels run from the same clock, so once aligned the reader simply
+ * steps along the timeline: timestamps that disagree by up to
+ * @p tolerance_us are taken as jitter, larger differences (a TX underrun
+ * that slipped the speaker, a capture overflow) re-align it and are
+ * counted.
+ *
+ * Single producer (playback task), single consumer (capture task), no
+ * locks: samples are published by the write count, and the timing anchor
+ * with a sequence counter.
+ */
+class EchoReference {
+public:
+    struct Stats {
+        uint32_t reads;
+        uint32_t resyncs;  // re-alignments after the start
+        uint32_t misses;   // reads that were (partly) not in the history: zeros given
+    };
+
+    EchoReference();
+
+    void begin(uint32_t sample_rate, uint32_t tolerance_us);
+
+    // ---- Producer side (playback task) ----
+
+    /**
+     * @brief Append a block handed to the speaker; its first sample plays at @p play_us.
+     */
+    void write(const int16_t *pcm, size_t samples, uint32_t play_us);
+
+    // ---- Consumer side (capture task) ----
+
+    /**
+     * @brief Copy the samples that played from @p start_us on to @p out.
+     * @return false if some were not available (written as zeros)
+     */
+    bool read(int16_t *out, size_t samples, uint32_t start_us);
+
+    /**
+     * @brief Align the next read() from its timestamp alone (the reader paused).
+     */
+    void realign() { aligned = false; }
+
+    Stats getStats() const;
+
+private:
+    int16_t ring[ECHO_REFERENCE_SAMPLES];
+    uint32_t rate;
+    int32_t tolerance;    // samples
+
+    std::atomic<uint32_t> head;         // samples written
+    std::atomic<uint32_t> anchor_seq;   // odd while the anchor changes
+    std::atomic<uint32_t> anchor_index; // a written sample...
+    std::atomic<uint32_t> anchor_us;    // ...and when it plays
+
+    bool aligned;        // consumer only
+    uint32_t cursor;     // next sample index the consumer expects
+
+    std::atomic<uint32_t> reads;
+    std::atomic<uint32_t> resyncs;
+    std::atomic<uint32_t> misses;
+};
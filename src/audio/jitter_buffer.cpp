@@ -0,0 +1,245 @@
+#include "audio/jitter_buffer.h"
+#include "audio/audio_alloc.h"
+
+#include <string.h>
+
+// Arrival gaps longer than this start a new talk burst (not counted as jitter)
+static const uint32_t BURST_GAP_US = 500000;
+// Each underrun raises the target by this much...
+static const uint32_t UNDERRUN_BOOST_MS = 20;
+// ...and the boost decays by DECAY_STEP_MS every DECAY_FRAMES clean frames
+static const uint32_t BOOST_DECAY_FRAMES = 250;
+static const uint32_t BOOST_DECAY_STEP_MS = 5;
+// Trim one frame when depth stays this far above target for TRIM_AFTER_FRAMES pops
+static const uint32_t TRIM_HYSTERESIS_MS = 40;
+static const uint32_t TRIM_AFTER_FRAMES = 25;
+
+JitterBuffer::JitterBuffer()
+    : slots(nullptr), payloads(nullptr), cfg(), head(0), tail(0), depth_samples(0),
+      have_arrival(false), last_arrival_us(0), last_frame_us(0), jitter_q4(0), jitter_us(0), silence(false),
+      playing(false), dry_pending(false), dry_at_us(0), boost_ms(0), healthy_frames(0), above_target_frames(0),
+      target_ms(0), pushed(0), played(0), underruns(0), overruns(0), late_drops(0), trimmed(0), lost(0), recovered(0) {
+}
+
+JitterBuffer::~JitterBuffer() {
+    if (slots) free(slots);
+    if (payloads) free(payloads);
+}
+
+bool JitterBuffer::begin(const Config &config) {
+    if (config.slots == 0 || config.max_frame_bytes == 0 || config.sample_rate == 0) return false;
+    cfg = config;
+
+    slots = (Slot *)audio_alloc_psram(sizeof(Slot) * cfg.slots);
+    payloads = (uint8_t *)audio_alloc_psram((size_t)cfg.slots * cfg.max_frame_bytes);
+    if (!slots || !payloads) {
+        if (slots) free(slots);
+        if (payloads) free(payloads);
+        slots = nullptr;
+        payloads = nullptr;
+        return false;
+    }
+    target_ms.store(cfg.min_target_ms);
+    return true;
+}
+
+uint32_t JitterBuffer::samplesToMs(uint32_t samples) const {
+    return (uint32_t)(((uint64_t)samples * 1000) / cfg.sample_rate);
+}
+
+bool JitterBuffer::push(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us) {
+    if (!slots || len == 0 || len > cfg.max_frame_bytes) return false;
+
+    // Inter-arrival jitter: deviation of the arrival gap from the previous frame's duration
+    if (have_arrival) {
+        uint32_t gap = now_us - last_arrival_us;
+        if (gap < BURST_GAP_US) {
+            int32_t d = (int32_t)gap - (int32_t)last_frame_us;
+            if (d < 0) d = -d;
+            jitter_q4 += (uint32_t)d - (jitter_q4 >> 4);
+            jitter_us.store(jitter_q4 >> 4, std::memory_order_relaxed);
+        }
+    }
+    have_arrival = true;
+    silence.store(false, std::memory_order_relaxed);
+    last_arrival_us = now_us;
+    last_frame_us = (uint32_t)(((uint64_t)samples * 1000000) / cfg.sample_rate);
+
+    return store(data, len, samples, codec, now_us);
+}
+
+bool JitterBuffer::pushLost(uint16_t samples, uint8_t codec, uint32_t now_us) {
+    if (!storeMissing(nullptr, 0, samples, codec, now_us)) return false;
+    lost.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JitterBuffer::pushRecovered(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us) {
+    if (len == 0 || len > cfg.max_frame_bytes) return false;
+    if (!storeMissing(data, len, samples, codec, now_us)) return false;
+    recovered.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void JitterBuffer::markSilence() {
+    // The gap before the next frame is the talker's pause, not network delay
+    have_arrival = false;
+    silence.store(true, std::memory_order_relaxed);
+}
+
+void JitterBuffer::reset() {
+    tail.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    depth_samples.store(0, std::memory_order_relaxed);
+    have_arrival = false;
+    last_arrival_us = 0;
+    last_frame_us = 0;
+    jitter_q4 = 0;
+    jitter_us.store(0, std::memory_order_relaxed);
+    silence.store(false, std::memory_order_relaxed);
+    playing = false;
+    dry_pending = false;
+    dry_at_us = 0;
+    boost_ms = 0;
+    healthy_frames = 0;
+    above_target_frames = 0;
+    target_ms.store(cfg.min_target_ms, std::memory_order_relaxed);
+}
+
+bool JitterBuffer::storeMissing(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us) {
+    if (!slots || samples == 0) return false;
+    // Not an arrival, but the next real frame is expected that much later
+    last_frame_us += (uint32_t)(((uint64_t)samples * 1000000) / cfg.sample_rate);
+    return store(data, len, samples, codec, now_us);
+}
+
+bool JitterBuffer::store(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (h - t >= cfg.slots) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint32_t idx = h % cfg.slots;
+    Slot &s = slots[idx];
+    s.arrival_us = now_us;
+    s.samples = samples;
+    s.len = (uint16_t)len;
+    s.codec = codec;
+    if (len) memcpy(payloads + (size_t)idx * cfg.max_frame_bytes, data, len);
+
+    depth_samples.fetch_add(samples, std::memory_order_relaxed);
+    head.store(h + 1, std::memory_order_release);
+    pushed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void JitterBuffer::dropFront() {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    depth_samples.fetch_sub(slots[t % cfg.slots].samples, std::memory_order_relaxed);
+    tail.store(t + 1, std::memory_order_release);
+}
+
+uint32_t JitterBuffer::computeTarget() {
+    uint32_t jitter_ms = jitter_us.load(std::memory_order_relaxed) / 1000;
+    uint32_t target = cfg.min_target_ms + 2 * jitter_ms + boost_ms;
+    if (target > cfg.max_target_ms) target = cfg.max_target_ms;
+    target_ms.store(target, std::memory_order_relaxed);
+    return target;
+}
+
+size_t JitterBuffer::pop(uint8_t *out, uint16_t *samples, uint8_t *codec, uint32_t now_us, uint32_t *arrival_us) {
+    if (!slots) return 0;
+
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+
+    // Late discard: anything that already waited past the latency bound is useless
+    uint32_t max_latency_us = (uint32_t)cfg.max_latency_ms * 1000;
+    while (t != h && (uint32_t)(now_us - slots[t % cfg.slots].arrival_us) > max_latency_us) {
+        dropFront();
+        late_drops.fetch_add(1, std::memory_order_relaxed);
+        t++;
+    }
+
+    uint32_t target = computeTarget();
+
+    if (!playing) {
+        if (t == h) {
+            if (dry_pending && (uint32_t)(now_us - dry_at_us) > BURST_GAP_US) dry_pending = false;
+            if (dry_pending && silence.load(std::memory_order_relaxed)) dry_pending = false;
+            return 0;
+        }
+        // A frame arriving shortly after running dry means the stream starved: underrun
+        if (dry_pending) {
+            dry_pending = false;
+            if ((uint32_t)(slots[t % cfg.slots].arrival_us - dry_at_us) < BURST_GAP_US) {
+                underruns.fetch_add(1, std::memory_order_relaxed);
+                boost_ms += UNDERRUN_BOOST_MS;
+                healthy_frames = 0;
+                target = computeTarget();
+            }
+        }
+        // Start once the target depth is reached, or once the oldest frame waited that long
+        // (the talker may have stopped with less than a target's worth of audio queued)
+        uint32_t depth = samplesToMs(depth_samples.load(std::memory_order_relaxed));
+        uint32_t waited_ms = (now_us - slots[t % cfg.slots].arrival_us) / 1000;
+        if (depth < target && waited_ms < target) return 0;
+        playing = true;
+        above_target_frames = 0;
+    }
+
+    if (t == h) {
+        // Ran dry: either end of a burst or a starved stream; decided on the next arrival
+        // (a DTX pause is neither)
+        playing = false;
+        dry_pending = !silence.load(std::memory_order_relaxed);
+        dry_at_us = now_us;
+        return 0;
+    }
+
+    // Shrink latency back towards target after a burst of late arrivals
+    uint32_t depth = samplesToMs(depth_samples.load(std::memory_order_relaxed));
+    if (depth > target + TRIM_HYSTERESIS_MS) {
+        if (++above_target_frames >= TRIM_AFTER_FRAMES && (h - t) > 1) {
+            dropFront();
+            trimmed.fetch_add(1, std::memory_order_relaxed);
+            t++;
+            above_target_frames = 0;
+        }
+    } else {
+        above_target_frames = 0;
+    }
+
+    uint32_t idx = t % cfg.slots;
+    const Slot &s = slots[idx];
+    size_t len = s.len;
+    *samples = s.samples;
+    *codec = s.codec;
+    if (arrival_us) *arrival_us = s.arrival_us;
+    if (len) memcpy(out, payloads + (size_t)idx * cfg.max_frame_bytes, len);
+    dropFront();
+    played.fetch_add(1, std::memory_order_relaxed);
+
+    if (boost_ms > 0 && ++healthy_frames >= BOOST_DECAY_FRAMES) {
+        boost_ms = (boost_ms > BOOST_DECAY_STEP_MS) ? boost_ms - BOOST_DECAY_STEP_MS : 0;
+        healthy_frames = 0;
+    }
+    return len;
+}
+
+JitterBuffer::Stats JitterBuffer::getStats() const {
+    Stats st;
+    st.pushed = pushed.load(std::memory_order_relaxed);
+    st.played = played.load(std::memory_order_relaxed);
+    st.underruns = underruns.load(std::memory_order_relaxed);
+    st.overruns = overruns.load(std::memory_order_relaxed);
+    st.late_drops = late_drops.load(std::memory_order_relaxed);
+    st.trimmed = trimmed.load(std::memory_order_relaxed);
+    st.lost = lost.load(std::memory_order_relaxed);
+    st.recovered = recovered.load(std::memory_order_relaxed);
+    st.depth_ms = cfg.sample_rate ? (uint16_t)samplesToMs(depth_samples.load(std::memory_order_relaxed)) : 0;
+    st.target_ms = (uint16_t)target_ms.load(std::memory_order_relaxed);
+    st.jitter_ms = (uint16_t)(jitter_us.load(std::memory_order_relaxed) / 1000);
+    return st;
+}
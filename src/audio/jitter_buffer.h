@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Adaptive playout buffer for incoming audio frames.
+ *
+ * One producer (the WebSocket receive path) pushes frames as they arrive and
+ * one consumer (the playback task) pops them at the I2S rate. Both sides are
+ * lock-free; the producer only measures arrival jitter, all playout decisions
+ * (start, trim, late discard, underrun) are taken by the consumer.
+ *
+ * - Target depth follows the RFC 3550 inter-arrival jitter estimate plus a
+ *   boost that grows on every underrun and decays while playout is healthy.
+ * - Frames that waited longer than max_latency_ms are discarded as late, so
+ *   receive latency stays bounded even after a long network stall.
+ * - A full buffer drops the incoming frame (overrun).
+ * - Frames the sender sent but that never arrived can hold their place in
+ *   the playout order (pushLost), so the consumer conceals them on time;
+ *   frames rebuilt from redundant copies are slotted in the same way
+ *   (pushRecovered).
+ * - A talker pausing under DTX (markSilence) lets the buffer run dry without
+ *   that counting as an underrun, and its next frame is not taken as jitter.
+ */
+class JitterBuffer {
+public:
+    struct Config {
+        uint16_t slots;           // capacity in frames
+        uint16_t max_frame_bytes; // largest payload stored per slot
+        uint32_t sample_rate;     // playout rate in Hz
+        uint16_t min_target_ms;   // lower bound of the adaptive depth
+        uint16_t max_target_ms;   // upper bound of the adaptive depth
+        uint16_t max_latency_ms;  // frames older than this are dropped as late
+    };
+
+    struct Stats {
+        uint32_t pushed;
+        uint32_t played;
+        uint32_t underruns;
+        uint32_t overruns;
+        uint32_t late_drops;
+        uint32_t trimmed;
+        uint32_t lost;      // placeholders queued by pushLost()
+        uint32_t recovered; // frames queued by pushRecovered()
+        uint16_t depth_ms;
+        uint16_t target_ms;
+        uint16_t jitter_ms;
+    };
+
+    JitterBuffer();
+    ~JitterBuffer();
+
+    /**
+     * @brief Allocate slot storage (PSRAM when available).
+     * @return true on success
+     */
+    bool begin(const Config &config);
+
+    /**
+     * @brief Producer side: queue one received frame.
+     * @param samples Playout duration of the frame in samples
+     * @param codec   Codec tag returned with the frame by pop()
+     * @param now_us  Arrival time (microseconds, free-running)
+     * @return false if the frame was dropped (overrun or too large)
+     */
+    bool push(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us);
+
+    /**
+     * @brief Producer side: queue a placeholder for a frame known to be lost.
+     * pop() returns it as 0 bytes with a non-zero @p samples.
+     * @return false on overrun
+     */
+    bool pushLost(uint16_t samples, uint8_t codec, uint32_t now_us);
+
+    /**
+     * @brief Producer side: queue a missing frame rebuilt from a redundant
+     * copy. Like pushLost(), it takes the frame's place without counting as
+     * an arrival for the jitter estimate.
+     * @return false on overrun or if the frame is too large
+     */
+    bool pushRecovered(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us);
+
+    /**
+     * @brief Producer side: the sender stopped sending on purpose (a comfort
+     * noise descriptor arrived). Cleared by the next push().
+     */
+    void markSilence();
+
+    /**
+     * @brief Drop every queued frame and restart the adaptation (jitter
+     * estimate, underrun boost, target depth) for a new talker. Counters
+     * keep running. Neither side may use the buffer meanwhile.
+     */
+    void reset();
+
+    /**
+     * @brief Consumer side: fetch the next frame due for playout.
+     * @param out      Destination buffer, at least max_frame_bytes long
+     * @param samples  Receives the frame duration in samples
+     * @param codec    Receives the codec tag given to push()
+     * @param now_us   Current time (same clock as push)
+     * @param arrival_us Optional: receives the arrival time given to push()
+     * @return Payload bytes, or 0 when nothing should be played (buffering or
+     *         underrun, *samples == 0) or the frame was lost (*samples > 0)
+     */
+    size_t pop(uint8_t *out, uint16_t *samples, uint8_t *codec, uint32_t now_us, uint32_t *arrival_us = nullptr);
+
+    /**
+     * @brief Snapshot of counters and current depth/target.
+     */
+    Stats getStats() const;
+
+private:
+    struct Slot {
+        uint32_t arrival_us;
+        uint16_t samples;
+        uint16_t len;
+        uint8_t codec;
+    };
+
+    Slot *slots;
+    uint8_t *payloads;
+    Config cfg;
+
+    // Ring indices: head written by producer, tail by consumer
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> depth_samples;
+
+    // Producer-side jitter estimate (RFC 3550, 1/16 gain), in microseconds << 4
+    bool have_arrival;
+    uint32_t last_arrival_us;
+    uint32_t last_frame_us;
+    uint32_t jitter_q4;
+    std::atomic<uint32_t> jitter_us;
+    std::atomic<bool> silence; // markSilence() since the last push()
+
+    // Consumer-side playout state
+    bool playing;
+    bool dry_pending;
+    uint32_t dry_at_us;
+    uint32_t boost_ms;
+    uint32_t healthy_frames;
+    uint32_t above_target_frames;
+    std::atomic<uint32_t> target_ms;
+
+    // Counters (single writer each)
+    std::atomic<uint32_t> pushed;
+    std::atomic<uint32_t> played;
+    std::atomic<uint32_t> underruns;
+    std::atomic<uint32_t> overruns;
+    std::atomic<uint32_t> late_drops;
+    std::atomic<uint32_t> trimmed;
+    std::atomic<uint32_t> lost;
+    std::atomic<uint32_t> recovered;
+
+    uint32_t samplesToMs(uint32_t samples) const;
+    uint32_t computeTarget();
+    bool store(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us);
+    bool storeMissing(const uint8_t *data, size_t len, uint16_t samples, uint8_t codec, uint32_t now_us);
+    void dropFront();
+};
@@ -0,0 +1,106 @@
+#include "audio/latency_probe.h"
+
+LatencyProbe::LatencyProbe()
+    : active(false), interval_us(1000000), have_probe_time(false), last_probe_us(0), tx_pending(false), tx_seq(0),
+      tx_capture_stage_us(0), tx_queue_stage_us(0), tx_sent_us(0), rx_seq(0), rx_arrival_us(0), rx_done_us(0),
+      rx_jitter_us(0), rx_output_us(0), probes(0), reports(0), last_total_us(0), min_total_us(0), max_total_us(0),
+      sum_total_us(0), avg_total_us(0) {
+}
+
+void LatencyProbe::enable(bool on, uint32_t interval_ms) {
+    interval_us.store(interval_ms * 1000, std::memory_order_relaxed);
+    active.store(on, std::memory_order_relaxed);
+}
+
+bool LatencyProbe::due(uint32_t now_us) {
+    if (!active.load(std::memory_order_relaxed)) return false;
+    if (have_probe_time && now_us - last_probe_us < interval_us.load(std::memory_order_relaxed)) return false;
+    have_probe_time = true;
+    last_probe_us = now_us;
+    return true;
+}
+
+void LatencyProbe::onSent(uint16_t seq, uint32_t block_us, uint32_t capture_us, uint32_t encoded_us,
+                          uint32_t sent_us) {
+    // A newer probe replaces one whose reports never came back
+    tx_pending = true;
+    tx_seq = seq;
+    tx_capture_stage_us = block_us + (encoded_us - capture_us);
+    tx_queue_stage_us = sent_us - encoded_us;
+    tx_sent_us = sent_us;
+    probes.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool LatencyProbe::onReport(const LatencyReport &report, uint32_t now_us, bool loopback, LatencyBreakdown *out) {
+    if (!tx_pending || report.seq != tx_seq) return false;
+
+    uint32_t network_us;
+    if (loopback) {
+        network_us = report.arrival_us - tx_sent_us;
+    } else {
+        // Symmetric path assumed: half of the round trip minus the listener's hold time
+        uint32_t rtt_us = now_us - tx_sent_us;
+        network_us = rtt_us > report.hold_us ? (rtt_us - report.hold_us) / 2 : 0;
+    }
+
+    out->seq = report.seq;
+    out->capture_us = tx_capture_stage_us;
+    out->queue_us = tx_queue_stage_us;
+    out->network_us = network_us;
+    out->jitter_us = report.jitter_us;
+    out->output_us = report.output_us;
+    out->total_us = out->capture_us + out->queue_us + out->network_us + out->jitter_us + out->output_us;
+    out->loopback = loopback;
+
+    // Several listeners may answer the same probe; each one is a sample
+    uint32_t n = reports.load(std::memory_order_relaxed) + 1;
+    sum_total_us += out->total_us;
+    last_total_us.store(out->total_us, std::memory_order_relaxed);
+    if (n == 1 || out->total_us < min_total_us.load(std::memory_order_relaxed)) {
+        min_total_us.store(out->total_us, std::memory_order_relaxed);
+    }
+    if (out->total_us > max_total_us.load(std::memory_order_relaxed)) {
+        max_total_us.store(out->total_us, std::memory_order_relaxed);
+    }
+    avg_total_us.store((uint32_t)(sum_total_us / n), std::memory_order_relaxed);
+    reports.store(n, std::memory_order_relaxed);
+    return true;
+}
+
+void LatencyProbe::onProbeReceived(uint16_t seq, uint32_t arrival_us) {
+    rx_seq = seq;
+    rx_arrival_us.store(arrival_us, std::memory_order_release);
+}
+
+void LatencyProbe::onPlayout(uint32_t arrival_us, uint32_t popped_us, uint32_t written_us,
+                             uint32_t queued_ahead_us) {
+    uint32_t armed = rx_arrival_us.load(std::memory_order_acquire);
+    // Raw PCM probes may be split over several slots: only the first one counts
+    if (armed == 0 || arrival_us != armed || rx_done_us.load(std::memory_order_relaxed) == armed) return;
+    rx_jitter_us = popped_us - arrival_us;
+    rx_output_us = (written_us - popped_us) + queued_ahead_us;
+    rx_done_us.store(armed, std::memory_order_release);
+}
+
+bool LatencyProbe::takeReport(LatencyReport *out, uint32_t now_us) {
+    uint32_t armed = rx_arrival_us.load(std::memory_order_relaxed);
+    if (armed == 0 || rx_done_us.load(std::memory_order_acquire) != armed) return false;
+    out->seq = rx_seq;
+    out->arrival_us = armed;
+    out->jitter_us = rx_jitter_us;
+    out->output_us = rx_output_us;
+    out->hold_us = now_us - armed;
+    rx_arrival_us.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+LatencyProbe::Stats LatencyProbe::getStats() const {
+    Stats st;
+    st.probes = probes.load(std::memory_order_relaxed);
+    st.reports = reports.load(std::memory_order_relaxed);
+    st.last_total_us = last_total_us.load(std::memory_order_relaxed);
+    st.min_total_us = min_total_us.load(std::memory_order_relaxed);
+    st.max_total_us = max_total_us.load(std::memory_order_relaxed);
+    st.avg_total_us = avg_total_us.load(std::memory_order_relaxed);
+    return st;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * @brief Mouth-to-ear latency of one probe frame, split by stage (microseconds).
+ *
+ * Measured from the first sample of the captured I2S block to the moment
+ * that sample leaves the listener's I2S DMA queue.
+ */
+struct LatencyBreakdown {
+    uint16_t seq;
+    uint32_t capture_us; // I2S block fill + encode (talker)
+    uint32_t queue_us;   // capture ring + WebSocket send (talker)
+    uint32_t network_us; // talker send -> listener receive
+    uint32_t jitter_us;  // listener jitter buffer residence
+    uint32_t output_us;  // listener decode + I2S DMA queue ahead of the frame
+    uint32_t total_us;
+    bool loopback;       // talker heard itself: network is exact, not half the round trip
+};
+
+/**
+ * @brief Listener-side stages, sent back to the talker in "lat_report".
+ */
+struct LatencyReport {
+    uint16_t seq;
+    uint32_t arrival_us; // probe receive time (listener clock)
+    uint32_t jitter_us;
+    uint32_t output_us;
+    uint32_t hold_us;    // probe receive -> report sent, removed from the round trip
+};
+
+/**
+ * @brief End-to-end latency measurement with in-band probe frames.
+ *
+ * While enabled, the talker marks one captured frame per interval as a probe
+ * (AUDIO_FRAME_FLAG_PROBE in the frame header). Every listener times the
+ * probe through its jitter buffer and I2S output and answers with a
+ * "lat_report"; the talker adds its own capture and send-queue stages and
+ * derives the network stage from the report's round trip. Clocks are never
+ * compared across devices, except in loopback (relay --echo) where the
+ * talker is its own listener and the network stage is measured directly.
+ *
+ * Threads: due() runs in the capture task; onSent(), onReport(),
+ * onProbeReceived() and takeReport() in the network task; onPlayout() in the
+ * playback task. enable() may be called from anywhere.
+ */
+class LatencyProbe {
+public:
+    struct Stats {
+        uint32_t probes;  // probe frames sent
+        uint32_t reports; // breakdowns completed
+        uint32_t last_total_us;
+        uint32_t min_total_us;
+        uint32_t max_total_us;
+        uint32_t avg_total_us;
+    };
+
+    LatencyProbe();
+
+    /**
+     * @brief Start or stop sending probes.
+     * @param interval_ms Time between probes while talking
+     */
+    void enable(bool on, uint32_t interval_ms);
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Capture task: true when the frame captured at @p now_us should be a probe.
+     */
+    bool due(uint32_t now_us);
+
+    /**
+     * @brief Talker: the probe frame went out.
+     * @param block_us Duration of the captured block (time its first sample waited in I2S)
+     * @param capture_us When the block left the I2S driver
+     * @param encoded_us When encoding finished
+     */
+    void onSent(uint16_t seq, uint32_t block_us, uint32_t capture_us, uint32_t encoded_us, uint32_t sent_us);
+
+    /**
+     * @brief Talker: combine a listener's report with the local stages.
+     * @param loopback The report came from this device
+     * @return false if @p report does not answer the outstanding probe
+     */
+    bool onReport(const LatencyReport &report, uint32_t now_us, bool loopback, LatencyBreakdown *out);
+
+    /**
+     * @brief Listener: a probe frame arrived and was queued for playout.
+     */
+    void onProbeReceived(uint16_t seq, uint32_t arrival_us);
+
+    /**
+     * @brief Listener, playback task: a frame received at @p arrival_us was played.
+     * @param popped_us       When it left the jitter buffer
+     * @param written_us      When i2s_channel_write accepted it
+     * @param queued_ahead_us Audio still in the I2S DMA queue in front of it
+     */
+    void onPlayout(uint32_t arrival_us, uint32_t popped_us, uint32_t written_us, uint32_t queued_ahead_us);
+
+    /**
+     * @brief Listener: fetch a finished report (once per probe).
+     */
+    bool takeReport(LatencyReport *out, uint32_t now_us);
+
+    Stats getStats() const;
+
+private:
+    std::atomic<bool> active;
+    std::atomic<uint32_t> interval_us;
+
+    // Capture task
+    bool have_probe_time;
+    uint32_t last_probe_us;
+
+    // Talker, network task: outstanding probe
+    bool tx_pending;
+    uint16_t tx_seq;
+    uint32_t tx_capture_stage_us;
+    uint32_t tx_queue_stage_us;
+    uint32_t tx_sent_us;
+
+    // Listener: network task arms, playback task completes
+    uint16_t rx_seq;
+    std::atomic<uint32_t> rx_arrival_us; // 0 = nothing armed
+    std::atomic<uint32_t> rx_done_us;    // arrival of the probe whose stages below are valid
+    uint32_t rx_jitter_us;
+    uint32_t rx_output_us;
+
+    // Results (network task writes)
+    std::atomic<uint32_t> probes;
+    std::atomic<uint32_t> reports;
+    std::atomic<uint32_t> last_total_us;
+    std::atomic<uint32_t> min_total_us;
+    std::atomic<uint32_t> max_total_us;
+    uint64_t sum_total_us;
+    std::atomic<uint32_t> avg_total_us;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Datagrams of the optional UDP media path. The WebSocket stays the control
+ * channel (auth, caps, talk_start/talk_stop, ping); only audio frames move.
+ *
+ * Negotiation: the client offers "udp":1 in "caps" (together with "frame":1);
+ * a server with a media socket answers "udp":<port>,"token":<u32> in
+ * "caps_ack". The client then sends HELLO datagrams to that port until one
+ * is answered with HELLO_ACK, which also tells the server its public
+ * address. From then on audio goes both ways as datagrams; HELLOs repeat as
+ * keepalives, and the client falls back to binary WebSocket frames when
+ * they stop being answered.
+ *
+ * Wire layout:
+ *   byte 0     MediaDatagramKind
+ *   bytes 1-4  session token from caps_ack (u32 little-endian), both ways
+ *   AUDIO*     audio frame header (audio_frame.h) + payload, as on the
+ *              WebSocket (after the source id when mixing was agreed,
+ *              AUDIO_FRAME_SOURCE_BYTES); AUDIO_RED payloads carry redundant copies
+ *              (redundancy.h), which makes every datagram self-describing
+ *              even when it overtakes the talk_start sent over TCP.
+ *
+ * The frame header already carries what RTP would (sequence number, sender
+ * timestamp, payload type), so no separate RTP header is added.
+ */
+#define MEDIA_DGRAM_PREFIX_BYTES 5
+
+enum MediaDatagramKind : uint8_t {
+    MEDIA_DGRAM_HELLO = 1,     // client -> server: register / keep the NAT binding
+    MEDIA_DGRAM_HELLO_ACK = 2, // server -> client
+    MEDIA_DGRAM_AUDIO = 3,     // frame header + payload
+    MEDIA_DGRAM_AUDIO_RED = 4  // frame header + redundant payload
+};
+
+/**
+ * @brief Write the datagram prefix at @p out (MEDIA_DGRAM_PREFIX_BYTES bytes).
+ */
+static inline void media_dgram_write_prefix(uint8_t kind, uint32_t token, uint8_t *out) {
+    out[0] = kind;
+    out[1] = (uint8_t)token;
+    out[2] = (uint8_t)(token >> 8);
+    out[3] = (uint8_t)(token >> 16);
+    out[4] = (uint8_t)(token >> 24);
+}
+
+/**
+ * @brief Parse a datagram prefix.
+ * @return false if the datagram is too short
+ */
+static inline bool media_dgram_parse_prefix(const uint8_t *data, size_t len, uint8_t *kind, uint32_t *token) {
+    if (len < MEDIA_DGRAM_PREFIX_BYTES) return false;
+    *kind = data[0];
+    *token = (uint32_t)data[1] | ((uint32_t)data[2] << 8) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 24);
+    return true;
+}
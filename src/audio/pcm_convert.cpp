@@ -0,0 +1,64 @@
+#include "audio/pcm_convert.h"
+
+#if defined(__XTENSA__)
+#include <xtensa/config/core-isa.h>
+#endif
+
+// Kept one sample at a time on purpose: it is the baseline the kernel is measured against
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
+void pcm_s32_to_s16_ref(const int32_t *in, int16_t *out, size_t samples, uint8_t shift) {
+    for (size_t i = 0; i < samples; i++) {
+        int32_t v = in[i] >> shift;
+        if (v > INT16_MAX) {
+            v = INT16_MAX;
+        } else if (v < INT16_MIN) {
+            v = INT16_MIN;
+        }
+        out[i] = (int16_t)v;
+    }
+}
+
+#if defined(__XTENSA__) && XCHAL_HAVE_CLAMPS
+
+// Saturate to [-32768, 32767] in one instruction
+static inline int32_t clamp_s16(int32_t v) {
+    int32_t r;
+    __asm__("clamps %0, %1, 15" : "=a"(r) : "a"(v));
+    return r;
+}
+
+void pcm_s32_to_s16(const int32_t *in, int16_t *out, size_t samples, uint8_t shift) {
+    size_t i = 0;
+    // Word stores need a 4-byte aligned destination
+    if (samples > 0 && ((uintptr_t)out & 3)) {
+        out[0] = (int16_t)clamp_s16(in[0] >> shift);
+        i = 1;
+    }
+    uint32_t *dst = (uint32_t *)(out + i);
+    // Four loads ahead of two packed stores keep the load/use pipeline busy
+    for (; i + 4 <= samples; i += 4) {
+        int32_t a = clamp_s16(in[i] >> shift);
+        int32_t b = clamp_s16(in[i + 1] >> shift);
+        int32_t c = clamp_s16(in[i + 2] >> shift);
+        int32_t d = clamp_s16(in[i + 3] >> shift);
+        *dst++ = ((uint32_t)a & 0xFFFF) | ((uint32_t)b << 16);
+        *dst++ = ((uint32_t)c & 0xFFFF) | ((uint32_t)d << 16);
+    }
+    for (; i < samples; i++) out[i] = (int16_t)clamp_s16(in[i] >> shift);
+}
+
+#else
+
+void pcm_s32_to_s16(const int32_t *in, int16_t *__restrict out, size_t samples, uint8_t shift) {
+    // Branchless min/max: the form compilers turn into packed shifts and saturating packs
+    for (size_t i = 0; i < samples; i++) {
+        int32_t v = in[i] >> shift;
+        v = v > INT16_MAX ? INT16_MAX : v;
+        v = v < INT16_MIN ? INT16_MIN : v;
+        out[i] = (int16_t)v;
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Conversion of 32-bit I2S microphone slots to 16-bit PCM.
+ *
+ * I2S MEMS microphones send 24-bit samples left-justified in 32-bit slots.
+ * Each sample is shifted right by `shift` and saturated to 16 bits:
+ *   - shift 16 keeps the top 16 bits, the same level as a 16-bit read;
+ *   - every bit less is +6 dB of digital gain (shift 12 = +24 dB), applied
+ *     before the low bits are dropped, so quiet speech keeps its resolution.
+ */
+#define PCM_CONVERT_UNITY_SHIFT 16
+#define PCM_CONVERT_MIN_SHIFT 8 // +48 dB
+
+/**
+ * @brief Scalar reference: one sample at a time, obviously correct.
+ */
+void pcm_s32_to_s16_ref(const int32_t *in, int16_t *out, size_t samples, uint8_t shift);
+
+/**
+ * @brief Same result as pcm_s32_to_s16_ref(), bit for bit.
+ *
+ * On the ESP32-S3, an unrolled loop with the Xtensa CLAMPS instruction
+ * saturates in one cycle and stores two samples per 32-bit write. On the
+ * host, a branchless loop that the compiler vectorizes.
+ * @param shift 0 .. 31 (the microphone gain uses PCM_CONVERT_MIN_SHIFT and up)
+ */
+void pcm_s32_to_s16(const int32_t *in, int16_t *out, size_t samples, uint8_t shift);
@@ -0,0 +1,153 @@
+#include "audio/plc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Pitch search range (G.711 Appendix I: 66-400 Hz)
+static const uint32_t MIN_PERIOD_US = 2500;
+static const uint32_t MAX_PERIOD_US = 15000;
+// Loss envelope: full level, then a linear fade to silence
+static const uint32_t HOLD_US = 10000;
+static const uint32_t FADE_US = 50000;
+// Cross-fade from the concealment into the first good frame
+static const uint32_t OVERLAP_US = 4000;
+
+static size_t us_to_samples(uint32_t sample_rate, uint32_t us) {
+    return (size_t)(((uint64_t)sample_rate * us) / 1000000);
+}
+
+PacketLossConcealer::PacketLossConcealer()
+    : history(nullptr), history_len(0), history_fill(0), min_period(0), max_period(0), hold_samples(0),
+      fade_samples(0), overlap_samples(0), lost_samples(0), period(0), period_pos(0), concealed_frames(0),
+      native_frames(0), faded_out(0), recoveries(0) {
+}
+
+PacketLossConcealer::~PacketLossConcealer() {
+    if (history) free(history);
+}
+
+bool PacketLossConcealer::begin(uint32_t sample_rate) {
+    if (sample_rate == 0) return false;
+    min_period = us_to_samples(sample_rate, MIN_PERIOD_US);
+    max_period = us_to_samples(sample_rate, MAX_PERIOD_US);
+    hold_samples = us_to_samples(sample_rate, HOLD_US);
+    fade_samples = us_to_samples(sample_rate, FADE_US);
+    overlap_samples = us_to_samples(sample_rate, OVERLAP_US);
+    // Correlation window of one max period, compared against up to one max period back
+    history_len = 2 * max_period;
+    // Touched on every played frame: keep it in internal RAM
+    history = (int16_t *)malloc(history_len * sizeof(int16_t));
+    return history != nullptr;
+}
+
+void PacketLossConcealer::reset() {
+    history_fill = 0;
+    lost_samples = 0;
+}
+
+void PacketLossConcealer::remember(const int16_t *pcm, size_t samples) {
+    if (!history) return;
+    if (samples >= history_len) {
+        memcpy(history, pcm + samples - history_len, history_len * sizeof(int16_t));
+        history_fill = history_len;
+        return;
+    }
+    memmove(history, history + samples, (history_len - samples) * sizeof(int16_t));
+    memcpy(history + history_len - samples, pcm, samples * sizeof(int16_t));
+    history_fill = history_fill + samples > history_len ? history_len : history_fill + samples;
+}
+
+size_t PacketLossConcealer::findPeriod() const {
+    if (history_fill < 2 * min_period) return 0;
+    if (history_fill < history_len) {
+        // Not enough audio for a pitch search yet: repeat what there is
+        return history_fill > max_period ? max_period : history_fill;
+    }
+
+    // Maximize normalized autocorrelation of the newest window against lagged copies
+    const int16_t *end = history + history_len;
+    size_t window = max_period;
+    size_t best = max_period;
+    float best_score = 0.0f;
+    for (size_t p = min_period; p <= max_period; p++) {
+        int64_t corr = 0;
+        int64_t energy = 0;
+        for (size_t i = 0; i < window; i++) {
+            int32_t x = end[(ptrdiff_t)i - (ptrdiff_t)window];
+            int32_t y = end[(ptrdiff_t)i - (ptrdiff_t)window - (ptrdiff_t)p];
+            corr += x * y;
+            energy += y * y;
+        }
+        if (corr <= 0 || energy == 0) continue;
+        float score = (float)corr * (float)corr / (float)energy;
+        if (score > best_score) {
+            best_score = score;
+            best = p;
+        }
+    }
+    return best;
+}
+
+int16_t PacketLossConcealer::nextSample() {
+    int32_t s = history[history_len - period + period_pos];
+    if (++period_pos == period) period_pos = 0;
+
+    if (lost_samples >= hold_samples + fade_samples) {
+        s = 0;
+    } else if (lost_samples > hold_samples) {
+        s = (int32_t)((int64_t)s * (int64_t)(hold_samples + fade_samples - lost_samples) / (int64_t)fade_samples);
+    }
+    lost_samples++;
+    return (int16_t)s;
+}
+
+void PacketLossConcealer::conceal(int16_t *out, size_t samples) {
+    if (lost_samples == 0) {
+        period = findPeriod();
+        period_pos = 0;
+    }
+    concealed_frames.fetch_add(1, std::memory_order_relaxed);
+    size_t end_of_fade = hold_samples + fade_samples;
+    if (lost_samples < end_of_fade && lost_samples + samples >= end_of_fade) {
+        faded_out.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (period == 0) {
+        memset(out, 0, samples * sizeof(int16_t));
+        lost_samples += samples;
+        return;
+    }
+    for (size_t i = 0; i < samples; i++) out[i] = nextSample();
+}
+
+void PacketLossConcealer::frameDecoded(int16_t *pcm, size_t samples) {
+    if (lost_samples > 0) {
+        if (period > 0) {
+            size_t overlap = samples < overlap_samples ? samples : overlap_samples;
+            int32_t den = (int32_t)overlap + 1;
+            for (size_t i = 0; i < overlap; i++) {
+                int32_t w = (int32_t)i + 1;
+                int32_t c = nextSample();
+                pcm[i] = (int16_t)((c * (den - w) + (int32_t)pcm[i] * w) / den);
+            }
+        }
+        recoveries.fetch_add(1, std::memory_order_relaxed);
+        lost_samples = 0;
+    }
+    remember(pcm, samples);
+}
+
+void PacketLossConcealer::frameConcealedByCodec(const int16_t *pcm, size_t samples) {
+    native_frames.fetch_add(1, std::memory_order_relaxed);
+    lost_samples = 0;
+    remember(pcm, samples);
+}
+
+PacketLossConcealer::Stats PacketLossConcealer::getStats() const {
+    Stats st;
+    st.concealed_frames = concealed_frames.load(std::memory_order_relaxed);
+    st.native_frames = native_frames.load(std::memory_order_relaxed);
+    st.faded_out = faded_out.load(std::memory_order_relaxed);
+    st.recoveries = recoveries.load(std::memory_order_relaxed);
+    return st;
+}
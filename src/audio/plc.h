@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Waveform-repetition packet loss concealment for decoded PCM.
+ *
+ * Used for codecs without their own PLC (raw PCM, IMA-ADPCM). The decoder
+ * output of every good frame goes through frameDecoded(), which keeps a
+ * short history. For a missing frame, conceal() finds the pitch period of
+ * the history (normalized autocorrelation) and repeats the last period. The
+ * repetition holds full level for the first 10 ms of a loss, then fades
+ * linearly to silence at 60 ms. That follows ITU-T G.711 Appendix I, so
+ * long outages go quiet instead of buzzing. The first good frame after a
+ * loss is cross-faded with the continued repetition, so recovery has no
+ * click.
+ *
+ * Single-threaded: owned by the playback task.
+ */
+class PacketLossConcealer {
+public:
+    struct Stats {
+        uint32_t concealed_frames; // frames synthesized by repetition
+        uint32_t native_frames;    // frames synthesized by the codec's PLC
+        uint32_t faded_out;        // losses that ran past the fade (silence)
+        uint32_t recoveries;       // good frames cross-faded after a loss
+    };
+
+    PacketLossConcealer();
+    ~PacketLossConcealer();
+
+    /**
+     * @brief Allocate history for @p sample_rate.
+     * @return true on success
+     */
+    bool begin(uint32_t sample_rate);
+
+    /**
+     * @brief Forget the history (the talker changed or stopped).
+     */
+    void reset();
+
+    /**
+     * @brief Record a decoded frame. After a loss, fades it in from the
+     * concealment, in place.
+     */
+    void frameDecoded(int16_t *pcm, size_t samples);
+
+    /**
+     * @brief Record audio the codec concealed itself (keeps the history current).
+     */
+    void frameConcealedByCodec(const int16_t *pcm, size_t samples);
+
+    /**
+     * @brief Synthesize @p samples of audio for a missing frame.
+     * Silence if there is no history yet.
+     */
+    void conceal(int16_t *out, size_t samples);
+
+    /**
+     * @brief Whether a loss is being concealed (no good frame since).
+     */
+    bool concealing() const { return lost_samples > 0; }
+
+    Stats getStats() const;
+
+private:
+    int16_t *history;     // last history_len decoded samples, oldest first
+    size_t history_len;
+    size_t history_fill;
+    size_t min_period;
+    size_t max_period;
+    size_t hold_samples;  // full-level repetition
+    size_t fade_samples;  // then linear fade to silence
+    size_t overlap_samples;
+
+    // Current loss
+    size_t lost_samples;  // synthesized so far (0 = not concealing)
+    size_t period;
+    size_t period_pos;    // next sample of the repeated period
+
+    std::atomic<uint32_t> concealed_frames;
+    std::atomic<uint32_t> native_frames;
+    std::atomic<uint32_t> faded_out;
+    std::atomic<uint32_t> recoveries;
+
+    void remember(const int16_t *pcm, size_t samples);
+    size_t findPeriod() const;
+    int16_t nextSample();
+};
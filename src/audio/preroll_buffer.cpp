@@ -0,0 +1,43 @@
+#include "audio/preroll_buffer.h"
+#include "audio/audio_alloc.h"
+
+#include <string.h>
+
+PrerollBuffer::PrerollBuffer()
+    : pcm_storage(nullptr), timestamps(nullptr), lengths(nullptr), capacity(0), block_samples(0), next(0), count(0) {
+}
+
+PrerollBuffer::~PrerollBuffer() {
+    if (pcm_storage) free(pcm_storage);
+    if (timestamps) free(timestamps);
+    if (lengths) free(lengths);
+}
+
+bool PrerollBuffer::begin(size_t blocks, size_t samples_per_block) {
+    if (blocks == 0) return true;
+    pcm_storage = (int16_t *)audio_alloc_psram(blocks * samples_per_block * sizeof(int16_t));
+    timestamps = (uint32_t *)audio_alloc_psram(blocks * sizeof(uint32_t));
+    lengths = (uint16_t *)audio_alloc_psram(blocks * sizeof(uint16_t));
+    if (!pcm_storage || !timestamps || !lengths) return false;
+    capacity = blocks;
+    block_samples = samples_per_block;
+    return true;
+}
+
+void PrerollBuffer::write(const int16_t *pcm, size_t samples, uint32_t capture_us) {
+    if (capacity == 0) return;
+    if (samples > block_samples) samples = block_samples;
+    memcpy(pcm_storage + next * block_samples, pcm, samples * sizeof(int16_t));
+    timestamps[next] = capture_us;
+    lengths[next] = (uint16_t)samples;
+    next = (next + 1) % capacity;
+    if (count < capacity) count++;
+}
+
+const int16_t *PrerollBuffer::block(size_t i, size_t *samples, uint32_t *capture_us) const {
+    if (i >= count) return nullptr;
+    size_t slot = (next + capacity - count + i) % capacity;
+    *samples = lengths[slot];
+    *capture_us = timestamps[slot];
+    return pcm_storage + slot * block_samples;
+}
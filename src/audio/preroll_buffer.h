@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Short history of captured PCM blocks kept while not transmitting.
+ *
+ * The capture task writes every block here while idle; on key-up the history
+ * is replayed (oldest first, with the original capture timestamps) ahead of
+ * live audio so the first syllable is not lost to button/network latency.
+ * Single-threaded: owned by the capture task.
+ */
+class PrerollBuffer {
+public:
+    PrerollBuffer();
+    ~PrerollBuffer();
+
+    /**
+     * @brief Allocate room for @p blocks blocks of @p block_samples samples (PSRAM preferred).
+     * @return true on success (0 blocks is valid and disables pre-roll)
+     */
+    bool begin(size_t blocks, size_t block_samples);
+
+    /**
+     * @brief Store one block, overwriting the oldest when full.
+     */
+    void write(const int16_t *pcm, size_t samples, uint32_t capture_us);
+
+    /**
+     * @brief Number of stored blocks.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Access stored block @p i (0 = oldest).
+     * @return Block samples, or nullptr if out of range
+     */
+    const int16_t *block(size_t i, size_t *samples, uint32_t *capture_us) const;
+
+    /**
+     * @brief Forget the history (after it was flushed).
+     */
+    void clear() { count = 0; }
+
+private:
+    int16_t *pcm_storage;
+    uint32_t *timestamps;
+    uint16_t *lengths;
+    size_t capacity;
+    size_t block_samples;
+    size_t next;  // slot written next
+    size_t count; // valid blocks
+};
@@ -0,0 +1,116 @@
+#include "audio/redundancy.h"
+
+#include <string.h>
+
+// Loss (percent of frames) that calls for one / two copies per frame
+static const uint32_t LEVEL1_LOSS_PCT = 1;
+static const uint32_t LEVEL2_LOSS_PCT = 5;
+// Consecutive reports below the current level's threshold before stepping down
+static const uint8_t STEP_DOWN_REPORTS = 3;
+
+bool audio_red_parse(const uint8_t *data, size_t len, AudioRedBlock *blocks, uint8_t *count,
+                     const uint8_t **primary, size_t *primary_len) {
+    if (len < 1 || data[0] > AUDIO_RED_MAX_LEVEL) return false;
+    uint8_t n = data[0];
+    size_t prefix = audio_red_prefix_bytes(n);
+    if (len < prefix) return false;
+
+    size_t copies_len = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        const uint8_t *h = data + 1 + (size_t)i * AUDIO_RED_BLOCK_HEADER_BYTES;
+        blocks[i].distance = h[0];
+        blocks[i].codec = h[1];
+        blocks[i].len = (uint16_t)(h[2] | (h[3] << 8));
+        if (blocks[i].distance == 0) return false;
+        copies_len += blocks[i].len;
+    }
+    if (len < prefix + copies_len) return false;
+
+    *primary = data + prefix;
+    *primary_len = len - prefix - copies_len;
+    const uint8_t *p = *primary + *primary_len;
+    for (uint8_t i = 0; i < n; i++) {
+        blocks[i].data = p;
+        p += blocks[i].len;
+    }
+    *count = n;
+    return true;
+}
+
+RedundancyEncoder::RedundancyEncoder() : copies(), stored(0) {
+}
+
+uint8_t RedundancyEncoder::blocksFor(uint8_t level) const {
+    if (level > AUDIO_RED_MAX_LEVEL) level = AUDIO_RED_MAX_LEVEL;
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < level && i < stored; i++) {
+        if (copies[i].len > 0) n++;
+    }
+    return n;
+}
+
+size_t RedundancyEncoder::copyBytes(uint8_t blocks) const {
+    size_t bytes = 0;
+    for (uint8_t i = 0, n = 0; i < stored && n < blocks; i++) {
+        if (copies[i].len == 0) continue;
+        bytes += copies[i].len;
+        n++;
+    }
+    return bytes;
+}
+
+size_t RedundancyEncoder::pack(uint8_t *out, size_t primary_len, uint8_t blocks) const {
+    out[0] = blocks;
+    uint8_t *tail = out + audio_red_prefix_bytes(blocks) + primary_len;
+    for (uint8_t i = 0, n = 0; i < stored && n < blocks; i++) {
+        const Copy &c = copies[i];
+        if (c.len == 0) continue; // that frame had no copy: skip, distances stay exact
+        uint8_t *h = out + 1 + (size_t)n * AUDIO_RED_BLOCK_HEADER_BYTES;
+        h[0] = (uint8_t)(i + 1);
+        h[1] = c.codec;
+        h[2] = (uint8_t)c.len;
+        h[3] = (uint8_t)(c.len >> 8);
+        memcpy(tail, c.data, c.len);
+        tail += c.len;
+        n++;
+    }
+    return (size_t)(tail - out);
+}
+
+void RedundancyEncoder::remember(uint8_t codec, const uint8_t *data, size_t len) {
+    memmove(&copies[1], &copies[0], sizeof(Copy) * (AUDIO_RED_MAX_LEVEL - 1));
+    Copy &c = copies[0];
+    c.codec = codec;
+    c.len = (len > 0 && len <= AUDIO_RED_MAX_COPY_BYTES) ? (uint16_t)len : 0;
+    if (c.len) memcpy(c.data, data, c.len);
+    if (stored < AUDIO_RED_MAX_LEVEL) stored++;
+}
+
+RedundancyController::RedundancyController() : max_level(0), clean_reports(0), current(0) {
+}
+
+void RedundancyController::begin(uint8_t highest) {
+    max_level = highest > AUDIO_RED_MAX_LEVEL ? AUDIO_RED_MAX_LEVEL : highest;
+    clean_reports = 0;
+    current.store(0, std::memory_order_relaxed);
+}
+
+uint8_t RedundancyController::onLossReport(uint32_t lost, uint32_t received) {
+    uint32_t total = lost + received;
+    if (total == 0) return level();
+
+    uint32_t pct = (uint32_t)(((uint64_t)lost * 100 + total - 1) / total); // rounded up: any loss counts
+    uint8_t wanted = pct >= LEVEL2_LOSS_PCT ? 2 : pct >= LEVEL1_LOSS_PCT ? 1 : 0;
+    if (wanted > max_level) wanted = max_level;
+
+    uint8_t now = level();
+    if (wanted >= now) {
+        clean_reports = 0;
+        now = wanted;
+    } else if (++clean_reports >= STEP_DOWN_REPORTS) {
+        clean_reports = 0;
+        now--;
+    }
+    current.store(now, std::memory_order_relaxed);
+    return now;
+}
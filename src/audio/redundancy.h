@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Most redundant copies carried by one frame
+#define AUDIO_RED_MAX_LEVEL 2
+// Larger copies are not carried (a raw PCM frame's ADPCM copy is ~132 bytes)
+#define AUDIO_RED_MAX_COPY_BYTES 256
+#define AUDIO_RED_BLOCK_HEADER_BYTES 4
+
+/**
+ * @brief One redundant copy of an earlier frame.
+ */
+struct AudioRedBlock {
+    uint8_t distance;    // how many frames back (1 = the previous frame)
+    uint8_t codec;       // AudioCodecId of the copy
+    uint16_t len;
+    const uint8_t *data;
+};
+
+/*
+ * Payload of a frame in a burst announced with "red":1 (after the frame
+ * header, see audio_frame.h), in the spirit of RFC 2198:
+ *
+ *   byte 0       block count R (0..AUDIO_RED_MAX_LEVEL)
+ *   R x 4 bytes  distance, codec id, length (u16 little-endian)
+ *   primary      this frame's own payload
+ *   R copies     in header order
+ *
+ * Opus and IMA-ADPCM frames are already compact, so their copy is the
+ * earlier frame's payload itself; raw PCM frames carry an ADPCM copy.
+ */
+
+/**
+ * @brief Bytes in front of the primary for @p blocks copies.
+ */
+static inline size_t audio_red_prefix_bytes(uint8_t blocks) {
+    return 1 + (size_t)blocks * AUDIO_RED_BLOCK_HEADER_BYTES;
+}
+
+/**
+ * @brief Split a redundant payload into its primary and copies.
+ * @param blocks Receives up to AUDIO_RED_MAX_LEVEL copies (pointing into @p data)
+ * @return false if the payload is malformed
+ */
+bool audio_red_parse(const uint8_t *data, size_t len, AudioRedBlock *blocks, uint8_t *count,
+                     const uint8_t **primary, size_t *primary_len);
+
+/**
+ * @brief Capture side: remembers the redundant copies of recent frames and
+ * attaches them to the next ones.
+ *
+ * Every emitted frame (also one dropped on a full TX ring) must be followed
+ * by remember(), so copies stay aligned with sequence numbers. Single-threaded:
+ * owned by the capture task.
+ */
+class RedundancyEncoder {
+public:
+    RedundancyEncoder();
+
+    /**
+     * @brief Forget stored copies (start of a burst).
+     */
+    void reset() { stored = 0; }
+
+    /**
+     * @brief Copies that pack() would attach at @p level.
+     */
+    uint8_t blocksFor(uint8_t level) const;
+
+    /**
+     * @brief Total payload bytes of the first @p blocks copies.
+     */
+    size_t copyBytes(uint8_t blocks) const;
+
+    /**
+     * @brief Write the redundancy prefix at @p out and append the copies
+     * after a primary of @p primary_len bytes already encoded at
+     * out + audio_red_prefix_bytes(blocks).
+     * @return Total payload length
+     */
+    size_t pack(uint8_t *out, size_t primary_len, uint8_t blocks) const;
+
+    /**
+     * @brief Store the copy of the frame just emitted (@p len 0: no copy).
+     */
+    void remember(uint8_t codec, const uint8_t *data, size_t len);
+
+private:
+    struct Copy {
+        uint8_t codec;
+        uint16_t len;
+        uint8_t data[AUDIO_RED_MAX_COPY_BYTES];
+    };
+
+    Copy copies[AUDIO_RED_MAX_LEVEL]; // [0] = previous frame
+    uint8_t stored;
+};
+
+/**
+ * @brief Talker side: picks the redundancy level from listeners' loss reports.
+ *
+ * Any report above a loss threshold raises the level at once; stepping down
+ * takes several clean reports in a row, so a flaky link does not oscillate.
+ * Reports come from the network task; the capture task reads level().
+ */
+class RedundancyController {
+public:
+    RedundancyController();
+
+    /**
+     * @brief Set the highest level allowed (0 disables redundancy) and restart at 0.
+     */
+    void begin(uint8_t highest);
+
+    /**
+     * @brief Account one listener report.
+     * @param lost     Frames the listener found missing since its last report
+     * @param received Frames it received in the same period
+     * @return The new level
+     */
+    uint8_t onLossReport(uint32_t lost, uint32_t received);
+
+    uint8_t level() const { return current.load(std::memory_order_relaxed); }
+
+private:
+    uint8_t max_level;
+    uint8_t clean_reports;
+    std::atomic<uint8_t> current;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+#include "audio/audio_alloc.h"
+
+/**
+ * @brief Lock-free single-producer / single-consumer ring of fixed-size elements.
+ *
+ * Storage is allocated once in PSRAM (fallback: default heap). Elements are
+ * written and read in place (acquireWrite/commitWrite, peek/release) so large
+ * audio frames are copied only once. The producer never blocks: a full ring
+ * is reported as an overflow and the caller drops its element.
+ *
+ * Counters:
+ * - overflows:  acquireWrite() calls that found the ring full (producer)
+ * - drops:      elements the consumer discarded without using (consumer)
+ * - high_water: largest fill level observed since begin()
+ */
+template <typename T>
+class SpscRing {
+public:
+    struct Stats {
+        uint32_t capacity;
+        uint32_t depth;
+        uint32_t high_water;
+        uint32_t pushed;
+        uint32_t overflows;
+        uint32_t drops;
+    };
+
+    SpscRing() : items(nullptr), capacity(0), head(0), tail(0), high_water(0), pushed(0), overflows(0), drops(0) {}
+    ~SpscRing() { if (items) free(items); }
+
+    /**
+     * @brief Allocate storage for @p count elements.
+     * @return true on success
+     */
+    bool begin(uint32_t count) {
+        if (items || count == 0) return false;
+        items = (T *)audio_alloc_psram(sizeof(T) * count);
+        if (!items) return false;
+        capacity = count;
+        return true;
+    }
+
+    // ---- Producer side ----
+
+    /**
+     * @brief Reserve the next free element, or nullptr if the ring is full.
+     */
+    T *acquireWrite() {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (!items || h - t >= capacity) {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &items[h % capacity];
+    }
+
+    /**
+     * @brief Publish the element returned by the last acquireWrite().
+     */
+    void commitWrite() {
+        uint32_t h = head.load(std::memory_order_relaxed) + 1;
+        head.store(h, std::memory_order_release);
+        pushed.fetch_add(1, std::memory_order_relaxed);
+        uint32_t depth = h - tail.load(std::memory_order_relaxed);
+        if (depth > high_water.load(std::memory_order_relaxed)) {
+            high_water.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+    // ---- Consumer side ----
+
+    /**
+     * @brief Oldest queued element, or nullptr if the ring is empty.
+     */
+    T *peek() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return nullptr;
+        return &items[t % capacity];
+    }
+
+    /**
+     * @brief Consume the element returned by peek().
+     */
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Consume the element returned by peek() and count it as dropped.
+     */
+    void discard() {
+        drops.fetch_add(1, std::memory_order_relaxed);
+        release();
+    }
+
+    // ---- Either side ----
+
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    Stats getStats() const {
+        Stats st;
+        st.capacity = capacity;
+        st.depth = size();
+        st.high_water = high_water.load(std::memory_order_relaxed);
+        st.pushed = pushed.load(std::memory_order_relaxed);
+        st.overflows = overflows.load(std::memory_order_relaxed);
+        st.drops = drops.load(std::memory_order_relaxed);
+        return st;
+    }
+
+private:
+    T *items;
+    uint32_t capacity;
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> high_water;
+    std::atomic<uint32_t> pushed;
+    std::atomic<uint32_t> overflows;
+    std::atomic<uint32_t> drops;
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+};
@@ -0,0 +1,108 @@
+#include "audio/vad.h"
+
+#include <math.h>
+
+// Speech: energy this many times the noise level (6 dB)...
+static const uint32_t SPEECH_RATIO = 4;
+// ...or twice it (3 dB) with a zero-crossing rate of unvoiced consonants
+static const uint32_t FRICATIVE_RATIO = 2;
+static const uint32_t FRICATIVE_MIN_ZCR_PCT = 30;
+// Frames quieter than -60 dBov are never speech; the noise level stays above -80 dBov
+static const uint32_t MIN_SPEECH_ENERGY = 1074;
+static const uint32_t MIN_NOISE_ENERGY = 11;
+// Noise tracking: fall by 1/4 of the difference per quieter frame, drift up by 1/512 per frame
+static const uint32_t NOISE_FALL_SHIFT = 2;
+static const uint32_t NOISE_RISE_SHIFT = 9;
+static const uint32_t HANGOVER_MS = 200;
+
+void vad_frame_features(const int16_t *pcm, size_t samples, uint32_t *energy, uint32_t *crossings) {
+    uint64_t sum = 0;
+    uint32_t zc = 0;
+    size_t i = 0;
+    // Two products fit a 32-bit partial sum (2 * 2^30 = 2^31 at worst); four would wrap
+    for (; i + 4 <= samples; i += 4) {
+        int32_t a = pcm[i], b = pcm[i + 1], c = pcm[i + 2], d = pcm[i + 3];
+        sum += (uint32_t)(a * a) + (uint32_t)(b * b);
+        sum += (uint32_t)(c * c) + (uint32_t)(d * d);
+        // Sign bits differ: a crossing between neighbours
+        zc += ((uint32_t)(a ^ b) >> 31) + ((uint32_t)(b ^ c) >> 31) + ((uint32_t)(c ^ d) >> 31);
+        if (i + 4 < samples) zc += (uint32_t)(d ^ pcm[i + 4]) >> 31;
+    }
+    for (; i < samples; i++) {
+        int32_t a = pcm[i];
+        sum += (uint32_t)(a * a);
+        if (i + 1 < samples) zc += (uint32_t)(a ^ pcm[i + 1]) >> 31;
+    }
+    *energy = samples ? (uint32_t)(sum / samples) : 0;
+    *crossings = zc;
+}
+
+uint8_t vad_energy_to_dbov(uint32_t energy) {
+    if (energy == 0) return 127;
+    // Full scale: a square wave at +-32768 (mean square 2^30)
+    float db = 10.0f * log10f((float)energy / 1073741824.0f);
+    if (db >= 0.0f) return 0;
+    if (db <= -127.0f) return 127;
+    return (uint8_t)(-db + 0.5f);
+}
+
+VoiceActivityDetector::VoiceActivityDetector()
+    : hangover_samples(0), hangover_left(0), active(false), frame_energy(0), noise_energy(MIN_NOISE_ENERGY), frames(0),
+      speech_frames(0), onsets(0), noise_snapshot(MIN_NOISE_ENERGY) {
+}
+
+void VoiceActivityDetector::begin(uint32_t sample_rate) {
+    hangover_samples = (size_t)sample_rate * HANGOVER_MS / 1000;
+    hangover_left = 0;
+    active = false;
+    // Start high so the first (quiet) frames pull it down instead of reading as speech
+    noise_energy = MIN_SPEECH_ENERGY;
+}
+
+bool VoiceActivityDetector::process(const int16_t *pcm, size_t samples) {
+    uint32_t crossings;
+    vad_frame_features(pcm, samples, &frame_energy, &crossings);
+    frames.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t noise = noise_energy;
+    bool loud = frame_energy >= MIN_SPEECH_ENERGY && frame_energy > noise * SPEECH_RATIO;
+    bool fricative = frame_energy >= MIN_SPEECH_ENERGY && frame_energy > noise * FRICATIVE_RATIO &&
+                     (uint64_t)crossings * 100 >= (uint64_t)samples * FRICATIVE_MIN_ZCR_PCT;
+    bool raw = loud || fricative;
+
+    if (frame_energy < noise_energy) {
+        noise_energy -= (noise_energy - frame_energy) >> NOISE_FALL_SHIFT;
+    } else if (!raw) {
+        noise_energy += ((frame_energy - noise_energy) >> 4) + (noise_energy >> NOISE_RISE_SHIFT) + 1;
+    } else {
+        noise_energy += (noise_energy >> NOISE_RISE_SHIFT) + 1;
+    }
+    if (noise_energy < MIN_NOISE_ENERGY) noise_energy = MIN_NOISE_ENERGY;
+    noise_snapshot.store(noise_energy, std::memory_order_relaxed);
+
+    if (raw) {
+        if (!active) onsets.fetch_add(1, std::memory_order_relaxed);
+        hangover_left = hangover_samples;
+        active = true;
+    } else if (hangover_left > 0) {
+        hangover_left = hangover_left > samples ? hangover_left - samples : 0;
+    } else {
+        active = false;
+    }
+    if (active) speech_frames.fetch_add(1, std::memory_order_relaxed);
+    return active;
+}
+
+float VoiceActivityDetector::snrDb() const {
+    if (frame_energy <= noise_energy) return 0.0f;
+    return 10.0f * log10f((float)frame_energy / (float)noise_energy);
+}
+
+VoiceActivityDetector::Stats VoiceActivityDetector::getStats() const {
+    Stats st;
+    st.frames = frames.load(std::memory_order_relaxed);
+    st.speech_frames = speech_frames.load(std::memory_order_relaxed);
+    st.onsets = onsets.load(std::memory_order_relaxed);
+    st.noise_dbov = vad_energy_to_dbov(noise_snapshot.load(std::memory_order_relaxed));
+    return st;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Frame energy and zero crossings of a block of 16-bit PCM.
+ *
+ * The one pass over the samples that voice detection needs, unrolled by
+ * four with 32-bit partial sums; about 2 cycles per sample on the S3.
+ * @param energy    Receives the mean square (0 .. 2^30)
+ * @param crossings Receives the number of sign changes
+ */
+void vad_frame_features(const int16_t *pcm, size_t samples, uint32_t *energy, uint32_t *crossings);
+
+/**
+ * @brief Energy / zero-crossing voice activity detector.
+ *
+ * Tracks the background noise level and calls a frame speech when its
+ * energy is well above it, or moderately above it with the high
+ * zero-crossing rate of unvoiced consonants ("s", "f"), which energy
+ * alone would clip. A hangover keeps the decision on for a while after
+ * the last speech frame, so word endings and short pauses go through.
+ *
+ * The noise level falls quickly to quieter frames and creeps up slowly,
+ * so a fan switched on is learned within seconds while speech never is.
+ * Runs on every captured frame (also while idle, to stay calibrated).
+ * Single-threaded: owned by the capture task; counters may be read elsewhere.
+ */
+class VoiceActivityDetector {
+public:
+    struct Stats {
+        uint32_t frames;
+        uint32_t speech_frames; // including hangover
+        uint32_t onsets;        // silence -> speech transitions
+        uint8_t noise_dbov;     // background level, -dBov
+    };
+
+    VoiceActivityDetector();
+
+    /**
+     * @brief Set the sample rate (hangover length) and forget the noise level.
+     */
+    void begin(uint32_t sample_rate);
+
+    /**
+     * @brief Classify one frame.
+     * @return true for speech (or within the hangover after it)
+     */
+    bool process(const int16_t *pcm, size_t samples);
+
+    bool speech() const { return active; }
+
+    /**
+     * @brief Last frame's energy over the noise level, in dB (0 if not above).
+     */
+    float snrDb() const;
+
+    /**
+     * @brief Last frame's mean square and the current noise level (mean square).
+     */
+    uint32_t frameEnergy() const { return frame_energy; }
+    uint32_t noiseEnergy() const { return noise_energy; }
+
+    Stats getStats() const;
+
+private:
+    size_t hangover_samples;
+    size_t hangover_left;   // samples of hangover still to run
+    bool active;
+    uint32_t frame_energy;
+    uint32_t noise_energy;
+
+    std::atomic<uint32_t> frames;
+    std::atomic<uint32_t> speech_frames;
+    std::atomic<uint32_t> onsets;
+    std::atomic<uint32_t> noise_snapshot;
+};
+
+/**
+ * @brief Level of a mean square in -dBov (0 = full scale, 127 = floor), as
+ * used by comfort noise descriptors.
+ */
+uint8_t vad_energy_to_dbov(uint32_t energy);
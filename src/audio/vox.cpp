@@ -0,0 +1,65 @@
+#include "audio/vox.h"
+
+#include <math.h>
+
+// Quieter frames never key up, however still the room (-55 dBov)
+static const uint32_t MIN_OPEN_ENERGY = 3396;
+
+static uint32_t db_to_ratio_q8(uint8_t db) {
+    return (uint32_t)lrintf(256.0f * powf(10.0f, db / 10.0f));
+}
+
+VoxGate::VoxGate()
+    : open_ratio_q8(0), close_ratio_q8(0), attack_samples(0), hang_samples(0), attack_run(0), hang_left(0),
+      is_keyed(false), opens(0), keyed_frames(0), rejected(0) {
+}
+
+void VoxGate::begin(const Config &config, uint32_t sample_rate) {
+    uint8_t close_db = config.close_db < config.open_db ? config.close_db : config.open_db;
+    open_ratio_q8 = db_to_ratio_q8(config.open_db);
+    close_ratio_q8 = db_to_ratio_q8(close_db);
+    attack_samples = (size_t)sample_rate * config.attack_ms / 1000;
+    hang_samples = (size_t)sample_rate * config.hang_ms / 1000;
+    release();
+}
+
+bool VoxGate::process(uint32_t frame_energy, uint32_t noise_energy, size_t samples) {
+    uint64_t energy_q8 = (uint64_t)frame_energy << 8;
+
+    if (!is_keyed) {
+        if (frame_energy >= MIN_OPEN_ENERGY && energy_q8 > (uint64_t)noise_energy * open_ratio_q8) {
+            attack_run += samples;
+            if (attack_run >= attack_samples) {
+                is_keyed = true;
+                hang_left = hang_samples;
+                opens.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            if (attack_run > 0) rejected.fetch_add(1, std::memory_order_relaxed);
+            attack_run = 0;
+        }
+    } else if (energy_q8 > (uint64_t)noise_energy * close_ratio_q8) {
+        hang_left = hang_samples;
+    } else if (hang_left > samples) {
+        hang_left -= samples;
+    } else {
+        release();
+    }
+
+    if (is_keyed) keyed_frames.fetch_add(1, std::memory_order_relaxed);
+    return is_keyed;
+}
+
+void VoxGate::release() {
+    is_keyed = false;
+    attack_run = 0;
+    hang_left = 0;
+}
+
+VoxGate::Stats VoxGate::getStats() const {
+    Stats st;
+    st.opens = opens.load(std::memory_order_relaxed);
+    st.keyed_frames = keyed_frames.load(std::memory_order_relaxed);
+    st.rejected = rejected.load(std::memory_order_relaxed);
+    return st;
+}
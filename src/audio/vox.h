@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Voice-operated transmit (VOX) key decision.
+ *
+ * Works on the per-frame energy and noise level the VAD (audio/vad.h)
+ * already computed, so it adds a few integer compares per frame. The key
+ * opens when frames stay open_db above the noise for attack_ms, so a
+ * single click or door bang does not key up. It then stays down as long
+ * as frames are at least close_db above the noise. The close threshold is
+ * lower than the open one, so a talker's fading syllables do not chop the
+ * key. After hang_ms below it, the key is released.
+ *
+ * Single-threaded: owned by the capture task; counters may be read elsewhere.
+ */
+class VoxGate {
+public:
+    struct Config {
+        uint8_t open_db;    // frame over noise needed to key up
+        uint8_t close_db;   // frame over noise that keeps the key down (< open_db)
+        uint16_t attack_ms; // how long open_db must hold before keying up
+        uint16_t hang_ms;   // release after this long below close_db
+    };
+
+    struct Stats {
+        uint32_t opens;        // key-ups
+        uint32_t keyed_frames; // frames while keyed
+        uint32_t rejected;     // openings shorter than attack_ms
+    };
+
+    VoxGate();
+
+    void begin(const Config &config, uint32_t sample_rate);
+
+    /**
+     * @brief Account one frame.
+     * @param frame_energy Mean square of the frame (VoiceActivityDetector::frameEnergy)
+     * @param noise_energy Background mean square (VoiceActivityDetector::noiseEnergy)
+     * @return true while the key is down
+     */
+    bool process(uint32_t frame_energy, uint32_t noise_energy, size_t samples);
+
+    /**
+     * @brief Drop the key at once (VOX switched off, link lost, PTT took over).
+     */
+    void release();
+
+    bool keyed() const { return is_keyed; }
+
+    Stats getStats() const;
+
+private:
+    uint32_t open_ratio_q8;  // 10^(open_db/10) << 8
+    uint32_t close_ratio_q8;
+    size_t attack_samples;
+    size_t hang_samples;
+    size_t attack_run;       // samples above open_db so far (not keyed)
+    size_t hang_left;        // samples until release (keyed)
+    bool is_keyed;
+
+    std::atomic<uint32_t> opens;
+    std::atomic<uint32_t> keyed_frames;
+    std::atomic<uint32_t> rejected;
+};
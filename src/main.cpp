@@ -9,10 +9,22 @@
  * Functionality:
  * - Connects to WiFi and authenticates with the server to obtain a token.
  * - Connects to the WebSocket server for PTT.
- * - Uses BUTTON A as a physical "Hold-to-Talk" (PTT) button.
- * - Captures 16kHz/16-bit audio from I2S mic while PTT is pressed.
- * - Sends audio as WebSocket binary messages.
- * - Receives binary audio from WebSocket and plays it on I2S speaker.
+ * - Uses BUTTON A as a physical "Hold-to-Talk" (PTT) button, read through
+ *   the I/O expander's INT line (no polling).
+ * - Captures 16kHz audio from the I2S mic, as 16-bit samples or 32-bit
+ *   slots converted with a gain, while PTT is pressed (plus a short
+ *   pre-roll from just before the press), or hands-free under VOX.
+ * - Cleans the capture with a fixed-point DSP chain (DC blocker, high-pass,
+ *   AGC, limiter) and encodes it with the codec negotiated per session
+ *   (Opus, IMA ADPCM or raw PCM).
+ * - Queues captured audio in a lock-free ring; a network task sends it as
+ *   UDP media datagrams when the server offers them, else as WebSocket
+ *   binary messages.
+ * - Receives audio the same ways, gives each simultaneous talker its own
+ *   adaptive jitter buffer, decoder and concealment, and mixes them on the
+ *   I2S speaker from a dedicated task.
+ * - Full-duplex intercom mode: an acoustic echo canceller takes the
+ *   speaker's output back out of the microphone.
  * - Displays status (Connecting, Ready, Talking, Incoming) on LVGL screen.
  * - Uses RGB LED to indicate status (Green=Talking, Orange=Incoming).
  */
@@ -25,6 +37,7 @@
 #include <kodedot/display_manager.h>
 #include <TCA9555.h>
 #include <kodedot/pin_config.h>
+#include <kodedot/i2c_bus_manager.h>
 #include <Adafruit_NeoPixel.h>
 
 // Fonts are compiled as separate C translation units in src/fonts/
@@ -40,10 +53,31 @@ extern "C" {
 #include <WiFi.h>
 #include <ArduinoHttpClient.h>
 #include <WebSocketsClient.h>
+#include <WiFiUdp.h>
 #include <ArduinoJson.h>
-#include "driver/i2s.h"
+#include "driver/i2s_std.h"
+#include "esp_timer.h"
 #include <SD_MMC.h>
 #include <FS.h>
+#include "audio/jitter_buffer.h"
+#include "audio/spsc_ring.h"
+#include "audio/audio_packet.h"
+#include "audio/audio_frame.h"
+#include "audio/latency_probe.h"
+#include "audio/plc.h"
+#include "audio/redundancy.h"
+#include "audio/media_datagram.h"
+#include "audio/vad.h"
+#include "audio/comfort_noise.h"
+#include "audio/vox.h"
+#include "audio/pcm_convert.h"
+#include "audio/capture_dsp.h"
+#include "audio/audio_mixer.h"
+#include "audio/echo_canceller.h"
+#include "audio/echo_reference.h"
+#include "audio/audio_codec.h"
+#include "audio/preroll_buffer.h"
+#include "ui/ui_bus.h"
 
 // =================================================================
 // --- Font References (from your project) ---
@@ -65,6 +99,30 @@ String WIFI_PASS = "";
 String USERNAME = "";  // Will be filled with MAC
 String PASSWORD = "";  // Will be filled with MAC
 String FRIENDLY_NAME = "Kode_Dot_PTT"; // Will be read from General/PTT.json
+int PREROLL_MS = 200;                   // "Preroll_ms" in General/PTT.json (0 disables)
+String PREFERRED_CODEC = "opus";        // "Codec" in General/PTT.json: opus, adpcm or pcm (pcm is always the fallback)
+int REDUNDANCY_MAX = AUDIO_RED_MAX_LEVEL; // "Redundancy" in General/PTT.json: most frame copies per packet (0 disables)
+bool UDP_MEDIA = true;                  // "Udp_Media" in General/PTT.json: offer the UDP audio path
+bool DTX_ENABLED = true;                // "Dtx" in General/PTT.json: send no frames while the talker is silent
+bool VOX_ENABLED = false;               // "Vox" in General/PTT.json: start in hands-free (voice keyed) mode
+int VOX_HANG_MS = 800;                  // "Vox_Hang_ms" in General/PTT.json: silence before VOX unkeys
+int MIC_BITS = 16;                      // "Mic_Bits" in General/PTT.json: 32 reads the mic's native 24-in-32 slots
+int MIC_GAIN_DB = 0;                    // "Mic_Gain_dB" in General/PTT.json: 0..48 in 6 dB steps (32-bit capture)
+bool DSP_ENABLED = true;                // "Dsp" in General/PTT.json: DC blocker, high-pass, AGC and limiter on the mic
+int HPF_HZ = 100;                       // "Hpf_Hz" in General/PTT.json: high-pass corner, 0 = off
+bool AGC_ENABLED = true;                // "Agc" in General/PTT.json: level out quiet and loud talkers
+int AGC_MAX_GAIN_DB = 18;               // "Agc_Max_Gain_dB" in General/PTT.json: 0..24
+bool INTERCOM_ENABLED = false;          // "Intercom" in General/PTT.json: start in full-duplex intercom mode
+int AEC_TAIL_MS = 8;                    // "Aec_Tail_ms" in General/PTT.json: echo path the canceller covers, 4..32
+// "Talker_Gain_dB" in General/PTT.json: {"<device id>": dB, ...}, how loud each peer plays (-30..0)
+struct TalkerGain {
+    String id;
+    int8_t db;
+};
+const int TALKER_GAIN_MAX = 8;
+const int TALKER_GAIN_MIN_DB = -30;
+TalkerGain talkerGains[TALKER_GAIN_MAX];
+int talkerGainCount = 0;
 
 // =================================================================
 // --- Server and Client Configuration ---
@@ -86,8 +144,71 @@ const int BITS_PER_SAMPLE = 16;
 const int AUDIO_BUFFER_SAMPLES = 256;
 // Buffer size in bytes
 const int I2S_READ_BUFFER_BYTES = AUDIO_BUFFER_SAMPLES * (BITS_PER_SAMPLE / 8);
+// Capture and playback are separate i2s_std channels, each with its own DMA ring.
+// RX: one capture block per DMA buffer, so every on_recv event is one frame.
+const int I2S_RX_DMA_DESC = 4;
+const int I2S_RX_DMA_FRAMES = AUDIO_BUFFER_SAMPLES;
+// TX: 48 ms queued, sized for playout jitter without touching mic latency
+const int I2S_TX_DMA_DESC = 6;
+const int I2S_TX_DMA_FRAMES = 128;
+// Speaker amplifier lines: not in the BSP yet. Until they are, the TX
+// channel runs unrouted and only paces the playback task.
+#ifdef SPK_I2S_DOUT
+const gpio_num_t SPK_BCLK_PIN = (gpio_num_t)SPK_I2S_BCLK;
+const gpio_num_t SPK_WS_PIN = (gpio_num_t)SPK_I2S_WS;
+const gpio_num_t SPK_DOUT_PIN = (gpio_num_t)SPK_I2S_DOUT;
+#else
+const gpio_num_t SPK_BCLK_PIN = I2S_GPIO_UNUSED;
+const gpio_num_t SPK_WS_PIN = I2S_GPIO_UNUSED;
+const gpio_num_t SPK_DOUT_PIN = I2S_GPIO_UNUSED;
+#endif
+i2s_chan_handle_t i2sRxChan = NULL; // read by i2s_read_task only
+i2s_chan_handle_t i2sTxChan = NULL; // written by playback_task only
+// Set from the channels' DMA event callbacks (ISR context)
+volatile uint32_t i2sRxBuffers = 0;   // RX DMA buffers completed
+volatile uint32_t i2sRxDoneUs = 0;    // esp_timer time of the last one
+volatile uint32_t i2sRxOverflows = 0; // RX buffers overwritten before they were read
+volatile uint32_t i2sTxUnderruns = 0; // TX ring ran dry (zeros played)
+volatile uint32_t i2sTxDoneUs = 0;    // esp_timer time the last TX DMA buffer finished playing
 // Buffer to read from microphone
 int16_t i2s_read_buffer[AUDIO_BUFFER_SAMPLES];
+// 32-bit capture (audio/pcm_convert.h): raw slots, converted into i2s_read_buffer
+const int MIC_GAIN_MAX_DB = (PCM_CONVERT_UNITY_SHIFT - PCM_CONVERT_MIN_SHIFT) * 6;
+int32_t i2s_slot_buffer[AUDIO_BUFFER_SAMPLES];
+// Capture clean-up (audio/capture_dsp.h), before the VAD, pre-roll and encoder see the audio
+const int HPF_MAX_HZ = 400;
+const int AGC_GAIN_MAX_DB = 24;
+const int8_t AGC_TARGET_DBFS = -20;
+const int8_t LIMITER_CEILING_DBFS = -1;
+const uint8_t LIMITER_LOOKAHEAD_MS = 2;
+CaptureDsp txDsp; // i2s_read_task only
+// Pre-roll history replayed at key-up
+const int PREROLL_MAX_MS = 500;
+PrerollBuffer prerollBuffer;  // i2s_read_task only
+// Opus target bitrate (~10x less airtime than raw PCM's 256 kbit/s)
+const uint32_t OPUS_BITRATE = 16000;
+
+// --- Playout (jitter) buffer for incoming audio ---
+const uint16_t JITTER_SLOTS = 64;               // frames of storage (PSRAM)
+const uint16_t JITTER_MAX_FRAME_BYTES = 1024;   // larger payloads are split
+const uint16_t JITTER_MIN_TARGET_MS = 40;       // adaptive depth lower bound
+const uint16_t JITTER_MAX_TARGET_MS = 240;      // adaptive depth upper bound
+const uint16_t JITTER_MAX_LATENCY_MS = 400;     // older frames are dropped as late
+const unsigned long AUDIO_STATS_LOG_MS = 10000; // serial stats interval
+
+// --- Capture -> network ring ---
+const uint32_t TX_RING_PACKETS = 128;           // ~2 s of 16 ms frames (PSRAM)
+// Encoded frame popped from a jitter buffer, and the mixed block written to I2S
+uint8_t playback_payload[JITTER_MAX_FRAME_BYTES];
+const int PLAYBACK_MAX_SAMPLES = 960; // 60 ms, longest frame we play
+int16_t playback_buffer[AUDIO_BUFFER_SAMPLES];
+// Written when nothing is due, keeps I2S pacing the playback task
+const int16_t silence_buffer[AUDIO_BUFFER_SAMPLES] = {0};
+
+// --- Packet loss concealment (audio/plc.h) ---
+const uint16_t PLC_MAX_GAP_FRAMES = 6; // placeholders queued per sequence gap
+const uint32_t PLC_BRIDGE_MS = 60;     // longest underrun bridged mid-burst
+volatile bool rxTalkActive = false;    // some peer is between its talk_start and talk_stop
 
 // =================================================================
 // --- Global State Variables ---
@@ -99,18 +220,165 @@ HttpClient *httpClient = nullptr;
 WebSocketsClient webSocket;
 String globalToken;    // Authentication token
 String globalDeviceId; // ID of this device
-bool isWebSocketConnected = false;
+volatile bool isWebSocketConnected = false;
 unsigned long lastPingTime = 0;
+// Single owner of every WebSocket call (loop, sends, pings)
+TaskHandle_t networkTaskHandle = NULL;
+// Capture task enqueues, network task sends
+SpscRing<AudioPacket> txRing;
+
+// --- Codec negotiation ---
+// txCodec is chosen by the server's "caps_ack" (PCM until then / with old servers);
+// each receive stream follows the "codec" field of its talker's "talk_start".
+volatile AudioCodecId txCodec = AUDIO_CODEC_PCM16;
+AudioEncoder *txEncoders[AUDIO_CODEC_COUNT] = {nullptr}; // used by i2s_read_task only
+
+// --- Frame headers (audio/audio_frame.h) ---
+// txFrameVersion comes from "caps_ack" (0 = bare payloads); a receive
+// stream's from the "frame" field of its talker's "talk_start".
+volatile uint8_t txFrameVersion = 0;
+uint16_t txFrameSeq = 0;   // i2s_read_task only
+
+// --- Redundant frames (audio/redundancy.h) ---
+// Offered in "caps" ("red":1) and used once "caps_ack" confirms it. The number
+// of copies per frame follows the listeners' "loss_report" messages.
+const unsigned long LOSS_REPORT_MS = 2000; // listener report period while a redundant burst plays
+volatile bool txRedundancy = false;
+RedundancyEncoder txRedEncoder;            // i2s_read_task only
+RedundancyController txRedController;      // network task adapts, i2s_read_task reads the level
+AudioEncoder *txRedCopyEncoder = nullptr;  // ADPCM copies of raw PCM frames (i2s_read_task)
+
+// --- Discontinuous transmission (audio/vad.h, audio/comfort_noise.h) ---
+// Offered in "caps" ("dtx":1) and used once "caps_ack" confirms it: while the
+// VAD hears no speech, a burst carries sparse comfort noise descriptors
+// instead of frames, and listeners play matching noise.
+volatile bool txDtx = false;
+VoiceActivityDetector txVad;          // i2s_read_task only
+ComfortNoiseEncoder txCnEncoder;      // i2s_read_task only
+uint32_t txDtxSuppressed = 0;         // frames not sent, for the stats log
+
+// --- UDP media path (audio/media_datagram.h) ---
+// Audio frames skip TCP's head-of-line blocking once the server offers a
+// media port in "caps_ack" and answers our HELLO. Network task only.
+const unsigned long UDP_HELLO_MS = 500;       // HELLO retry period while not answered
+const int UDP_HELLO_ATTEMPTS = 10;            // then stay on the WebSocket for this session
+const unsigned long UDP_KEEPALIVE_MS = 15000; // keeps the NAT binding open
+const int UDP_KEEPALIVE_MISSES = 3;           // unanswered keepalives before falling back
+WiFiUDP mediaUdp;
+uint16_t mediaUdpPort = 0;  // from caps_ack (0 = no UDP path offered)
+uint32_t mediaUdpToken = 0;
+bool mediaUdpReady = false; // HELLO answered: audio goes out as datagrams
+int mediaUdpHellos = 0;     // HELLOs sent since the last answer
+unsigned long mediaUdpLastHello = 0;
+uint32_t mediaUdpTx = 0;    // datagram counters for the stats log
+uint32_t mediaUdpRx = 0;
+
+// --- Latency measurement (audio/latency_probe.h) ---
+// D-pad TOP toggles probe frames and the stats page. Listeners always answer
+// probes, so only the talker needs the mode on; loopback works with relay --echo.
+const uint8_t LATENCY_PAGE_PIN = EXPANDER_PAD_TOP;
+const uint32_t LATENCY_PROBE_MS = 1000; // one probe frame per second of talking
+LatencyProbe latencyProbe;
+String rxProbeTalkerId; // "from" of the talker whose probe we answer (network task only)
 
 // --- PTT State ---
 // 'volatile' is critical because these variables are modified
 // by tasks and read by others.
 volatile bool isPttActive = false;
 volatile bool pttStateChanged = false; // Flag to notify main loop
+volatile uint32_t pttEdgeTimeUs = 0;   // esp_timer time of the last PTT edge
+
+// --- VOX (audio/vox.h) ---
+// Hands-free transmit: the capture task keys up on voice exactly as if PTT
+// were held, from the VAD's energies of the frames it reads anyway.
+const uint8_t VOX_TOGGLE_PIN = EXPANDER_PAD_RIGHT;
+const uint8_t VOX_OPEN_DB = 12;     // over the noise floor to key up...
+const uint8_t VOX_CLOSE_DB = 6;     // ...and to stay keyed
+const uint16_t VOX_ATTACK_MS = 48;  // three frames: clicks and bangs do not key
+const int VOX_HANG_MIN_MS = 200;
+const int VOX_HANG_MAX_MS = 3000;
+volatile bool voxEnabled = false;   // loop() toggles, i2s_read_task reads
+volatile bool isVoxActive = false;  // keyed by voice (i2s_read_task writes)
+VoxGate txVox;                      // i2s_read_task only
+
+// --- Full-duplex intercom (audio/echo_canceller.h, audio/echo_reference.h) ---
+// Hands-free like VOX, but also while peers talk: the echo canceller takes
+// our speaker's output back out of the microphone first, so it neither
+// keys the transmitter nor goes back to the talkers. D-pad LEFT toggles.
+const uint8_t INTERCOM_TOGGLE_PIN = EXPANDER_PAD_LEFT;
+const int AEC_TAIL_MIN_MS = 4;
+const int AEC_TAIL_MAX_MS = 32;
+const uint8_t AEC_SUPPRESS_DB = 12;          // residual echo attenuation while only peers talk
+const uint32_t AEC_REF_LEAD_US = 1000;       // reference taken this early: timestamp error stays inside the filter
+const uint32_t AEC_REF_TOLERANCE_US = 1000;  // timestamp disagreement still treated as jitter
+volatile bool intercomEnabled = false;       // loop() toggles, i2s_read_task reads
+EchoCanceller txAec;                         // i2s_read_task only
+EchoReference echoReference;                 // playback_task writes, i2s_read_task reads
+int16_t aec_ref_buffer[AUDIO_BUFFER_SAMPLES];
+
+// --- Input (TCA9555 INT line) ---
+const uint32_t INPUT_DEBOUNCE_US = 20000;     // per-pin lockout after an accepted edge
+const uint32_t INPUT_FALLBACK_POLL_MS = 500;  // re-read even without INT (missed edge)
+// Buttons handled by ioexp_bus_job (all active-low, external pull-ups)
+const uint8_t INPUT_PINS[] = {
+    EXPANDER_BUTTON_BOTTOM, EXPANDER_PAD_TOP, EXPANDER_PAD_LEFT, EXPANDER_PAD_BOTTOM, EXPANDER_PAD_RIGHT
+};
+volatile uint32_t inputIrqTimeUs = 0; // Set by the ISR, read by ioexp_bus_job
+volatile bool inputIrqPending = false;
+
+// D-pad events (PTT is delivered through isPttActive instead)
+struct InputEvent {
+    uint8_t pin;      // EXPANDER_PAD_*
+    bool pressed;
+    uint32_t time_us; // edge timestamp (esp_timer)
+};
+QueueHandle_t inputEventQueue = NULL;
 
 // --- Incoming Audio State ---
 volatile unsigned long lastAudioReceiveTime = 0;
 volatile bool isReceivingAudio = false;
+unsigned long lastStatsLogTime = 0;
+
+// --- Receive streams (audio/audio_mixer.h) ---
+// Each talker heard at the same time gets its own stream: jitter buffer,
+// decoders, concealment and comfort noise. Servers that answer "mix":1 in
+// "caps_ack" put the talker's source id in front of every frame (and "src"
+// in talk_start / talk_stop); with older servers everything is source 0.
+// playback_task mixes the streams block by block; a talker beyond
+// RX_MAX_SOURCES is not heard until a stream frees up.
+const int RX_MAX_SOURCES = 3;
+struct RxSource {
+    // Only the network task claims and frees a stream: playback_task raises
+    // drained once the talker is gone and everything played, and then leaves it
+    volatile bool inUse = false;
+    volatile bool drained = false;
+    volatile bool talkActive = false;                // between its talk_start and talk_stop
+    uint8_t id = 0;                                  // "src" of the talker (0: server without mixing)
+    String talkerId;                                 // "from" of its talk_start (network task only)
+    volatile AudioCodecId codec = AUDIO_CODEC_PCM16; // "codec" of its talk_start
+    volatile uint8_t frameVersion = 0;               // "frame" of its talk_start
+    volatile bool redundancy = false;                // its talk_start carried "red":1
+    volatile uint16_t volumeQ15 = AUDIO_MIX_UNITY_Q15; // "Talker_Gain_dB" of the talker, on top of the mix share
+    AudioRxStats frameStats;                         // network task writes, loop() logs
+    AudioRxStats::Stats lossReported = {};           // sent in the last "loss_report" (network task)
+    unsigned long lastLossReport = 0;
+    JitterBuffer jitterBuffer;
+    ComfortNoiseGenerator comfortNoise;              // receive path updates, playback_task plays
+    AudioDecoder *decoders[AUDIO_CODEC_COUNT] = {nullptr}; // decode: playback_task only
+    PacketLossConcealer concealer;                   // playback_task only
+    // playback_task only (reset on claim): decoded audio not mixed yet, and what an underrun continues
+    int16_t pcm[AUDIO_BUFFER_SAMPLES + PLAYBACK_MAX_SAMPLES];
+    size_t pcmLen = 0;
+    AudioDecoder *lastDecoder = nullptr;
+    size_t lastFrameSamples = 0;
+    size_t bridgedSamples = 0;
+    bool cnPlaying = false;                          // comfort noise until the next frame plays
+    uint16_t gainQ15 = 0;                            // mix gain of the last block (0: not mixed yet)
+};
+RxSource rxSources[RX_MAX_SOURCES];
+volatile bool rxMix = false;   // caps_ack agreed to source ids
+AudioMixer rxMixer;            // playback_task only
+uint32_t rxSourcesBusy = 0;    // talkers turned away, every stream taken (network task)
 
 // --- Hardware Kode Dot ---
 // Create TCA9555 with address from BSP config
@@ -121,10 +389,50 @@ Adafruit_NeoPixel led_strip(NEO_PIXEL_COUNT, NEO_PIXEL_PIN, LED_STRIP_COLOR_ORDE
 // Display manager instance
 DisplayManager displayManager;
 
+// --- Display render strategy ---
+// SRAM stripes keep LVGL rendering out of PSRAM (audio buffers live there);
+// the stripe height is picked by a short benchmark once the UI exists.
+const DisplayManager::RenderStrategy RENDER_STRATEGY = DisplayManager::RENDER_SRAM_STRIPES;
+const uint32_t STRIPE_TUNE_FRAMES = 4;     // full redraws per candidate height
+const bool RENDER_BENCHMARK = false;       // log fps / PSRAM traffic of both strategies at boot
+const uint32_t RENDER_BENCHMARK_FRAMES = 20;
+
+// --- Shared I2C bus (touch + IO expander + PMIC/fuel gauge) ---
+// After setup() every transaction goes through the bus task (Core 0).
+I2CBusManager i2cBus;
+int ioexpBusId = -1;
+int touchBusId = -1;
+int fuelGaugeBusId = -1;
+int chargerBusId = -1;
+const uint32_t TOUCH_POLL_MS = 20;        // touch has no INT line (TOUCH_INT = -1)
+const uint32_t TELEMETRY_POLL_MS = 5000;  // battery / charger status
+
+// --- Battery telemetry (written by fuel_gauge_bus_job / charger_bus_job) ---
+volatile uint16_t batteryMillivolts = 0;
+volatile uint8_t batteryPercent = 0;
+volatile uint8_t chargerStatus = 0;       // BQ25896 CHRG_STAT: 0 idle, 1 pre, 2 fast, 3 done
+
 // --- UI (LVGL) ---
+// Owned by ui_task once it runs; other tasks go through uiBus
 lv_obj_t *lblStatus;
 lv_obj_t *lblPttStatus;
 lv_obj_t *lblIncomingStatus;
+lv_obj_t *lblStats;
+
+// --- UI task ---
+// LVGL is not thread-safe: after setup only ui_task calls into it.
+UiBus uiBus;
+const uint32_t UI_BUS_SLOTS = 16;      // messages per producer
+const uint32_t UI_FRAME_MS = 5;        // render loop period
+bool incomingShown = false;            // loop(): "INCOMING" currently displayed
+
+/**
+ * Status line update from setup()/loop() (the UI task renders it).
+ */
+void uiStatus(const char *text)
+{
+    uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_STATUS, text);
+}
 
 // =================================================================
 // --- LED Helper Functions (from template main.cpp) ---
@@ -166,11 +474,45 @@ String getDeviceMAC()
     return result;
 }
 
+void logRenderBench(const DisplayManager::RenderBenchResult &r)
+{
+    Serial.printf("[RENDER] %s %u lines: %.1f fps, %u us/frame, PSRAM draw traffic %.1f MB/s\n",
+                  r.strategy == DisplayManager::RENDER_SRAM_STRIPES ? "sram-stripes" : "psram-full",
+                  (unsigned)r.buffer_lines, r.fps, (unsigned)r.frame_us, r.psram_bytes_per_s / 1e6f);
+}
+
+/**
+ * Pick the stripe height for the real UI and, if RENDER_BENCHMARK is set,
+ * compare both render strategies on the same screen.
+ */
+void setupRenderStrategy()
+{
+    if (RENDER_BENCHMARK)
+    {
+        displayManager.setRenderStrategy(DisplayManager::RENDER_PSRAM_FULL);
+        logRenderBench(displayManager.benchmarkRender(RENDER_BENCHMARK_FRAMES));
+    }
+
+    if (RENDER_STRATEGY == DisplayManager::RENDER_SRAM_STRIPES || RENDER_BENCHMARK)
+    {
+        displayManager.tuneStripeHeight(STRIPE_TUNE_FRAMES);
+        if (RENDER_BENCHMARK)
+        {
+            logRenderBench(displayManager.benchmarkRender(RENDER_BENCHMARK_FRAMES));
+        }
+    }
+
+    // Leave the configured strategy in place
+    if (RENDER_STRATEGY == DisplayManager::RENDER_PSRAM_FULL && RENDER_BENCHMARK)
+    {
+        displayManager.setRenderStrategy(DisplayManager::RENDER_PSRAM_FULL);
+    }
+}
+
 bool readOrCreatePTTConfig()
 {
     Serial.println("Reading PTT.json from General/...");
-    lv_label_set_text(lblStatus, "Reading PTT.json...");
-    displayManager.update();
+    uiStatus("Reading PTT.json...");
 
     // Create General folder if it doesn't exist
     if (!SD_MMC.exists("/General"))
@@ -201,6 +543,93 @@ bool readOrCreatePTTConfig()
                     FRIENDLY_NAME = doc["Friendly_Name"].as<String>();
                     Serial.printf("Friendly Name read: %s\n", FRIENDLY_NAME.c_str());
                 }
+                if (doc.containsKey("Preroll_ms"))
+                {
+                    PREROLL_MS = constrain(doc["Preroll_ms"].as<int>(), 0, PREROLL_MAX_MS);
+                    Serial.printf("Pre-roll read: %d ms\n", PREROLL_MS);
+                }
+                if (doc.containsKey("Codec"))
+                {
+                    PREFERRED_CODEC = doc["Codec"].as<String>();
+                    Serial.printf("Codec read: %s\n", PREFERRED_CODEC.c_str());
+                }
+                if (doc.containsKey("Redundancy"))
+                {
+                    REDUNDANCY_MAX = constrain(doc["Redundancy"].as<int>(), 0, AUDIO_RED_MAX_LEVEL);
+                    Serial.printf("Redundancy read: %d\n", REDUNDANCY_MAX);
+                }
+                if (doc.containsKey("Udp_Media"))
+                {
+                    UDP_MEDIA = doc["Udp_Media"].as<bool>();
+                    Serial.printf("UDP media read: %s\n", UDP_MEDIA ? "on" : "off");
+                }
+                if (doc.containsKey("Dtx"))
+                {
+                    DTX_ENABLED = doc["Dtx"].as<bool>();
+                    Serial.printf("DTX read: %s\n", DTX_ENABLED ? "on" : "off");
+                }
+                if (doc.containsKey("Vox"))
+                {
+                    VOX_ENABLED = doc["Vox"].as<bool>();
+                    Serial.printf("VOX read: %s\n", VOX_ENABLED ? "on" : "off");
+                }
+                if (doc.containsKey("Vox_Hang_ms"))
+                {
+                    VOX_HANG_MS = constrain(doc["Vox_Hang_ms"].as<int>(), VOX_HANG_MIN_MS, VOX_HANG_MAX_MS);
+                    Serial.printf("VOX hang read: %d ms\n", VOX_HANG_MS);
+                }
+                if (doc.containsKey("Mic_Bits"))
+                {
+                    MIC_BITS = doc["Mic_Bits"].as<int>() == 32 ? 32 : 16;
+                    Serial.printf("Mic bits read: %d\n", MIC_BITS);
+                }
+                if (doc.containsKey("Mic_Gain_dB"))
+                {
+                    MIC_GAIN_DB = constrain(doc["Mic_Gain_dB"].as<int>(), 0, MIC_GAIN_MAX_DB);
+                    Serial.printf("Mic gain read: %d dB\n", MIC_GAIN_DB);
+                }
+                if (doc.containsKey("Dsp"))
+                {
+                    DSP_ENABLED = doc["Dsp"].as<bool>();
+                    Serial.printf("Capture DSP read: %s\n", DSP_ENABLED ? "on" : "off");
+                }
+                if (doc.containsKey("Hpf_Hz"))
+                {
+                    HPF_HZ = constrain(doc["Hpf_Hz"].as<int>(), 0, HPF_MAX_HZ);
+                    Serial.printf("High-pass read: %d Hz\n", HPF_HZ);
+                }
+                if (doc.containsKey("Agc"))
+                {
+                    AGC_ENABLED = doc["Agc"].as<bool>();
+                    Serial.printf("AGC read: %s\n", AGC_ENABLED ? "on" : "off");
+                }
+                if (doc.containsKey("Agc_Max_Gain_dB"))
+                {
+                    AGC_MAX_GAIN_DB = constrain(doc["Agc_Max_Gain_dB"].as<int>(), 0, AGC_GAIN_MAX_DB);
+                    Serial.printf("AGC max gain read: %d dB\n", AGC_MAX_GAIN_DB);
+                }
+                if (doc.containsKey("Intercom"))
+                {
+                    INTERCOM_ENABLED = doc["Intercom"].as<bool>();
+                    Serial.printf("Intercom read: %s\n", INTERCOM_ENABLED ? "on" : "off");
+                }
+                if (doc.containsKey("Aec_Tail_ms"))
+                {
+                    AEC_TAIL_MS = constrain(doc["Aec_Tail_ms"].as<int>(), AEC_TAIL_MIN_MS, AEC_TAIL_MAX_MS);
+                    Serial.printf("AEC tail read: %d ms\n", AEC_TAIL_MS);
+                }
+                if (doc.containsKey("Talker_Gain_dB"))
+                {
+                    talkerGainCount = 0;
+                    for (JsonPair p : doc["Talker_Gain_dB"].as<JsonObject>())
+                    {
+                        if (talkerGainCount == TALKER_GAIN_MAX) break;
+                        TalkerGain &g = talkerGains[talkerGainCount++];
+                        g.id = p.key().c_str();
+                        g.db = (int8_t)constrain(p.value().as<int>(), TALKER_GAIN_MIN_DB, 0);
+                        Serial.printf("Talker gain read: %s %d dB\n", g.id.c_str(), g.db);
+                    }
+                }
                 if (doc.containsKey("Endpoint"))
                 {
                     SERVER_ENDPOINT = doc["Endpoint"].as<String>();
@@ -243,6 +672,22 @@ bool readOrCreatePTTConfig()
     JsonDocument doc;
     doc["Friendly_Name"] = FRIENDLY_NAME;
     doc["Endpoint"] = SERVER_ENDPOINT;
+    doc["Codec"] = PREFERRED_CODEC;
+    doc["Preroll_ms"] = PREROLL_MS;
+    doc["Redundancy"] = REDUNDANCY_MAX;
+    doc["Udp_Media"] = UDP_MEDIA;
+    doc["Dtx"] = DTX_ENABLED;
+    doc["Vox"] = VOX_ENABLED;
+    doc["Vox_Hang_ms"] = VOX_HANG_MS;
+    doc["Mic_Bits"] = MIC_BITS;
+    doc["Mic_Gain_dB"] = MIC_GAIN_DB;
+    doc["Dsp"] = DSP_ENABLED;
+    doc["Hpf_Hz"] = HPF_HZ;
+    doc["Agc"] = AGC_ENABLED;
+    doc["Agc_Max_Gain_dB"] = AGC_MAX_GAIN_DB;
+    doc["Intercom"] = INTERCOM_ENABLED;
+    doc["Aec_Tail_ms"] = AEC_TAIL_MS;
+    doc["Talker_Gain_dB"].to<JsonObject>();
     
     File file = SD_MMC.open("/General/PTT.json", FILE_WRITE);
     if (file)
@@ -262,64 +707,138 @@ bool readOrCreatePTTConfig()
 // --- PTT Configuration Functions ---
 // =================================================================
 
+/**
+ * ISR (RX DMA buffer filled): timestamps the capture block for i2s_read_task.
+ */
+bool IRAM_ATTR i2s_rx_done_isr(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+    i2sRxDoneUs = (uint32_t)esp_timer_get_time();
+    i2sRxBuffers++;
+    return false; // no task woken
+}
+
+/**
+ * ISR (RX DMA ring overran): the capture task fell behind and lost a block.
+ */
+bool IRAM_ATTR i2s_rx_overflow_isr(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+    i2sRxOverflows++;
+    return false;
+}
+
+/**
+ * ISR (TX DMA buffer played): timestamps the speaker timeline for the echo reference.
+ */
+bool IRAM_ATTR i2s_tx_done_isr(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+    i2sTxDoneUs = (uint32_t)esp_timer_get_time();
+    return false;
+}
+
+/**
+ * ISR (TX DMA ring ran dry): playback fell behind, auto-clear played zeros.
+ */
+bool IRAM_ATTR i2s_tx_underrun_isr(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+    i2sTxUnderruns++;
+    return false;
+}
+
+/**
+ * Create one i2s_std channel, register its DMA event callbacks and start it.
+ */
+bool setup_i2s_channel(const i2s_chan_config_t &chan_config, const i2s_std_config_t &std_config,
+                       const i2s_event_callbacks_t &callbacks, bool tx, i2s_chan_handle_t *handle)
+{
+    if (i2s_new_channel(&chan_config, tx ? handle : NULL, tx ? NULL : handle) != ESP_OK) return false;
+    // Callbacks must be in place before the channel is enabled
+    return i2s_channel_init_std_mode(*handle, &std_config) == ESP_OK &&
+           i2s_channel_register_event_callback(*handle, &callbacks, NULL) == ESP_OK &&
+           i2s_channel_enable(*handle) == ESP_OK;
+}
+
 void setupI2S()
 {
     Serial.println("Configuring I2S...");
-    lv_label_set_text(lblStatus, "I2S: Configuring...");
-    displayManager.update();
-
-    i2s_config_t i2s_config = {
-        .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_RX),
-        .sample_rate = SAMPLE_RATE,
-        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
-        .channel_format = I2S_CHANNEL_FMT_ONLY_RIGHT, // Mono (depends on mic)
-        .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-        .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 8,
-        .dma_buf_len = 64,
-        .use_apll = false,
-        .tx_desc_auto_clear = true
+    uiStatus("I2S: Configuring...");
+
+    // Microphone: RX-only channel on I2S0, mono on the right slot (depends on mic);
+    // 16-bit samples, or the full 32-bit slots converted by i2s_read_task
+    i2s_chan_config_t rx_chan_config = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    rx_chan_config.dma_desc_num = I2S_RX_DMA_DESC;
+    rx_chan_config.dma_frame_num = I2S_RX_DMA_FRAMES;
+    i2s_data_bit_width_t mic_width = MIC_BITS == 32 ? I2S_DATA_BIT_WIDTH_32BIT : I2S_DATA_BIT_WIDTH_16BIT;
+    i2s_std_config_t rx_config = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(mic_width, I2S_SLOT_MODE_MONO),
+        // Use pins defined in kodedot/pin_config.h
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = (gpio_num_t)MIC_I2S_SCK,
+            .ws = (gpio_num_t)MIC_I2S_WS,
+            .dout = I2S_GPIO_UNUSED,
+            .din = (gpio_num_t)MIC_I2S_DIN,
+            .invert_flags = {false, false, false}
+        }
     };
-
-    // Use pins defined in kodedot/pin_config.h
-    i2s_pin_config_t pin_config = {
-        .bck_io_num = MIC_I2S_SCK,
-        .ws_io_num = MIC_I2S_WS,
-        // Speaker pin not defined in BSP; leave as -1 if unused
-        .data_out_num = -1, // Speaker (not defined in BSP)
-        .data_in_num = MIC_I2S_DIN     // Microphone
+    rx_config.slot_cfg.slot_mask = I2S_STD_SLOT_RIGHT;
+    i2s_event_callbacks_t rx_callbacks = {};
+    rx_callbacks.on_recv = i2s_rx_done_isr;
+    rx_callbacks.on_recv_q_ovf = i2s_rx_overflow_isr;
+
+    // Speaker: TX-only channel on I2S1 with its own clock; zeros when playback falls behind
+    i2s_chan_config_t tx_chan_config = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_1, I2S_ROLE_MASTER);
+    tx_chan_config.dma_desc_num = I2S_TX_DMA_DESC;
+    tx_chan_config.dma_frame_num = I2S_TX_DMA_FRAMES;
+    tx_chan_config.auto_clear = true;
+    i2s_std_config_t tx_config = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = SPK_BCLK_PIN,
+            .ws = SPK_WS_PIN,
+            .dout = SPK_DOUT_PIN,
+            .din = I2S_GPIO_UNUSED,
+            .invert_flags = {false, false, false}
+        }
     };
+    i2s_event_callbacks_t tx_callbacks = {};
+    tx_callbacks.on_sent = i2s_tx_done_isr;
+    tx_callbacks.on_send_q_ovf = i2s_tx_underrun_isr;
 
-    lv_label_set_text(lblStatus, "I2S: Driver...");
-    displayManager.update();
-    i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL);
-    
-    lv_label_set_text(lblStatus, "I2S: Pins...");
-    displayManager.update();
-    i2s_set_pin(I2S_NUM_0, &pin_config);
-    
-    lv_label_set_text(lblStatus, "I2S: Clock...");
-    displayManager.update();
-    i2s_set_clk(I2S_NUM_0, SAMPLE_RATE, I2S_BITS_PER_SAMPLE_16BIT, I2S_CHANNEL_MONO);
+    uiStatus("I2S: Microphone...");
+    if (!setup_i2s_channel(rx_chan_config, rx_config, rx_callbacks, false, &i2sRxChan))
+    {
+        Serial.println("ERROR: Could not start the I2S microphone channel");
+        uiStatus("ERROR: I2S RX");
+        while (1) delay(100);
+    }
+
+    uiStatus("I2S: Speaker...");
+    if (!setup_i2s_channel(tx_chan_config, tx_config, tx_callbacks, true, &i2sTxChan))
+    {
+        Serial.println("ERROR: Could not start the I2S speaker channel");
+        uiStatus("ERROR: I2S TX");
+        while (1) delay(100);
+    }
+    if (SPK_DOUT_PIN == I2S_GPIO_UNUSED) Serial.println("I2S: speaker pins not defined, playback is not routed");
 
     Serial.println("I2S configured.");
-    lv_label_set_text(lblStatus, "I2S: OK");
-    displayManager.update();
+    uiStatus("I2S: OK");
     delay(500);
 }
 
 void setupWifi()
 {
-    lv_label_set_text(lblStatus, "WiFi: Reading networks...");
-    displayManager.update();
+    uiStatus("WiFi: Reading networks...");
     Serial.println("WiFi: Reading /Wi-Fi.json...");
 
     // Check if file exists
     if (!SD_MMC.exists("/Wi-Fi.json"))
     {
         Serial.println("ERROR: /Wi-Fi.json not found on SD card");
-        lv_label_set_text(lblStatus, "ERROR: No Wi-Fi.json");
-        displayManager.update();
+        uiStatus("ERROR: No Wi-Fi.json");
         return;
     }
 
@@ -328,8 +847,7 @@ void setupWifi()
     if (!file)
     {
         Serial.println("ERROR: Cannot open /Wi-Fi.json");
-        lv_label_set_text(lblStatus, "ERROR: Cannot open WiFi.json");
-        displayManager.update();
+        uiStatus("ERROR: Cannot open WiFi.json");
         return;
     }
 
@@ -351,16 +869,14 @@ void setupWifi()
     {
         Serial.print("JSON parse error: ");
         Serial.println(error.c_str());
-        lv_label_set_text(lblStatus, "ERROR: JSON parse failed");
-        displayManager.update();
+        uiStatus("ERROR: JSON parse failed");
         return;
     }
 
     if (!doc.is<JsonArray>())
     {
         Serial.println("ERROR: /Wi-Fi.json is not a JSON array");
-        lv_label_set_text(lblStatus, "ERROR: WiFi.json not array");
-        displayManager.update();
+        uiStatus("ERROR: WiFi.json not array");
         return;
     }
 
@@ -371,8 +887,7 @@ void setupWifi()
     if (totalNets == 0)
     {
         Serial.println("ERROR: No networks in /Wi-Fi.json");
-        lv_label_set_text(lblStatus, "ERROR: No networks found");
-        displayManager.update();
+        uiStatus("ERROR: No networks found");
         return;
     }
 
@@ -389,8 +904,7 @@ void setupWifi()
 
         // Display progress: "Connecting... 1/X"
         String status = "Connecting... " + String(i + 1) + "/" + String(totalNets);
-        lv_label_set_text(lblStatus, status.c_str());
-        displayManager.update();
+        uiStatus(status.c_str());
 
         Serial.printf("[WiFi %d/%d] Attempting: %s\n", i + 1, totalNets, ssid.c_str());
 
@@ -413,8 +927,7 @@ void setupWifi()
 
             // Display IP on screen
             String ipStatus = "WiFi: " + WiFi.localIP().toString();
-            lv_label_set_text(lblStatus, ipStatus.c_str());
-            displayManager.update();
+            uiStatus(ipStatus.c_str());
             delay(1000);
             return;
         }
@@ -425,15 +938,13 @@ void setupWifi()
 
     // If we get here, failed to connect to any network
     Serial.println("ERROR: Could not connect to any WiFi network");
-    lv_label_set_text(lblStatus, "ERROR: WiFi not connected");
-    displayManager.update();
+    uiStatus("ERROR: WiFi not connected");
 }
 
 bool tryRegisterUser()
 {
     Serial.println("[REGISTER] Attempting to register new user...");
-    lv_label_set_text(lblStatus, "Registering user...");
-    displayManager.update();
+    uiStatus("Registering user...");
 
     JsonDocument doc;
     doc["username"] = USERNAME;
@@ -445,7 +956,6 @@ bool tryRegisterUser()
     
     Serial.println("Sending registration:");
     Serial.println(jsonStr);
-    displayManager.update();
     
     httpClient->post("/register", "application/json", jsonStr);
     int statusCode = httpClient->responseStatusCode();
@@ -457,30 +967,26 @@ bool tryRegisterUser()
     if (statusCode == 200 || statusCode == 201)
     {
         Serial.println("[REGISTER] Registration successful!");
-        lv_label_set_text(lblStatus, "Registration successful!");
-        displayManager.update();
+        uiStatus("Registration successful!");
         delay(1000);
         return true;
     }
     
-    lv_label_set_text(lblStatus, "Registration failed");
-    displayManager.update();
+    uiStatus("Registration failed");
     delay(1000);
     return false;
 }
 
 bool loginAndGetDevice()
 {
-    lv_label_set_text(lblStatus, "Authentication in progress...");
-    displayManager.update();
+    uiStatus("Authentication in progress...");
     Serial.println("1. Authenticating (getting token)...");
 
     String contentType = "application/x-www-form-urlencoded";
     String postData = "username=" + String(USERNAME) + "&password=" + String(PASSWORD);
 
     Serial.println("  Sending credentials...");
-    lv_label_set_text(lblStatus, "Sending credentials...");
-    displayManager.update();
+    uiStatus("Sending credentials...");
     
     httpClient->post("/token", contentType, postData);
     int statusCode = httpClient->responseStatusCode();
@@ -492,16 +998,14 @@ bool loginAndGetDevice()
     if (statusCode == 401)
     {
         Serial.println("[AUTH] 401 Unauthorized. Attempting auto-registration...");
-        lv_label_set_text(lblStatus, "401: Registering...");
-        displayManager.update();
+        uiStatus("401: Registering...");
         delay(1000);
 
         if (tryRegisterUser())
         {
             // Now try login again
             Serial.println("[AUTH] Registration successful. Retrying login...");
-            lv_label_set_text(lblStatus, "Login again...");
-            displayManager.update();
+            uiStatus("Login again...");
             delay(1000);
             
             httpClient->post("/token", contentType, postData);
@@ -514,16 +1018,14 @@ bool loginAndGetDevice()
             {
                 Serial.printf("[AUTH] Login after registration failed, status: %d\n", statusCode);
                 Serial.println(responseBody);
-                lv_label_set_text(lblStatus, "Error: Login failed");
-                displayManager.update();
+                uiStatus("Error: Login failed");
                 return false;
             }
         }
         else
         {
             Serial.println("[AUTH] Registration failed. Check the server.");
-            lv_label_set_text(lblStatus, "Error: Registration failed");
-            displayManager.update();
+            uiStatus("Error: Registration failed");
             return false;
         }
     }
@@ -531,13 +1033,11 @@ bool loginAndGetDevice()
     {
         Serial.printf("[AUTH] Error obtaining token, status: %d\n", statusCode);
         Serial.println(responseBody);
-        lv_label_set_text(lblStatus, ("Error " + String(statusCode)).c_str());
-        displayManager.update();
+        uiStatus(("Error " + String(statusCode)).c_str());
         return false;
     }
 
-    lv_label_set_text(lblStatus, "Token obtained!");
-    displayManager.update();
+    uiStatus("Token obtained!");
     
     JsonDocument doc;
     deserializeJson(doc, responseBody);
@@ -547,8 +1047,7 @@ bool loginAndGetDevice()
     delay(500);
 
     // 2. Get Device ID
-    lv_label_set_text(lblStatus, "Getting Device ID...");
-    displayManager.update();
+    uiStatus("Getting Device ID...");
     Serial.println("2. Getting Device ID...");
     Serial.println("  Sending request...");
     
@@ -566,8 +1065,7 @@ bool loginAndGetDevice()
     {
         Serial.printf("[AUTH] Error obtaining device ID, status: %d\n", statusCode);
         Serial.println(responseBody);
-        lv_label_set_text(lblStatus, "Error: Device ID");
-        displayManager.update();
+        uiStatus("Error: Device ID");
         return false;
     }
 
@@ -576,49 +1074,414 @@ bool loginAndGetDevice()
     Serial.print("[AUTH] Device ID obtained: ");
     Serial.println(globalDeviceId);
     
-    lv_label_set_text(lblStatus, "Authenticated successfully!");
-    displayManager.update();
+    uiStatus("Authenticated successfully!");
     delay(1000);
     
     return true;
 }
 
+/**
+ * Advertise the codecs this build supports, preferred first, PCM last, and
+ * the frame header version, redundancy, DTX and UDP media support. Server replies
+ * {"type":"caps_ack","codec":"<name>","frame":1,"red":1,"dtx":1,"udp":<port>,"token":<n>};
+ * old servers ignore it and the session stays on raw PCM without headers.
+ */
+void sendCapabilities()
+{
+    JsonDocument doc;
+    doc["type"] = "caps";
+    doc["rate"] = SAMPLE_RATE;
+    doc["frame"] = AUDIO_FRAME_VERSION;
+    if (REDUNDANCY_MAX > 0) doc["red"] = 1;
+    if (DTX_ENABLED) doc["dtx"] = 1;
+    if (UDP_MEDIA) doc["udp"] = 1;
+    doc["mix"] = 1;
+    JsonArray codecs = doc["codecs"].to<JsonArray>();
+
+    AudioCodecId preferred;
+    if (audio_codec_from_name(PREFERRED_CODEC.c_str(), &preferred) && txEncoders[preferred])
+    {
+        codecs.add(audio_codec_name(preferred));
+    }
+    for (uint8_t i = AUDIO_CODEC_COUNT; i-- > 0;)
+    {
+        AudioCodecId id = (AudioCodecId)i;
+        if (txEncoders[id] && rxSources[0].decoders[id] && strcmp(audio_codec_name(id), PREFERRED_CODEC.c_str()) != 0)
+        {
+            codecs.add(audio_codec_name(id));
+        }
+    }
+
+    String jsonStr;
+    serializeJson(doc, jsonStr);
+    webSocket.sendTXT(jsonStr);
+}
+
+/**
+ * Log a latency breakdown and show it on the stats page (network task).
+ */
+void reportLatency(const LatencyBreakdown &lat, const char *from)
+{
+    Serial.printf("[LAT] seq=%u %s%s total=%ums capture=%u queue=%u network=%u jitter=%u output=%u (ms)\n",
+                  lat.seq, lat.loopback ? "loopback" : "from ", lat.loopback ? "" : from,
+                  (unsigned)(lat.total_us / 1000), (unsigned)(lat.capture_us / 1000), (unsigned)(lat.queue_us / 1000),
+                  (unsigned)(lat.network_us / 1000), (unsigned)(lat.jitter_us / 1000), (unsigned)(lat.output_us / 1000));
+    if (!latencyProbe.enabled()) return;
+    char page[UI_TEXT_MAX];
+    snprintf(page, sizeof(page), "M2E %ums%s\ncap %u  queue %u  net %u\njitter %u  out %u",
+             (unsigned)(lat.total_us / 1000), lat.loopback ? " (loop)" : "", (unsigned)(lat.capture_us / 1000),
+             (unsigned)(lat.queue_us / 1000), (unsigned)(lat.network_us / 1000), (unsigned)(lat.jitter_us / 1000),
+             (unsigned)(lat.output_us / 1000));
+    uiBus.post(UI_PRODUCER_NETWORK, UI_FIELD_STATS, page);
+}
+
+/**
+ * Mix gain of the talker with device id @p from ("Talker_Gain_dB"; unity if not listed).
+ */
+uint16_t talker_gain_q15(const String &from)
+{
+    for (int i = 0; i < talkerGainCount; i++)
+    {
+        if (talkerGains[i].id == from)
+        {
+            return (uint16_t)lrintf(AUDIO_MIX_UNITY_Q15 * powf(10.0f, talkerGains[i].db / 20.0f));
+        }
+    }
+    return AUDIO_MIX_UNITY_Q15;
+}
+
+/**
+ * Stream of source @p id: the one already playing it, else (with @p claim)
+ * a free one, reset for a new talker. Network task only.
+ * @return nullptr when there is none (every stream busy with other talkers)
+ */
+RxSource *rx_source_for(uint8_t id, bool claim)
+{
+    RxSource *free = nullptr;
+    for (RxSource &s : rxSources)
+    {
+        if (s.inUse && s.drained)
+        {
+            // A talk_start that came in while playback drained it keeps the stream
+            if (!s.talkActive) s.inUse = false;
+            s.drained = false;
+        }
+        if (s.inUse && s.id == id) return &s;
+        if (!s.inUse && !free) free = &s;
+    }
+    if (!claim || !free) return nullptr;
+    free->id = id;
+    free->talkActive = false;
+    free->talkerId = "";
+    free->codec = AUDIO_CODEC_PCM16;
+    free->frameVersion = 0;
+    free->redundancy = false;
+    free->volumeQ15 = AUDIO_MIX_UNITY_Q15;
+    free->lastLossReport = 0;
+    free->comfortNoise.stop();
+    // playback_task leaves a free stream alone: clear what the last talker left
+    free->jitterBuffer.reset();
+    for (AudioDecoder *decoder : free->decoders)
+    {
+        if (decoder) decoder->reset();
+    }
+    free->concealer.reset();
+    free->pcmLen = 0;
+    free->lastDecoder = nullptr;
+    free->cnPlaying = false;
+    free->inUse = true;
+    return free;
+}
+
+void update_rx_talk_active()
+{
+    bool any = false;
+    for (RxSource &s : rxSources) any |= s.inUse && s.talkActive;
+    rxTalkActive = any;
+}
+
+/**
+ * Handle JSON control messages ("caps_ack", peers' "talk_start", "lat_report").
+ */
+void handleControlMessage(uint8_t *payload, size_t length)
+{
+    JsonDocument doc;
+    if (deserializeJson(doc, payload, length)) return;
+
+    const char *type = doc["type"] | "";
+    AudioCodecId codec = AUDIO_CODEC_PCM16;
+
+    if (strcmp(type, "caps_ack") == 0)
+    {
+        if (!audio_codec_from_name(doc["codec"] | "pcm", &codec) || !txEncoders[codec])
+        {
+            codec = AUDIO_CODEC_PCM16;
+        }
+        txCodec = codec;
+        txFrameVersion = (doc["frame"] | 0) == AUDIO_FRAME_VERSION ? AUDIO_FRAME_VERSION : 0;
+        // Copies are matched to missing sequence numbers: needs frame headers
+        txRedundancy = REDUNDANCY_MAX > 0 && txFrameVersion && (doc["red"] | 0) == 1;
+        txRedController.begin((uint8_t)REDUNDANCY_MAX);
+        // Descriptors are told apart from audio by their codec id in the header
+        txDtx = DTX_ENABLED && txFrameVersion && (doc["dtx"] | 0) == 1;
+        // Source ids come with the frame headers
+        rxMix = txFrameVersion && (doc["mix"] | 0) == 1;
+        Serial.printf("[CODEC] Session codec: %s, frame header v%u, redundancy %s, DTX %s, mixing %s\n",
+                      audio_codec_name(codec), txFrameVersion, txRedundancy ? "on" : "off", txDtx ? "on" : "off",
+                      rxMix ? "on" : "off");
+
+        // Datagrams always carry the frame header
+        mediaUdpPort = (UDP_MEDIA && txFrameVersion) ? (uint16_t)(doc["udp"] | 0) : 0;
+        mediaUdpToken = doc["token"] | 0u;
+        mediaUdpReady = false;
+        mediaUdpHellos = 0;
+        mediaUdpLastHello = 0;
+        if (mediaUdpPort && !mediaUdp.begin(0))
+        {
+            Serial.println("[UDP] Cannot open a socket; audio stays on the WebSocket");
+            mediaUdpPort = 0;
+        }
+    }
+    else if (strcmp(type, "talk_start") == 0)
+    {
+        RxSource *src = rx_source_for(rxMix ? (uint8_t)(doc["src"] | 0) : 0, true);
+        if (!src)
+        {
+            rxSourcesBusy++;
+            Serial.printf("[MIX] %d talkers already; not playing %s\n", RX_MAX_SOURCES, (const char *)(doc["from"] | "?"));
+            return;
+        }
+        // Peers that predate negotiation send no "codec": raw PCM
+        if (!audio_codec_from_name(doc["codec"] | "pcm", &codec))
+        {
+            codec = AUDIO_CODEC_PCM16;
+        }
+        src->codec = codec;
+        // Talkers that did not negotiate headers send bare payloads
+        src->frameVersion = (doc["frame"] | 0) == AUDIO_FRAME_VERSION ? AUDIO_FRAME_VERSION : 0;
+        src->talkerId = doc["from"] | "";
+        src->volumeQ15 = talker_gain_q15(src->talkerId);
+        src->redundancy = src->frameVersion && (doc["red"] | 0) == 1;
+        src->comfortNoise.stop();
+        src->talkActive = true;
+        rxTalkActive = true;
+    }
+    else if (strcmp(type, "talk_stop") == 0)
+    {
+        RxSource *src = rx_source_for(rxMix ? (uint8_t)(doc["src"] | 0) : 0, false);
+        if (src)
+        {
+            src->talkActive = false;
+            src->comfortNoise.stop();
+        }
+        update_rx_talk_active();
+    }
+    else if (strcmp(type, "loss_report") == 0)
+    {
+        // A listener's loss since its last report sets how many copies our frames carry
+        if (globalDeviceId != (doc["to"] | "")) return;
+        uint8_t before = txRedController.level();
+        uint8_t level = txRedController.onLossReport(doc["lost"] | 0u, doc["received"] | 0u);
+        if (level != before)
+        {
+            Serial.printf("[RED] %u copies per frame (%u lost / %u received)\n", level,
+                          (unsigned)(doc["lost"] | 0u), (unsigned)(doc["received"] | 0u));
+        }
+    }
+    else if (strcmp(type, "lat_report") == 0)
+    {
+        // A listener timed one of our probes (the relay adds "from")
+        if (globalDeviceId != (doc["to"] | "")) return;
+        const char *from = doc["from"] | "?";
+        LatencyReport report = {(uint16_t)(doc["seq"] | 0), doc["arrival"] | 0u, doc["jb"] | 0u,
+                                doc["out"] | 0u, doc["hold"] | 0u};
+        LatencyBreakdown lat;
+        if (latencyProbe.onReport(report, micros(), globalDeviceId == from, &lat))
+        {
+            reportLatency(lat, from);
+        }
+    }
+}
+
+/**
+ * Give frames lost before the one just received their places in the playout
+ * order, oldest first: rebuilt from a redundant copy when the frame carries
+ * one, otherwise as a placeholder that playback conceals.
+ */
+void queue_missing_frames(RxSource &src, uint16_t lostFrames, AudioCodecId codec, int frameSamples,
+                          const AudioRedBlock *redBlocks, uint8_t redCount, uint32_t now_us)
+{
+    if (frameSamples > PLAYBACK_MAX_SAMPLES) frameSamples = PLAYBACK_MAX_SAMPLES;
+    if (lostFrames > PLC_MAX_GAP_FRAMES) lostFrames = PLC_MAX_GAP_FRAMES;
+
+    for (uint16_t back = lostFrames; back >= 1; back--)
+    {
+        const AudioRedBlock *copy = nullptr;
+        for (uint8_t i = 0; i < redCount; i++)
+        {
+            if (redBlocks[i].distance == back) copy = &redBlocks[i];
+        }
+        if (copy && copy->codec < AUDIO_CODEC_COUNT && src.decoders[copy->codec])
+        {
+            int samples = copy->codec == AUDIO_CODEC_PCM16 ? copy->len / 2
+                                                           : src.decoders[copy->codec]->packetSamples(copy->data, copy->len);
+            if (samples > 0 && samples <= PLAYBACK_MAX_SAMPLES &&
+                src.jitterBuffer.pushRecovered(copy->data, copy->len, (uint16_t)samples, copy->codec, now_us))
+            {
+                continue;
+            }
+        }
+        if (frameSamples > 0) src.jitterBuffer.pushLost((uint16_t)frameSamples, codec, now_us);
+    }
+}
+
+/**
+ * Queue a received audio frame on its talker's stream for the playback task
+ * (WebSocket or UDP). Never blocks the network loop on I2S.
+ * @param datagram    Arrived over UDP: always starts with a frame header
+ * @param datagramRed UDP only: the payload carries redundant copies (audio/redundancy.h)
+ */
+void receive_audio_frame(const uint8_t *data, size_t length, bool datagram, bool datagramRed)
+{
+    // With mixing agreed, the talker's source id comes first
+    uint8_t sourceId = 0;
+    if (rxMix)
+    {
+        if (length < AUDIO_FRAME_SOURCE_BYTES) return;
+        sourceId = data[0];
+        data += AUDIO_FRAME_SOURCE_BYTES;
+        length -= AUDIO_FRAME_SOURCE_BYTES;
+    }
+    // A datagram may overtake its talk_start: it claims the stream itself
+    RxSource *src = rx_source_for(sourceId, true);
+    if (!src) return;
+    bool hasHeader = datagram || src->frameVersion != 0;
+    bool redundant = datagram ? datagramRed : src->redundancy;
+
+    // Incoming audio!
+    lastAudioReceiveTime = millis();
+    isReceivingAudio = true;
+
+    uint32_t now_us = micros();
+    AudioCodecId codec = src->codec;
+    uint16_t lostFrames = 0;
+    AudioRedBlock redBlocks[AUDIO_RED_MAX_LEVEL];
+    uint8_t redCount = 0;
+    if (hasHeader)
+    {
+        AudioFrameHeader hdr;
+        if (!audio_frame_parse_header(data, length, &hdr)) return;
+        if (hdr.codec >= AUDIO_CODEC_COUNT && hdr.codec != AUDIO_FRAME_CODEC_CN) return;
+        // Late and duplicate frames would play out of order: drop them here
+        AudioRxStats::Verdict verdict = src->frameStats.onFrame(hdr, now_us);
+        if (verdict == AudioRxStats::FRAME_LATE || verdict == AudioRxStats::FRAME_DUPLICATE) return;
+        if (verdict == AudioRxStats::FRAME_AFTER_GAP) lostFrames = src->frameStats.lastGap();
+        codec = (AudioCodecId)hdr.codec;
+        if (hdr.flags & AUDIO_FRAME_FLAG_PROBE)
+        {
+            latencyProbe.onProbeReceived(hdr.seq, now_us);
+            rxProbeTalkerId = src->talkerId;
+        }
+        data += AUDIO_FRAME_HEADER_BYTES;
+        length -= AUDIO_FRAME_HEADER_BYTES;
+
+        // Redundant bursts: the primary is followed by copies of earlier frames
+        if (redundant && !audio_red_parse(data, length, redBlocks, &redCount, &data, &length)) return;
+
+        if (hdr.codec == AUDIO_FRAME_CODEC_CN)
+        {
+            // Talker paused (DTX): frames missing before it are only worth their copies,
+            // comfort noise covers the rest until speech resumes
+            ComfortNoiseParams sid;
+            if (!cn_parse_sid(data, length, &sid)) return;
+            queue_missing_frames(*src, lostFrames, src->codec, 0, redBlocks, redCount, now_us);
+            src->comfortNoise.update(sid);
+            src->jitterBuffer.markSilence();
+            return;
+        }
+        src->comfortNoise.stop();
+    }
+    AudioDecoder *decoder = src->decoders[codec];
+    if (!decoder) return; // Peer uses a codec this build cannot decode
+
+    if (lostFrames > 0)
+    {
+        // Missing frames are assumed to be as long as this one
+        int frameSamples = codec == AUDIO_CODEC_PCM16 ? (int)(length / 2) : decoder->packetSamples(data, length);
+        queue_missing_frames(*src, lostFrames, codec, frameSamples, redBlocks, redCount, now_us);
+    }
+
+    if (codec == AUDIO_CODEC_PCM16)
+    {
+        // Raw PCM has no framing: split oversized payloads into slots
+        length &= ~(size_t)1; // whole 16-bit samples only
+        while (length > 0)
+        {
+            size_t chunk = length > JITTER_MAX_FRAME_BYTES ? JITTER_MAX_FRAME_BYTES : length;
+            src->jitterBuffer.push(data, chunk, (uint16_t)(chunk / 2), codec, now_us);
+            data += chunk;
+            length -= chunk;
+        }
+    }
+    else
+    {
+        int samples = decoder->packetSamples(data, length);
+        if (samples > 0 && samples <= PLAYBACK_MAX_SAMPLES)
+        {
+            src->jitterBuffer.push(data, length, (uint16_t)samples, codec, now_us);
+        }
+    }
+}
+
 void webSocketEvent(WStype_t type, uint8_t *payload, size_t length)
 {
-    size_t bytes_written = 0;
     switch (type)
     {
     case WStype_DISCONNECTED: {
         Serial.println("[WS] Disconnected.");
         isWebSocketConnected = false;
-        if (lblStatus) lv_label_set_text(lblStatus, "Reconnecting...");
+        for (RxSource &s : rxSources)
+        {
+            s.talkActive = false;
+            s.comfortNoise.stop();
+        }
+        rxTalkActive = false;
+        txRedundancy = false;
+        txDtx = false;
+        mediaUdpPort = 0;
+        mediaUdpReady = false;
+        mediaUdp.stop();
+        uiBus.post(UI_PRODUCER_NETWORK, UI_FIELD_STATUS, "Reconnecting...");
         break;
     }
 
     case WStype_CONNECTED: {
         Serial.println("[WS] Connected.");
+        // Raw PCM without headers until the server acknowledges our capabilities
+        txCodec = AUDIO_CODEC_PCM16;
+        txFrameVersion = 0;
+        rxMix = false;
+        for (RxSource &s : rxSources)
+        {
+            s.codec = AUDIO_CODEC_PCM16;
+            s.frameVersion = 0;
+        }
+        sendCapabilities();
         isWebSocketConnected = true;
-        if (lblStatus) lv_label_set_text(lblStatus, "Ready");
+        uiBus.post(UI_PRODUCER_NETWORK, UI_FIELD_STATUS, "Ready");
         break;
     }
 
     case WStype_TEXT: {
         // client.py uses this for "talk_start" / "talk_stop"
-        // (Ignored for now, we use WStype_BIN for 'incoming' indicator)
+        // (We use WStype_BIN for the 'incoming' indicator)
         Serial.printf("[WS] Text received: %s\n", payload);
+        handleControlMessage(payload, length);
         break;
     }
 
     case WStype_BIN: {
-        // Incoming audio!
-        lastAudioReceiveTime = millis();
-        isReceivingAudio = true;
-
-        // Write audio data directly to I2S speaker
-        i2s_write(I2S_NUM_0, payload, length, &bytes_written, portMAX_DELAY);
-        if (bytes_written != length) {
-            Serial.println("[I2S] Error writing to speaker");
-        }
+        receive_audio_frame(payload, length, false, false);
         break;
     }
 
@@ -630,22 +1493,19 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length)
 
 void setupWebSocket()
 {
-    lv_label_set_text(lblStatus, "WebSocket: Connecting...");
-    displayManager.update();
+    uiStatus("WebSocket: Connecting...");
     Serial.println("3. Connecting to WebSocket...");
     String ws_path = "/ws/" + globalDeviceId + "?token=" + globalToken;
     
     Serial.println("  Path: " + ws_path);
-    lv_label_set_text(lblStatus, "WS: Starting...");
-    displayManager.update();
+    uiStatus("WS: Starting...");
     
     // Use parsed host/port from SERVER_ENDPOINT (server_host_str, server_port_int)
     webSocket.begin(server_host_str.c_str(), server_port_int, ws_path);
     webSocket.onEvent(webSocketEvent);
     webSocket.setReconnectInterval(5000);
     
-    lv_label_set_text(lblStatus, "WS: Waiting for connection...");
-    displayManager.update();
+    uiStatus("WS: Waiting for connection...");
     
     Serial.println("  WebSocket configured");
 }
@@ -698,6 +1558,13 @@ void create_ptt_ui()
     lv_obj_add_style(lblIncomingStatus, &style_incoming, 0);
     lv_label_set_text(lblIncomingStatus, ""); // Empty at start
     lv_obj_align(lblIncomingStatus, LV_ALIGN_BOTTOM_MID, 0, -30);
+
+    // --- Latency Stats Page (between status and PTT; empty while hidden) ---
+    lblStats = lv_label_create(scr);
+    lv_obj_add_style(lblStats, &style_status, 0);
+    lv_obj_set_style_text_align(lblStats, LV_TEXT_ALIGN_CENTER, 0);
+    lv_label_set_text(lblStats, "");
+    lv_obj_align(lblStats, LV_ALIGN_TOP_MID, 0, 60);
 }
 
 // =================================================================
@@ -705,54 +1572,829 @@ void create_ptt_ui()
 // =================================================================
 
 /**
- * Task (Core 0): Reads the PTT button (BTN_A) from the I/O expander.
- * Sets the 'isPttActive' flag and notifies the main loop.
+ * Task (Core 1): the only LVGL user after setup. Once per frame it applies
+ * the newest text posted for each label, then runs the LVGL timers
+ * (rendering, touch input).
  */
-void ptt_button_task(void *pvParameters)
+void ui_task(void *pvParameters)
 {
-    Serial.println("Starting PTT Button Task (Core 0)...");
-    
-    // The 'Wire' and 'io_expander' are initialized in setup()
-    bool lastState = false;
+    Serial.println("Starting UI Task (Core 1)...");
+    lv_obj_t *const labels[UI_FIELD_COUNT] = {lblStatus, lblPttStatus, lblIncomingStatus, lblStats};
 
     while (true)
     {
-        // The bottom button of the expander is active-low
-        bool currentState = !io_expander.read1(EXPANDER_BUTTON_BOTTOM);
-
-        if (currentState != lastState)
+        uint32_t changed = uiBus.collect();
+        for (uint8_t f = 0; f < UI_FIELD_COUNT; f++)
         {
-            isPttActive = currentState;
-            pttStateChanged = true; // Notify main loop to act
-            lastState = currentState;
+            if (changed & (1u << f))
+            {
+                lv_label_set_text(labels[f], uiBus.text((UiField)f));
+            }
         }
-        vTaskDelay(pdMS_TO_TICKS(20)); // Poll every 20ms
+
+        displayManager.update();
+        vTaskDelay(pdMS_TO_TICKS(UI_FRAME_MS));
     }
 }
 
 /**
- * Task (Core 0): Continuously reads from the I2S microphone.
- * If 'isPttActive' is true, sends the data via WebSocket.
+ * PTT held or VOX keyed: this device is talking.
  */
-void i2s_read_task(void *pvParameters)
+bool talk_key_down()
 {
-    Serial.println("Starting I2S Read Task (Core 0)...");
-    size_t bytes_read = 0;
+    return isPttActive || isVoxActive;
+}
 
-    while (true)
-    {
-        // Read data from I2S microphone
-        esp_err_t err = i2s_read(I2S_NUM_0, (void *)i2s_read_buffer, I2S_READ_BUFFER_BYTES, &bytes_read, portMAX_DELAY);
+/**
+ * PTT label while nobody is keyed: the hands-free mode, if any.
+ */
+const char *idle_ptt_text()
+{
+    return intercomEnabled ? "INTERCOM" : voxEnabled ? "VOX ON" : "HOLD TO TALK";
+}
+
+/**
+ * ISR: TCA9555 INT (active-low, open-drain) fired on an input change.
+ * Timestamps the edge and triggers the expander job; the I2C read happens there.
+ */
+void IRAM_ATTR ioexp_int_isr()
+{
+    inputIrqTimeUs = (uint32_t)esp_timer_get_time();
+    inputIrqPending = true;
+    i2cBus.triggerFromISR(ioexpBusId);
+}
+
+/**
+ * I2C job (bus task, highest priority): reads both expander ports in one
+ * transaction when INT fires (plus a slow fallback period for a missed edge).
+ * Leading-edge debounce: a change is accepted immediately (stamped with the
+ * ISR time) and further changes on that pin are ignored for
+ * INPUT_DEBOUNCE_US, after which the job re-runs to catch the final state.
+ * PTT sets 'isPttActive'; D-pad changes go to 'inputEventQueue'.
+ */
+bool ioexp_bus_job(void *ctx)
+{
+    static bool initialized = false;
+    static uint16_t mask = 0;
+    static uint16_t stable = 0;
+    static uint32_t lastEdgeUs[16] = {0};
+
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+    bool irq = inputIrqPending;
+    inputIrqPending = false;
+    uint32_t edge_us = irq ? inputIrqTimeUs : now_us;
+
+    // Pressed = low; reading the port also clears a pending INT
+    uint16_t pressed = (uint16_t)~io_expander.read16();
+    if (io_expander.lastError() != TCA9555_OK) return false;
+
+    if (!initialized)
+    {
+        for (uint8_t pin : INPUT_PINS) mask |= (uint16_t)(1u << pin);
+        stable = pressed & mask;
+        initialized = true;
+        return true;
+    }
+
+    pressed &= mask;
+    uint16_t changed = pressed ^ stable;
+    bool recheck = false;
+
+    for (uint8_t pin : INPUT_PINS)
+    {
+        uint16_t bit = (uint16_t)(1u << pin);
+        if (!(changed & bit)) continue;
+
+        // Still bouncing from the previous accepted edge: look again after the lockout
+        if (now_us - lastEdgeUs[pin] < INPUT_DEBOUNCE_US)
+        {
+            recheck = true;
+            continue;
+        }
+
+        stable ^= bit;
+        lastEdgeUs[pin] = edge_us;
+        bool down = (pressed & bit) != 0;
+
+        if (pin == EXPANDER_BUTTON_BOTTOM)
+        {
+            pttEdgeTimeUs = edge_us;
+            isPttActive = down;
+            pttStateChanged = true; // Notify main loop to act
+        }
+        else
+        {
+            InputEvent ev = {pin, down, edge_us};
+            xQueueSend(inputEventQueue, &ev, 0); // Drop if nobody is consuming
+        }
+    }
+
+    if (recheck) i2cBus.schedule(ioexpBusId, INPUT_DEBOUNCE_US / 1000);
+    return true;
+}
+
+/**
+ * I2C job (bus task): one touch controller read, cached for LVGL on Core 1.
+ */
+bool touch_bus_job(void *ctx)
+{
+    return displayManager.pollTouch();
+}
+
+/**
+ * Read @p len consecutive registers from @p addr starting at @p reg (one transaction).
+ */
+bool i2c_read_regs(uint8_t addr, uint8_t reg, uint8_t *out, uint8_t len)
+{
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom(addr, len) != len) return false;
+    for (uint8_t i = 0; i < len; i++) out[i] = Wire.read();
+    return true;
+}
+
+/**
+ * I2C job (bus task, lowest priority): battery voltage/SoC from the MAX17048
+ * (VCELL + SOC in one 4-byte burst).
+ */
+bool fuel_gauge_bus_job(void *ctx)
+{
+    uint8_t regs[4];
+    if (!i2c_read_regs(MAX17048_I2C_ADDRESS, 0x02, regs, 4)) return false;
+    uint16_t vcell = ((uint16_t)regs[0] << 8) | regs[1];
+    batteryMillivolts = (uint16_t)(((uint32_t)vcell * 5) / 64); // 78.125 uV/LSB
+    batteryPercent = regs[2] > 100 ? 100 : regs[2];
+    return true;
+}
+
+/**
+ * I2C job (bus task, lowest priority): charge status from the BQ25896.
+ */
+bool charger_bus_job(void *ctx)
+{
+    uint8_t reg;
+    if (!i2c_read_regs(BQ25896_I2C_ADDRESS, 0x0B, &reg, 1)) return false;
+    chargerStatus = (reg >> 3) & 0x03;
+    return true;
+}
+
+/**
+ * Enqueue a talk marker for the network task.
+ * @return false if the ring is full (caller retries on the next frame)
+ */
+bool enqueue_talk_marker(AudioPacketKind kind, AudioCodecId codec, uint32_t now_us, uint8_t flags = 0)
+{
+    AudioPacket *pkt = txRing.acquireWrite();
+    if (!pkt) return false;
+    pkt->capture_us = now_us;
+    pkt->len = 0;
+    pkt->kind = kind;
+    pkt->codec = codec;
+    pkt->flags = flags;
+    txRing.commitWrite();
+    return true;
+}
+
+/**
+ * Encode one captured block and enqueue the resulting packet (if any).
+ * The encoder is fed even when the ring is full so its history stays continuous.
+ * In redundant bursts the packet also carries copies of the previous frames,
+ * as many as txRedController allows, and this frame's copy is kept for the next ones.
+ * @param flags AudioFrameFlags for the packet's wire header
+ * @param redundant The burst was announced with "red":1
+ * @return true if the encoder emitted a packet (queued or dropped)
+ */
+bool encode_and_enqueue(AudioEncoder *encoder, const int16_t *pcm, size_t samples, uint32_t capture_us,
+                        uint8_t flags = 0, bool redundant = false)
+{
+    static uint8_t scratch[AUDIO_PACKET_MAX_BYTES]; // encode target when the ring is full
+
+    AudioPacket *pkt = txRing.acquireWrite();
+    uint8_t *dst = pkt ? pkt->data : scratch;
+    // Block headers go in front of the primary, the copies behind it
+    uint8_t blocks = redundant ? txRedEncoder.blocksFor(txRedController.level()) : 0;
+    size_t prefix = redundant ? audio_red_prefix_bytes(blocks) : 0;
+    size_t reserved = prefix + txRedEncoder.copyBytes(blocks);
+    int len = encoder->encode(pcm, samples, dst + prefix, AUDIO_PACKET_MAX_BYTES - reserved);
+    if (len <= 0) return false;
+    // Numbered even when dropped, so receivers see the gap
+    uint16_t seq = txFrameSeq++;
+    if (redundant)
+    {
+        const uint8_t *primary = dst + prefix;
+        size_t primaryLen = (size_t)len;
+        len = (int)txRedEncoder.pack(dst, primaryLen, blocks);
+        // Opus and ADPCM are compact enough to repeat as they are; raw PCM gets an ADPCM copy
+        if (encoder->id() == AUDIO_CODEC_PCM16 && txRedCopyEncoder)
+        {
+            uint8_t copy[AUDIO_RED_MAX_COPY_BYTES];
+            int copyLen = txRedCopyEncoder->encode(pcm, samples, copy, sizeof(copy));
+            txRedEncoder.remember(AUDIO_CODEC_ADPCM, copy, copyLen > 0 ? (size_t)copyLen : 0);
+        }
+        else
+        {
+            txRedEncoder.remember(encoder->id(), primary, primaryLen);
+        }
+    }
+    if (pkt)
+    {
+        pkt->capture_us = capture_us;
+        pkt->len = (uint16_t)len;
+        pkt->seq = seq;
+        pkt->kind = AUDIO_PACKET_FRAME;
+        pkt->codec = encoder->id();
+        pkt->flags = flags;
+        pkt->encoded_us = micros();
+        pkt->samples = (uint16_t)encoder->packetSamples();
+        txRing.commitWrite();
+    }
+    return true;
+}
+
+/**
+ * Enqueue a comfort noise descriptor in place of a silent frame (DTX).
+ * It is numbered like a frame, so listeners see no gap, and in redundant
+ * bursts still carries the copies of the frames before it.
+ */
+void enqueue_sid(const ComfortNoiseParams &sid, uint32_t capture_us, bool redundant)
+{
+    AudioPacket *pkt = txRing.acquireWrite();
+    uint16_t seq = txFrameSeq++;
+    if (pkt)
+    {
+        uint8_t blocks = redundant ? txRedEncoder.blocksFor(txRedController.level()) : 0;
+        size_t prefix = redundant ? audio_red_prefix_bytes(blocks) : 0;
+        size_t len = cn_write_sid(sid, pkt->data + prefix);
+        if (redundant) len = txRedEncoder.pack(pkt->data, len, blocks);
+        pkt->capture_us = capture_us;
+        pkt->len = (uint16_t)len;
+        pkt->seq = seq;
+        pkt->kind = AUDIO_PACKET_FRAME;
+        pkt->codec = AUDIO_FRAME_CODEC_CN;
+        pkt->flags = 0;
+        pkt->encoded_us = micros();
+        pkt->samples = 0;
+        txRing.commitWrite();
+    }
+    // Nothing worth repeating: later frames carry no copy of it
+    if (redundant) txRedEncoder.remember(AUDIO_FRAME_CODEC_CN, nullptr, 0);
+}
+
+/**
+ * Task (Core 0): Continuously reads from the I2S microphone.
+ * While idle, keeps the last PREROLL_MS of audio; at key-up that history is
+ * sent first (with its original capture timestamps), then live frames.
+ * Frames are encoded with the session codec and enqueued for the network
+ * task; this task never touches the WebSocket, so a TCP stall cannot stall
+ * the mic DMA. With DTX, frames the VAD finds silent are replaced by
+ * occasional comfort noise descriptors. In VOX mode the same VAD energies
+ * key the transmitter. In intercom mode the echo canceller runs first, on
+ * the speaker output that played while the block was captured.
+ */
+void i2s_read_task(void *pvParameters)
+{
+    Serial.println("Starting I2S Read Task (Core 0)...");
+    size_t bytes_read = 0;
+    bool talking = false;
+    bool probePending = false; // next emitted packet is a latency probe
+    bool redundant = false;    // current burst carries redundant copies
+    bool dtx = false;          // current burst suppresses silent frames
+    bool paused = false;       // DTX pause in progress
+    uint32_t buffersRead = 0;  // RX DMA buffers consumed (one per read)
+    const uint8_t micShift = (uint8_t)(PCM_CONVERT_UNITY_SHIFT - MIC_GAIN_DB / 6);
+    const uint32_t blockUs = (uint32_t)((uint64_t)AUDIO_BUFFER_SAMPLES * 1000000 / SAMPLE_RATE);
+    // The limiter's look-ahead delays what comes out of the DSP chain
+    const uint32_t dspDelayUs = DSP_ENABLED ? (uint32_t)(txDsp.latencySamples() * 1000000 / SAMPLE_RATE) : 0;
+    AudioEncoder *encoder = txEncoders[AUDIO_CODEC_PCM16];
+    bool aec = false;          // echo canceller ran on the last block
+
+    while (true)
+    {
+        // Read data from I2S microphone
+        esp_err_t err;
+        if (MIC_BITS == 32)
+        {
+            err = i2s_channel_read(i2sRxChan, (void *)i2s_slot_buffer, sizeof(i2s_slot_buffer), &bytes_read,
+                                   portMAX_DELAY);
+            // Gain before the low bits are dropped, saturated to 16 bits
+            size_t slots = bytes_read / sizeof(int32_t);
+            pcm_s32_to_s16(i2s_slot_buffer, i2s_read_buffer, slots, micShift);
+            bytes_read = slots * sizeof(int16_t);
+        }
+        else
+        {
+            err = i2s_channel_read(i2sRxChan, (void *)i2s_read_buffer, I2S_READ_BUFFER_BYTES, &bytes_read,
+                                   portMAX_DELAY);
+        }
 
         if (err != ESP_OK) {
             Serial.printf("[I2S Read Task] Read error: %d\n", err);
             continue;
         }
 
-        // Send only if PTT is active and connected
-        if (isPttActive && isWebSocketConnected && bytes_read > 0)
+        // Capture time: when the DMA completed this block (on_recv), not when we got to it.
+        // Blocks completed after it are still queued; after an overflow, start over.
+        int32_t backlog = (int32_t)(i2sRxBuffers - ++buffersRead);
+        if (backlog < 0 || backlog >= I2S_RX_DMA_DESC)
+        {
+            buffersRead = i2sRxBuffers;
+            backlog = 0;
+        }
+        uint32_t now_us = i2sRxBuffers ? i2sRxDoneUs - (uint32_t)backlog * blockUs : micros();
+
+        size_t samples = bytes_read / sizeof(int16_t);
+        if (intercomEnabled && samples > 0)
+        {
+            // Before the AGC, whose gain would otherwise be part of the echo path.
+            // The block's first sample was captured a block before now_us.
+            if (!aec) echoReference.realign();
+            echoReference.read(aec_ref_buffer, samples, now_us - blockUs - AEC_REF_LEAD_US);
+            txAec.process(i2s_read_buffer, aec_ref_buffer, samples);
+        }
+        aec = intercomEnabled && samples > 0;
+        if (DSP_ENABLED && samples > 0)
+        {
+            txDsp.process(i2s_read_buffer, samples);
+            now_us -= dspDelayUs;
+        }
+        // Also runs while idle, so the noise level is already known at key-up
+        bool speech = samples > 0 && txVad.process(i2s_read_buffer, samples);
+
+        // VOX keys like PTT, but never on a peer's audio coming out of our own speaker
+        // (unless the echo canceller takes it out: intercom mode)
+        bool vox = false;
+        bool handsFree = voxEnabled || intercomEnabled;
+        if (!handsFree || (!intercomEnabled && !txVox.keyed() && rxTalkActive)) txVox.release();
+        else if (samples > 0) vox = txVox.process(txVad.frameEnergy(), txVad.noiseEnergy(), samples);
+        else vox = txVox.keyed();
+        if (vox != isVoxActive)
+        {
+            isVoxActive = vox;
+            pttStateChanged = true; // Same UI/LED path as the button
+        }
+
+        // Talk markers go through the ring so they stay ordered with the audio
+        bool wantTalk = (isPttActive || vox) && isWebSocketConnected;
+        if (wantTalk != talking)
+        {
+            // The codec is fixed for the whole burst
+            AudioEncoder *next = wantTalk ? txEncoders[txCodec] : encoder;
+            if (!next) next = txEncoders[AUDIO_CODEC_PCM16];
+            bool nextRedundant = wantTalk && txRedundancy;
+            if (enqueue_talk_marker(wantTalk ? AUDIO_PACKET_TALK_START : AUDIO_PACKET_TALK_STOP, next->id(), now_us,
+                                    nextRedundant ? AUDIO_PACKET_BURST_RED : 0))
+            {
+                talking = wantTalk;
+                encoder = next;
+                encoder->reset();
+                redundant = nextRedundant;
+                txRedEncoder.reset();
+                dtx = wantTalk && txDtx;
+                paused = false;
+                txCnEncoder.reset();
+
+                if (talking)
+                {
+                    // Flush the pre-roll history right behind talk_start
+                    for (size_t i = 0; i < prerollBuffer.size(); i++)
+                    {
+                        size_t samples = 0;
+                        uint32_t capture_us = 0;
+                        const int16_t *pcm = prerollBuffer.block(i, &samples, &capture_us);
+                        encode_and_enqueue(encoder, pcm, samples, capture_us, 0, redundant);
+                    }
+                }
+                prerollBuffer.clear();
+            }
+        }
+
+        if (bytes_read == 0) continue;
+
+        // Enqueue only while talking; a full ring drops the frame (counted as overflow)
+        if (talking && dtx && !speech)
+        {
+            // Pause: a descriptor at its start and then every few hundred ms
+            ComfortNoiseParams sid;
+            if (txCnEncoder.silentFrame(i2s_read_buffer, samples, &sid)) enqueue_sid(sid, now_us, redundant);
+            paused = true;
+            txDtxSuppressed++;
+        }
+        else if (talking)
+        {
+            if (paused)
+            {
+                // Speech again: nothing buffered from before the pause may leak into it
+                encoder->reset();
+                txCnEncoder.reset();
+                paused = false;
+            }
+            // Opus re-frames: the probe flag waits for the next packet actually emitted
+            if (latencyProbe.due(now_us)) probePending = true;
+            if (encode_and_enqueue(encoder, i2s_read_buffer, samples, now_us,
+                                   probePending ? AUDIO_FRAME_FLAG_PROBE : 0, redundant))
+            {
+                probePending = false;
+            }
+        }
+        else
+        {
+            prerollBuffer.write(i2s_read_buffer, samples, now_us);
+        }
+
+        if (networkTaskHandle) xTaskNotifyGive(networkTaskHandle);
+    }
+}
+
+/**
+ * Send one media datagram to the server's media port (network task).
+ */
+void send_media_datagram(uint8_t kind, const uint8_t *frame, size_t len)
+{
+    uint8_t prefix[MEDIA_DGRAM_PREFIX_BYTES];
+    media_dgram_write_prefix(kind, mediaUdpToken, prefix);
+    if (!mediaUdp.beginPacket(server_host_str.c_str(), mediaUdpPort)) return;
+    mediaUdp.write(prefix, sizeof(prefix));
+    if (len) mediaUdp.write(frame, len);
+    if (mediaUdp.endPacket()) mediaUdpTx++;
+}
+
+/**
+ * UDP media path upkeep (network task): HELLO until answered, keepalives,
+ * fallback to the WebSocket, and delivery of received datagrams.
+ */
+void service_media_udp()
+{
+    if (!mediaUdpPort || !isWebSocketConnected) return;
+
+    static uint8_t rx[MEDIA_DGRAM_PREFIX_BYTES + AUDIO_FRAME_HEADER_BYTES + AUDIO_PACKET_MAX_BYTES];
+    int size;
+    while ((size = mediaUdp.parsePacket()) > 0)
+    {
+        int len = mediaUdp.read(rx, sizeof(rx));
+        uint8_t kind;
+        uint32_t token;
+        // Only the server knows our token: anything else is stray traffic
+        if (len <= 0 || size > (int)sizeof(rx) || !media_dgram_parse_prefix(rx, (size_t)len, &kind, &token) ||
+            token != mediaUdpToken)
+        {
+            continue;
+        }
+        mediaUdpRx++;
+        if (kind == MEDIA_DGRAM_HELLO_ACK)
+        {
+            if (!mediaUdpReady) Serial.printf("[UDP] Media path up (port %u)\n", mediaUdpPort);
+            mediaUdpReady = true;
+            mediaUdpHellos = 0;
+        }
+        else if (kind == MEDIA_DGRAM_AUDIO || kind == MEDIA_DGRAM_AUDIO_RED)
+        {
+            receive_audio_frame(rx + MEDIA_DGRAM_PREFIX_BYTES, (size_t)len - MEDIA_DGRAM_PREFIX_BYTES, true,
+                                kind == MEDIA_DGRAM_AUDIO_RED);
+        }
+    }
+
+    unsigned long period = mediaUdpReady ? UDP_KEEPALIVE_MS : UDP_HELLO_MS;
+    if (mediaUdpLastHello != 0 && millis() - mediaUdpLastHello < period) return;
+    if (mediaUdpReady && mediaUdpHellos >= UDP_KEEPALIVE_MISSES)
+    {
+        // The path stopped working (NAT rebinding, firewall): back to TCP, try again
+        Serial.println("[UDP] Keepalives unanswered; audio back on the WebSocket");
+        mediaUdpReady = false;
+        mediaUdpHellos = 0;
+    }
+    else if (!mediaUdpReady && mediaUdpHellos >= UDP_HELLO_ATTEMPTS)
+    {
+        Serial.println("[UDP] No answer from the media port; audio stays on the WebSocket");
+        mediaUdpPort = 0;
+        mediaUdp.stop();
+        return;
+    }
+    send_media_datagram(MEDIA_DGRAM_HELLO, nullptr, 0);
+    mediaUdpHellos++;
+    mediaUdpLastHello = millis();
+}
+
+/**
+ * Task (Core 1): Owns the WebSocket and the UDP media socket. Runs
+ * webSocket.loop() and service_media_udp() (which also deliver received
+ * audio to the jitter buffer), drains the capture ring in order and sends
+ * the keepalive ping.
+ */
+void network_task(void *pvParameters)
+{
+    Serial.println("Starting Network Task (Core 1)...");
+    // Header version and id of the burst being sent (fixed at talk_start)
+    uint8_t burstFrameVersion = 0;
+    uint8_t burstId = 0;
+    bool firstFrame = false;
+    bool burstRed = false;
+
+    while (true)
+    {
+        webSocket.loop();
+        service_media_udp();
+
+        AudioPacket *pkt;
+        while ((pkt = txRing.peek()) != nullptr)
+        {
+            if (!isWebSocketConnected)
+            {
+                txRing.discard(); // Nobody to send to; count and move on
+                continue;
+            }
+            if (pkt->kind == AUDIO_PACKET_FRAME && pkt->codec == AUDIO_FRAME_CODEC_CN && !burstFrameVersion)
+            {
+                txRing.discard(); // Reconnected mid-burst without frame headers: a descriptor would play as audio
+                continue;
+            }
+
+            switch (pkt->kind)
+            {
+            case AUDIO_PACKET_TALK_START: {
+                // Send "talk_start" (as in client.py) plus the burst codec and header version
+                burstFrameVersion = txFrameVersion;
+                burstRed = (pkt->flags & AUDIO_PACKET_BURST_RED) != 0;
+                burstId++;
+                firstFrame = true;
+                char msg[96];
+                int n = snprintf(msg, sizeof(msg), "{\"type\":\"talk_start\",\"codec\":\"%s\"",
+                                 audio_codec_name((AudioCodecId)pkt->codec));
+                if (burstFrameVersion) n += snprintf(msg + n, sizeof(msg) - n, ",\"frame\":%u", burstFrameVersion);
+                if (burstFrameVersion && burstRed) n += snprintf(msg + n, sizeof(msg) - n, ",\"red\":1");
+                snprintf(msg + n, sizeof(msg) - n, "}");
+                webSocket.sendTXT(msg);
+                break;
+            }
+            case AUDIO_PACKET_TALK_STOP:
+                // Send "talk_stop" (as in client.py)
+                webSocket.sendTXT("{\"type\":\"talk_stop\"}");
+                break;
+            default:
+                if (burstRed && !burstFrameVersion)
+                {
+                    // Reconnected mid-burst without frame headers: send the primary alone
+                    AudioRedBlock blocks[AUDIO_RED_MAX_LEVEL];
+                    uint8_t count;
+                    const uint8_t *primary;
+                    size_t primaryLen;
+                    if (audio_red_parse(pkt->data, pkt->len, blocks, &count, &primary, &primaryLen))
+                    {
+                        webSocket.sendBIN(primary, primaryLen);
+                    }
+                }
+                else if (burstFrameVersion)
+                {
+                    uint8_t flags = pkt->flags | (firstFrame ? AUDIO_FRAME_FLAG_FIRST : 0);
+                    AudioFrameHeader hdr = {burstFrameVersion, flags, pkt->codec, burstId, pkt->seq, pkt->capture_us};
+                    audio_frame_write_header(hdr, pkt->header);
+                    if (mediaUdpReady)
+                    {
+                        send_media_datagram(burstRed ? MEDIA_DGRAM_AUDIO_RED : MEDIA_DGRAM_AUDIO, pkt->header,
+                                            AUDIO_FRAME_HEADER_BYTES + pkt->len);
+                    }
+                    else
+                    {
+                        webSocket.sendBIN(pkt->header, AUDIO_FRAME_HEADER_BYTES + pkt->len);
+                    }
+                    firstFrame = false;
+                    if (flags & AUDIO_FRAME_FLAG_PROBE)
+                    {
+                        // The packet's first sample waited one frame duration in the capture block
+                        latencyProbe.onSent(pkt->seq, (uint32_t)pkt->samples * 1000000u / SAMPLE_RATE,
+                                            pkt->capture_us, pkt->encoded_us, micros());
+                    }
+                }
+                else
+                {
+                    webSocket.sendBIN(pkt->data, pkt->len);
+                }
+                break;
+            }
+            txRing.release();
+        }
+
+        // Answer a latency probe once its first sample was played
+        LatencyReport report;
+        if (isWebSocketConnected && latencyProbe.takeReport(&report, micros()))
         {
-            webSocket.sendBIN((uint8_t *)i2s_read_buffer, bytes_read);
+            char msg[192];
+            snprintf(msg, sizeof(msg),
+                     "{\"type\":\"lat_report\",\"to\":\"%s\",\"seq\":%u,\"arrival\":%u,\"jb\":%u,\"out\":%u,\"hold\":%u}",
+                     rxProbeTalkerId.c_str(), report.seq, (unsigned)report.arrival_us, (unsigned)report.jitter_us,
+                     (unsigned)report.output_us, (unsigned)report.hold_us);
+            webSocket.sendTXT(msg);
+            Serial.printf("[LAT] listener seq=%u jitter=%ums output=%ums\n", report.seq,
+                          (unsigned)(report.jitter_us / 1000), (unsigned)(report.output_us / 1000));
+        }
+
+        // Tell each talker how many of its frames went missing, so it can size the redundancy
+        for (RxSource &s : rxSources)
+        {
+            bool talking = s.inUse && s.talkActive;
+            if (isWebSocketConnected && talking && s.redundancy && (millis() - s.lastLossReport > LOSS_REPORT_MS))
+            {
+                AudioRxStats::Stats rxf = s.frameStats.getStats();
+                if (s.lastLossReport != 0)
+                {
+                    char msg[128];
+                    snprintf(msg, sizeof(msg), "{\"type\":\"loss_report\",\"to\":\"%s\",\"lost\":%u,\"received\":%u}",
+                             s.talkerId.c_str(), (unsigned)(rxf.lost - s.lossReported.lost),
+                             (unsigned)(rxf.received - s.lossReported.received));
+                    webSocket.sendTXT(msg);
+                }
+                s.lossReported = rxf;
+                s.lastLossReport = millis();
+            }
+            else if (!talking)
+            {
+                s.lastLossReport = 0;
+            }
+        }
+
+        // Send Keepalive Ping (as in client.py)
+        if (isWebSocketConnected && (millis() - lastPingTime > KEEPALIVE_MS))
+        {
+            webSocket.sendTXT("{\"type\":\"ping\"}");
+            lastPingTime = millis();
+        }
+
+        // Woken per captured frame; the timeout keeps webSocket.loop() serviced when idle
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5));
+    }
+}
+
+/**
+ * Synthesize @p samples of audio for a missing frame of @p src into @p out:
+ * the codec's own PLC when it has one, waveform repetition otherwise.
+ */
+int conceal_frame(RxSource &src, AudioDecoder *decoder, int16_t *out, size_t samples)
+{
+    if (samples > PLAYBACK_MAX_SAMPLES) samples = PLAYBACK_MAX_SAMPLES;
+    int produced = decoder->conceal(out, samples);
+    if (produced > 0)
+    {
+        src.concealer.frameConcealedByCodec(out, (size_t)produced);
+        return produced;
+    }
+    src.concealer.conceal(out, samples);
+    return (int)samples;
+}
+
+/**
+ * Append the next frame of @p src to its unmixed audio: the frame due from
+ * its jitter buffer, decoded or (lost in transit) concealed in its slot;
+ * comfort noise through a DTX pause; or a bridge over an underrun in the
+ * middle of a burst, for up to PLC_BRIDGE_MS. playback_task only.
+ * @param decoded Set when a received frame was decoded; @p arrival_us and
+ *                @p popped_us then time it for the latency probe
+ * @return Samples appended (0: nothing due from this stream right now)
+ */
+size_t render_source(RxSource &src, bool *decoded, uint32_t *arrival_us, uint32_t *popped_us)
+{
+    const size_t bridgeMaxSamples = (size_t)SAMPLE_RATE * PLC_BRIDGE_MS / 1000;
+    uint16_t samples = 0;
+    uint8_t codec = AUDIO_CODEC_PCM16;
+    *popped_us = micros();
+    size_t payload_len = src.jitterBuffer.pop(playback_payload, &samples, &codec, *popped_us, arrival_us);
+
+    int16_t *out = src.pcm + src.pcmLen;
+    AudioDecoder *decoder = codec < AUDIO_CODEC_COUNT ? src.decoders[codec] : nullptr;
+    int produced = 0;
+    *decoded = false;
+    if (payload_len > 0 && decoder)
+    {
+        produced = decoder->decode(playback_payload, payload_len, out, PLAYBACK_MAX_SAMPLES);
+        if (produced > 0)
+        {
+            src.concealer.frameDecoded(out, (size_t)produced);
+            *decoded = true;
+            src.lastDecoder = decoder;
+            src.lastFrameSamples = (size_t)produced;
+            src.bridgedSamples = 0;
+        }
+    }
+    else if (samples > 0 && decoder)
+    {
+        // Lost in transit: its slot keeps the timing, the audio is synthesized
+        produced = conceal_frame(src, decoder, out, samples);
+    }
+    else if (src.talkActive && (src.cnPlaying || src.comfortNoise.active()))
+    {
+        // Talker paused (DTX): its background instead of dead air, also while
+        // the first frames after the pause are buffered
+        size_t cnSamples = src.lastFrameSamples ? src.lastFrameSamples : AUDIO_BUFFER_SAMPLES;
+        src.comfortNoise.generate(out, cnSamples);
+        produced = (int)cnSamples;
+        src.cnPlaying = true;
+    }
+    else if (src.talkActive && src.lastDecoder && src.bridgedSamples < bridgeMaxSamples)
+    {
+        // Underrun mid-burst: continue the last frame instead of a hard gap
+        produced = conceal_frame(src, src.lastDecoder, out, src.lastFrameSamples);
+        src.bridgedSamples += (size_t)produced;
+    }
+    else if (!src.talkActive && src.lastDecoder)
+    {
+        // Burst over: the next one starts without history
+        src.concealer.reset();
+        src.lastDecoder = nullptr;
+    }
+    if (*decoded || !src.talkActive) src.cnPlaying = false;
+    if (produced <= 0) return 0;
+    src.pcmLen += (size_t)produced;
+    return (size_t)produced;
+}
+
+/**
+ * Task (Core 1): Mixes the receive streams and feeds the I2S speaker.
+ * Every block, each stream in use is topped up to AUDIO_BUFFER_SAMPLES from
+ * its own jitter buffer (render_source) and the streams are summed with an
+ * equal-power share each (audio/audio_mixer.h); silence is written when no
+ * stream has audio. i2s_channel_write blocks once the TX DMA ring is full,
+ * so the task runs at exactly SAMPLE_RATE.
+ */
+void playback_task(void *pvParameters)
+{
+    Serial.println("Starting Playback Task (Core 1)...");
+    size_t bytes_written = 0;
+
+    while (true)
+    {
+        // The first frame decoded into this block times the latency probe
+        bool probeFrame = false;
+        uint32_t probeArrivalUs = 0;
+        uint32_t probePoppedUs = 0;
+        size_t probeOffset = 0;
+        size_t streams = 0;
+        for (RxSource &s : rxSources)
+        {
+            if (!s.inUse || s.drained) continue;
+            while (s.pcmLen < AUDIO_BUFFER_SAMPLES)
+            {
+                size_t offset = s.pcmLen;
+                bool decoded = false;
+                uint32_t arrival_us = 0;
+                uint32_t popped_us = 0;
+                if (render_source(s, &decoded, &arrival_us, &popped_us) == 0) break;
+                if (decoded && !probeFrame)
+                {
+                    probeFrame = true;
+                    probeArrivalUs = arrival_us;
+                    probePoppedUs = popped_us;
+                    probeOffset = offset;
+                }
+            }
+            if (s.pcmLen > 0)
+            {
+                streams++;
+            }
+            else if (!s.talkActive && !s.lastDecoder)
+            {
+                // Talker gone and nothing left to play: the network task frees it
+                s.bridgedSamples = 0;
+                s.lastFrameSamples = 0;
+                s.gainQ15 = 0;
+                s.drained = true;
+            }
+        }
+
+        const void *src = silence_buffer;
+        size_t len = sizeof(silence_buffer);
+        if (streams > 0)
+        {
+            // A joining talker starts at its share (times its own gain); the others glide to theirs
+            uint16_t share = AudioMixer::shareGain(streams);
+            rxMixer.start(AUDIO_BUFFER_SAMPLES);
+            for (RxSource &s : rxSources)
+            {
+                if (!s.inUse || s.drained || s.pcmLen == 0) continue;
+                size_t take = s.pcmLen < (size_t)AUDIO_BUFFER_SAMPLES ? s.pcmLen : AUDIO_BUFFER_SAMPLES;
+                uint16_t gain = AudioMixer::applyGain(share, s.volumeQ15);
+                rxMixer.add(s.pcm, take, s.gainQ15 ? s.gainQ15 : gain, gain);
+                s.gainQ15 = gain;
+                s.pcmLen -= take;
+                memmove(s.pcm, s.pcm + take, s.pcmLen * sizeof(int16_t));
+            }
+            rxMixer.finish(playback_buffer);
+            src = playback_buffer;
+            len = sizeof(playback_buffer);
+        }
+
+        i2s_channel_write(i2sTxChan, src, len, &bytes_written, portMAX_DELAY);
+        if (bytes_written != len) {
+            Serial.println("[I2S] Error writing to speaker");
+        }
+        // Echo canceller reference: the block starts once the rest of the ring has played
+        uint32_t ringAheadUs = (uint32_t)(I2S_TX_DMA_DESC * I2S_TX_DMA_FRAMES - (int)(len / sizeof(int16_t))) * 1000000u /
+                               SAMPLE_RATE;
+        echoReference.write((const int16_t *)src, len / sizeof(int16_t), i2sTxDoneUs + ringAheadUs);
+        if (probeFrame)
+        {
+            // The DMA ring is full once the write returns: its start plays before this block
+            int ahead = I2S_TX_DMA_DESC * I2S_TX_DMA_FRAMES - (int)(len / sizeof(int16_t)) + (int)probeOffset;
+            uint32_t ahead_us = ahead > 0 ? (uint32_t)ahead * 1000000u / SAMPLE_RATE : 0;
+            latencyProbe.onPlayout(probeArrivalUs, probePoppedUs, micros(), ahead_us);
         }
     }
 }
@@ -779,7 +2421,13 @@ void setup()
         Serial.println("ERROR: Could not find TCA9555 I/O expander.");
         while (1) delay(100);
     }
-    io_expander.pinMode1(EXPANDER_BUTTON_BOTTOM, INPUT);
+    for (uint8_t pin : INPUT_PINS)
+    {
+        io_expander.pinMode1(pin, INPUT);
+    }
+    // INT is open-drain on the expander side
+    pinMode(IOEXP_INT_PIN, INPUT_PULLUP);
+    inputEventQueue = xQueueCreate(16, sizeof(InputEvent));
     Serial.println("I/O Expander configured");
     delay(200);
 
@@ -792,45 +2440,61 @@ void setup()
 
     // Initialize Display and LVGL via DisplayManager
     Serial.println("Display: Initializing...");
-    if (!displayManager.init()) {
+    if (!displayManager.init(RENDER_STRATEGY)) {
         Serial.println("ERROR: Display init failed");
         while (1) delay(100);
     }
+    // Panel transfers on Core 0 so LVGL (UI task, Core 1) renders the next buffer meanwhile
+    displayManager.enableAsyncFlush(0, 2);
+    // Touch is only read through the I2C bus task (started later); LVGL reads its cache
+    displayManager.setExternalTouchPolling(true);
     
     // *** IMPORTANT: Create UI BEFORE using it ***
     Serial.println("Creating UI...");
     create_ptt_ui();
+    setupRenderStrategy();
+
+    // From here on only ui_task touches LVGL
+    if (!uiBus.begin(UI_BUS_SLOTS))
+    {
+        Serial.println("ERROR: UI bus allocation failed");
+        while (1) delay(100);
+    }
+    xTaskCreatePinnedToCore(
+        ui_task,
+        "UITask",
+        8192,
+        NULL,
+        2, // Below network (4) and playback (5): a slow frame never delays audio
+        NULL,
+        1
+    );
     
     // Now we can use lblStatus
-    lv_label_set_text(lblStatus, "INITIALIZING...");
-    displayManager.update();
+    uiStatus("INITIALIZING...");
     delay(500);
     
     // --- SD Card Initialization (SD_MMC with custom pins) ---
-    lv_label_set_text(lblStatus, "SD: Configuring pins...");
-    displayManager.update();
+    uiStatus("SD: Configuring pins...");
     Serial.println("SD: Configuring pins...");
     
     // Configure SD_MMC pins according to Kode Dot board
     if (!SD_MMC.setPins(SD_PIN_CLK, SD_PIN_CMD, SD_PIN_D0))
     {
         Serial.println("ERROR: Could not configure SD_MMC pins");
-        lv_label_set_text(lblStatus, "ERROR: SD setPins");
-        displayManager.update();
+        uiStatus("ERROR: SD setPins");
         while (1) delay(100);
     }
     Serial.println("SD_MMC pins configured");
     delay(200);
     
     // Initialize SD_MMC with 1-bit mode
-    lv_label_set_text(lblStatus, "SD: Initializing...");
-    displayManager.update();
+    uiStatus("SD: Initializing...");
     Serial.println("SD: Initializing in 1-bit mode...");
     if (!SD_MMC.begin(SD_MOUNT_POINT, 1))  // 1 = 1-bit mode
     {
         Serial.println("ERROR: Could not initialize SD card");
-        lv_label_set_text(lblStatus, "ERROR: SD failed");
-        displayManager.update();
+        uiStatus("ERROR: SD failed");
         while (1) delay(100);
     }
     Serial.println("SD initialized successfully");
@@ -847,110 +2511,202 @@ void setup()
     Serial.printf("PASSWORD (MAC): %s\n", PASSWORD.c_str());
     Serial.printf("FRIENDLY_NAME: %s\n", FRIENDLY_NAME.c_str());
 
-    lv_label_set_text(lblStatus, "Credentials OK");
-    displayManager.update();
+    uiStatus("Credentials OK");
     delay(500);
     
     // --- End of Hardware Initialization ---
 
     // --- PTT Initialization ---
+    JitterBuffer::Config jb_config = {
+        JITTER_SLOTS,
+        JITTER_MAX_FRAME_BYTES,
+        (uint32_t)SAMPLE_RATE,
+        JITTER_MIN_TARGET_MS,
+        JITTER_MAX_TARGET_MS,
+        JITTER_MAX_LATENCY_MS
+    };
+    for (uint8_t i = 0; i < AUDIO_CODEC_COUNT; i++)
+    {
+        AudioCodecId id = (AudioCodecId)i;
+        txEncoders[i] = audio_encoder_create(id, SAMPLE_RATE, OPUS_BITRATE);
+        // Decoders keep per-talker state: one set per receive stream
+        for (RxSource &s : rxSources) s.decoders[i] = audio_decoder_create(id, SAMPLE_RATE);
+        Serial.printf("Codec %s: %s\n", audio_codec_name(id),
+                      (txEncoders[i] && rxSources[0].decoders[i]) ? "available" : "unavailable");
+    }
+    txRedCopyEncoder = audio_encoder_create(AUDIO_CODEC_ADPCM, SAMPLE_RATE, 0);
+    CaptureDsp::Config dsp_config = {true, (uint16_t)HPF_HZ, AGC_ENABLED, AGC_TARGET_DBFS, (uint8_t)AGC_MAX_GAIN_DB,
+                                     true, LIMITER_CEILING_DBFS, LIMITER_LOOKAHEAD_MS};
+    txDsp.begin(dsp_config, SAMPLE_RATE);
+    txVad.begin(SAMPLE_RATE);
+    txCnEncoder.begin(SAMPLE_RATE);
+    VoxGate::Config vox_config = {VOX_OPEN_DB, VOX_CLOSE_DB, VOX_ATTACK_MS, (uint16_t)VOX_HANG_MS};
+    txVox.begin(vox_config, SAMPLE_RATE);
+    voxEnabled = VOX_ENABLED;
+    EchoCanceller::Config aec_config = {(uint16_t)AEC_TAIL_MS, AEC_SUPPRESS_DB};
+    txAec.begin(aec_config, SAMPLE_RATE);
+    echoReference.begin(SAMPLE_RATE, AEC_REF_TOLERANCE_US);
+    intercomEnabled = INTERCOM_ENABLED;
+    if (voxEnabled || intercomEnabled) uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_PTT, idle_ptt_text());
+
+    // Whole capture blocks covering PREROLL_MS
+    size_t block_ms = (size_t)AUDIO_BUFFER_SAMPLES * 1000 / SAMPLE_RATE;
+    size_t preroll_blocks = (PREROLL_MS + block_ms - 1) / block_ms;
+
+    bool rxReady = true;
+    for (RxSource &s : rxSources)
+    {
+        rxReady = rxReady && s.jitterBuffer.begin(jb_config) && s.concealer.begin(SAMPLE_RATE) &&
+                  s.decoders[AUDIO_CODEC_PCM16];
+    }
+    if (!rxReady || !txRing.begin(TX_RING_PACKETS) || !prerollBuffer.begin(preroll_blocks, AUDIO_BUFFER_SAMPLES) ||
+        !txEncoders[AUDIO_CODEC_PCM16])
+    {
+        Serial.println("ERROR: Could not allocate jitter buffer");
+        uiStatus("ERROR: Audio buffers");
+        while (1) delay(100);
+    }
+
     setupI2S();
     setupWifi();
 
     if (loginAndGetDevice())
     {
         setupWebSocket();
-        lv_label_set_text(lblStatus, "Ready");
-        displayManager.update();
+        uiStatus("Ready");
     }
     else
     {
         Serial.println("ERROR: Authentication failed");
-        lv_label_set_text(lblStatus, "Auth Failed!");
-        displayManager.update();
+        uiStatus("Auth Failed!");
         while (1) delay(100);
     }
     
     led_set_rgb(0, 0, 0); // Turn off LED
     led_show();
 
-    // --- Start Tasks (on Core 0) ---
-    lv_label_set_text(lblStatus, "STARTING TASKS...");
-    displayManager.update();
+    // --- Start Tasks ---
+    uiStatus("STARTING TASKS...");
     delay(500);
     
     xTaskCreatePinnedToCore(
-        ptt_button_task,
-        "PTTButtonTask",
-        2048,
-        NULL,
-        5,
+        network_task,
+        "NetworkTask",
+        8192,
         NULL,
-        0
+        4,
+        &networkTaskHandle,
+        1
     );
 
+    // From here on the I2C bus belongs to the bus task (input > touch > telemetry)
+    ioexpBusId = i2cBus.registerDevice("ioexp", I2CBusManager::PRIORITY_INPUT, ioexp_bus_job, NULL, INPUT_FALLBACK_POLL_MS);
+    touchBusId = i2cBus.registerDevice("touch", I2CBusManager::PRIORITY_TOUCH, touch_bus_job, NULL, TOUCH_POLL_MS);
+    fuelGaugeBusId = i2cBus.registerDevice("fuel_gauge", I2CBusManager::PRIORITY_TELEMETRY, fuel_gauge_bus_job, NULL, TELEMETRY_POLL_MS);
+    chargerBusId = i2cBus.registerDevice("charger", I2CBusManager::PRIORITY_TELEMETRY, charger_bus_job, NULL, TELEMETRY_POLL_MS);
+    i2cBus.begin(6, 0); // Above audio: key-up latency matters most
+    attachInterrupt(digitalPinToInterrupt(IOEXP_INT_PIN), ioexp_int_isr, FALLING);
+
     xTaskCreatePinnedToCore(
         i2s_read_task,
         "I2SReadTask",
-        4096,
+        32768, // Opus encoder runs on this stack
         NULL,
         5,
         NULL,
         0
     );
+
+    xTaskCreatePinnedToCore(
+        playback_task,
+        "PlaybackTask",
+        16384, // Opus decoder runs on this stack
+        NULL,
+        5,
+        NULL,
+        1
+    );
     
     Serial.println("--- Configuration Complete ---");
-    lv_label_set_text(lblStatus, "Ready");
-    displayManager.update();
+    uiStatus("Ready");
 }
 
 void loop()
 {
     // --- Main Loop Tasks (Core 1) ---
 
-    // 1. Handle WebSocket client (very important)
-    webSocket.loop();
-
-    // 2. Handle LVGL via DisplayManager (updates ticks and handlers)
-    displayManager.update();
+    // (WebSocket, talk_start/talk_stop and pings are handled by network_task)
+    // (LVGL rendering runs in ui_task; labels are changed through uiBus)
     delay(5);
 
-    // 3. Handle PTT state changes (from flag)
+    // 1. Handle PTT state changes (from flag)
     if (pttStateChanged)
     {
         pttStateChanged = false; // Reset the flag
-        if (isPttActive)
+        if (talk_key_down())
         {
-            // --- PTT PRESSED ---
-            Serial.println("PTT: START");
-            if (isWebSocketConnected) {
-                // Send "talk_start" (as in client.py)
-                webSocket.sendTXT("{\"type\":\"talk_start\"}");
+            // --- PTT PRESSED (or VOX keyed) ---
+            if (isPttActive)
+            {
+                Serial.printf("PTT: START (edge %u us ago)\n", (unsigned)((uint32_t)esp_timer_get_time() - pttEdgeTimeUs));
             }
-            lv_label_set_text(lblPttStatus, "TALKING");
+            else
+            {
+                Serial.println("VOX: START");
+            }
+            uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_PTT,
+                       isPttActive ? "TALKING" : intercomEnabled ? "INTERCOM TALKING" : "VOX TALKING");
             led_set_rgb(0, 50, 0); // Green
         }
         else
         {
-            // --- PTT RELEASED ---
+            // --- PTT RELEASED (or VOX unkeyed) ---
             Serial.println("PTT: STOP");
-             if (isWebSocketConnected) {
-                // Send "talk_stop" (as in client.py)
-                webSocket.sendTXT("{\"type\":\"talk_stop\"}");
-            }
-            lv_label_set_text(lblPttStatus, "HOLD TO TALK");
+            uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_PTT, idle_ptt_text());
             led_set_rgb(0, 0, 0); // Off
         }
         led_show();
     }
 
-    // 4. Handle incoming audio state (LED and UI)
+    // 2. D-pad events (TOP: latency measurement mode, RIGHT: VOX on/off, LEFT: intercom on/off)
+    InputEvent inputEvent;
+    while (xQueueReceive(inputEventQueue, &inputEvent, 0) == pdTRUE)
+    {
+        Serial.printf("[INPUT] pad %u %s @%u us\n", inputEvent.pin,
+                      inputEvent.pressed ? "down" : "up", (unsigned)inputEvent.time_us);
+        if (inputEvent.pin == LATENCY_PAGE_PIN && inputEvent.pressed)
+        {
+            bool on = !latencyProbe.enabled();
+            latencyProbe.enable(on, LATENCY_PROBE_MS);
+            Serial.printf("[LAT] Measurement mode %s%s\n", on ? "on" : "off",
+                          (on && !txFrameVersion) ? " (server did not ack frame headers: no probes)" : "");
+            uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_STATS, on ? "LATENCY\nhold PTT to measure" : "");
+        }
+        else if (inputEvent.pin == VOX_TOGGLE_PIN && inputEvent.pressed)
+        {
+            voxEnabled = !voxEnabled;
+            Serial.printf("[VOX] Hands-free mode %s\n", voxEnabled ? "on" : "off");
+            if (!talk_key_down()) uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_PTT, idle_ptt_text());
+        }
+        else if (inputEvent.pin == INTERCOM_TOGGLE_PIN && inputEvent.pressed)
+        {
+            intercomEnabled = !intercomEnabled;
+            Serial.printf("[AEC] Intercom mode %s\n", intercomEnabled ? "on" : "off");
+            if (!talk_key_down()) uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_PTT, idle_ptt_text());
+        }
+    }
+
+    // 3. Handle incoming audio state (LED and UI)
     if (isReceivingAudio)
     {
         // If we're receiving, update the state
-        if (!isPttActive) // Don't show "incoming" if we're talking
+        if (!talk_key_down()) // Don't show "incoming" if we're talking
         { 
-            lv_label_set_text(lblIncomingStatus, "INCOMING");
+            if (!incomingShown)
+            {
+                uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_INCOMING, "INCOMING");
+                incomingShown = true;
+            }
             led_set_rgb(60, 30, 0); // Orange
             led_show();
         }
@@ -959,20 +2715,129 @@ void loop()
     else if (millis() - lastAudioReceiveTime > AUDIO_DECAY_MS)
     {
         // If time has passed since last packet, clean up
-        if (strlen(lv_label_get_text(lblIncomingStatus)) > 0)
+        if (incomingShown)
         {
-            lv_label_set_text(lblIncomingStatus, "");
-            if (!isPttActive) {
+            uiBus.post(UI_PRODUCER_MAIN, UI_FIELD_INCOMING, "");
+            incomingShown = false;
+            if (!talk_key_down()) {
                 led_set_rgb(0, 0, 0); // Turn off
                 led_show();
             }
         }
     }
 
-    // 5. Send Keepalive Ping (as in client.py)
-    if (isWebSocketConnected && (millis() - lastPingTime > KEEPALIVE_MS))
+    // 4. Periodic audio statistics
+    if (millis() - lastStatsLogTime > AUDIO_STATS_LOG_MS)
     {
-        webSocket.sendTXT("{\"type\":\"ping\"}");
-        lastPingTime = millis();
+        // Receive streams: the first always, the others while a talker holds them
+        uint32_t rxRecovered = 0;
+        uint32_t cnSids = 0;
+        uint32_t cnFrames = 0;
+        for (int i = 0; i < RX_MAX_SOURCES; i++)
+        {
+            RxSource &s = rxSources[i];
+            JitterBuffer::Stats jb = s.jitterBuffer.getStats();
+            ComfortNoiseGenerator::Stats cn = s.comfortNoise.getStats();
+            rxRecovered += jb.recovered;
+            cnSids += cn.sids;
+            cnFrames += cn.generated_frames;
+            if (i > 0 && !s.inUse) continue;
+            Serial.printf("[JB] #%d depth=%ums target=%ums jitter=%ums pushed=%u played=%u underruns=%u overruns=%u late=%u trimmed=%u lost=%u\n",
+                          i, jb.depth_ms, jb.target_ms, jb.jitter_ms,
+                          (unsigned)jb.pushed, (unsigned)jb.played, (unsigned)jb.underruns,
+                          (unsigned)jb.overruns, (unsigned)jb.late_drops, (unsigned)jb.trimmed, (unsigned)jb.lost);
+            PacketLossConcealer::Stats plc = s.concealer.getStats();
+            Serial.printf("[PLC] #%d repeated=%u codec=%u faded_out=%u recoveries=%u\n", i,
+                          (unsigned)plc.concealed_frames, (unsigned)plc.native_frames,
+                          (unsigned)plc.faded_out, (unsigned)plc.recoveries);
+            AudioRxStats::Stats rxf = s.frameStats.getStats();
+            Serial.printf("[RXF] #%d bursts=%u received=%u lost=%u late=%u dup=%u jitter=%uus\n", i,
+                          (unsigned)rxf.bursts, (unsigned)rxf.received, (unsigned)rxf.lost,
+                          (unsigned)rxf.late, (unsigned)rxf.duplicates, (unsigned)rxf.jitter_us);
+        }
+        AudioMixer::Stats mix = rxMixer.getStats();
+        uint64_t mixBudget = (uint64_t)getCpuFrequencyMhz() * AUDIO_BUFFER_SAMPLES * 1000000 / SAMPLE_RATE;
+        Serial.printf("[MIX] %s blocks=%u avg_streams=%u.%u max_streams=%u/%d cycles/block avg=%u max=%u (%u.%02u%% of %u) busy=%u\n",
+                      rxMix ? "on" : "off", (unsigned)mix.blocks,
+                      (unsigned)(mix.blocks ? mix.streams / mix.blocks : 0),
+                      (unsigned)(mix.blocks ? mix.streams * 10ULL / mix.blocks % 10 : 0), (unsigned)mix.max_streams,
+                      RX_MAX_SOURCES, (unsigned)mix.avg_cycles, (unsigned)mix.max_cycles,
+                      (unsigned)(mix.avg_cycles * 100ULL / mixBudget), (unsigned)(mix.avg_cycles * 10000ULL / mixBudget % 100),
+                      (unsigned)mixBudget, (unsigned)rxSourcesBusy);
+        Serial.printf("[RED] tx level=%u rx recovered=%u\n", txRedController.level(), (unsigned)rxRecovered);
+        if (mediaUdpPort)
+        {
+            Serial.printf("[UDP] %s tx=%u rx=%u\n", mediaUdpReady ? "up" : "waiting", (unsigned)mediaUdpTx,
+                          (unsigned)mediaUdpRx);
+        }
+        VoxGate::Stats vox = txVox.getStats();
+        if (voxEnabled || vox.opens)
+        {
+            Serial.printf("[VOX] %s opens=%u rejected=%u keyed=%u frames\n", voxEnabled ? "on" : "off",
+                          (unsigned)vox.opens, (unsigned)vox.rejected, (unsigned)vox.keyed_frames);
+        }
+        VoiceActivityDetector::Stats vad = txVad.getStats();
+        Serial.printf("[DTX] vad speech=%u/%u onsets=%u noise=-%udBov suppressed=%u rx sids=%u cn_frames=%u\n",
+                      (unsigned)vad.speech_frames, (unsigned)vad.frames, (unsigned)vad.onsets,
+                      (unsigned)vad.noise_dbov, (unsigned)txDtxSuppressed, (unsigned)cnSids,
+                      (unsigned)cnFrames);
+        Serial.printf("[I2S] rx overflows=%u tx underruns=%u\n", (unsigned)i2sRxOverflows,
+                      (unsigned)i2sTxUnderruns);
+        if (DSP_ENABLED)
+        {
+            // Cycles per capture block against what the core has in one block's time
+            CaptureDsp::Stats dsp = txDsp.getStats();
+            uint32_t dspTotal = 0;
+            uint32_t dspMax = 0;
+            for (int s = 0; s < CAPTURE_DSP_STAGES; s++)
+            {
+                dspTotal += dsp.avg_cycles[s];
+                dspMax += dsp.max_cycles[s];
+            }
+            uint64_t budget = (uint64_t)getCpuFrequencyMhz() * AUDIO_BUFFER_SAMPLES * 1000000 / SAMPLE_RATE;
+            Serial.printf("[DSP] cycles/block dc=%u hpf=%u agc=%u lim=%u total=%u (%u.%02u%% of %u) worst=%u gain=%+ddB limited=%u/%u\n",
+                          (unsigned)dsp.avg_cycles[CAPTURE_DSP_DC], (unsigned)dsp.avg_cycles[CAPTURE_DSP_HPF],
+                          (unsigned)dsp.avg_cycles[CAPTURE_DSP_AGC], (unsigned)dsp.avg_cycles[CAPTURE_DSP_LIMITER],
+                          (unsigned)dspTotal, (unsigned)(dspTotal * 100ULL / budget),
+                          (unsigned)(dspTotal * 10000ULL / budget % 100), (unsigned)budget, (unsigned)dspMax,
+                          dsp.agc_gain_db, (unsigned)dsp.limited_blocks, (unsigned)dsp.blocks);
+        }
+        EchoCanceller::Stats aecStats = txAec.getStats();
+        if (intercomEnabled || aecStats.blocks)
+        {
+            // Same budget as the DSP chain: both run in the capture task on Core 0
+            uint64_t budget = (uint64_t)getCpuFrequencyMhz() * AUDIO_BUFFER_SAMPLES * 1000000 / SAMPLE_RATE;
+            EchoReference::Stats ref = echoReference.getStats();
+            Serial.printf("[AEC] %s taps=%u cycles/block avg=%u max=%u (%u.%02u%% of %u) erle=%ddB blocks=%u double_talk=%u takeovers=%u resets=%u ref resyncs=%u misses=%u\n",
+                          intercomEnabled ? "on" : "off", (unsigned)aecStats.taps, (unsigned)aecStats.avg_cycles,
+                          (unsigned)aecStats.max_cycles, (unsigned)(aecStats.avg_cycles * 100ULL / budget),
+                          (unsigned)(aecStats.avg_cycles * 10000ULL / budget % 100), (unsigned)budget,
+                          aecStats.erle_db, (unsigned)aecStats.blocks, (unsigned)aecStats.double_talk_blocks,
+                          (unsigned)aecStats.copies, (unsigned)aecStats.resets, (unsigned)ref.resyncs,
+                          (unsigned)ref.misses);
+        }
+        i2cBus.logStats();
+        Serial.printf("[BATT] %umV %u%% charger=%u\n", (unsigned)batteryMillivolts,
+                      (unsigned)batteryPercent, (unsigned)chargerStatus);
+        DisplayManager::FlushStats fl = displayManager.getFlushStats();
+        Serial.printf("[DISP] frames=%u last=%uus max=%uus avg=%uus render_wait=%ums\n",
+                      (unsigned)fl.frames, (unsigned)fl.last_frame_us, (unsigned)fl.max_frame_us,
+                      (unsigned)(fl.frames ? fl.total_us / fl.frames : 0), (unsigned)(fl.render_wait_us / 1000));
+        UiBus::Stats ui = uiBus.getStats();
+        Serial.printf("[UI] posted=%u applied=%u coalesced=%u overflows=%u\n",
+                      (unsigned)ui.posted, (unsigned)ui.applied, (unsigned)ui.coalesced, (unsigned)ui.overflows);
+        LatencyProbe::Stats lat = latencyProbe.getStats();
+        if (lat.probes || lat.reports)
+        {
+            Serial.printf("[LAT] probes=%u reports=%u last=%ums min=%ums avg=%ums max=%ums\n",
+                          (unsigned)lat.probes, (unsigned)lat.reports, (unsigned)(lat.last_total_us / 1000),
+                          (unsigned)(lat.min_total_us / 1000), (unsigned)(lat.avg_total_us / 1000),
+                          (unsigned)(lat.max_total_us / 1000));
+        }
+        SpscRing<AudioPacket>::Stats tx = txRing.getStats();
+        Serial.printf("[TX] depth=%u/%u high_water=%u pushed=%u overflows=%u drops=%u\n",
+                      (unsigned)tx.depth, (unsigned)tx.capacity, (unsigned)tx.high_water,
+                      (unsigned)tx.pushed, (unsigned)tx.overflows, (unsigned)tx.drops);
+        lastStatsLogTime = millis();
     }
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "ui/ui_bus.h"
+
+#include <string.h>
+
+UiBus::UiBus() : next_seq(0), applied(0), coalesced(0) {
+    memset(texts, 0, sizeof(texts));
+}
+
+bool UiBus::begin(uint32_t slots) {
+    for (uint8_t p = 0; p < UI_PRODUCER_COUNT; p++) {
+        if (!rings[p].begin(slots)) return false;
+    }
+    return true;
+}
+
+bool UiBus::post(UiProducer producer, UiField field, const char *text) {
+    if (producer >= UI_PRODUCER_COUNT || field >= UI_FIELD_COUNT) return false;
+
+    UiMessage *msg = rings[producer].acquireWrite();
+    if (!msg) return false;
+
+    msg->seq = next_seq.fetch_add(1, std::memory_order_relaxed);
+    msg->field = field;
+    strncpy(msg->text, text ? text : "", UI_TEXT_MAX - 1);
+    msg->text[UI_TEXT_MAX - 1] = '\0';
+    rings[producer].commitWrite();
+    return true;
+}
+
+uint32_t UiBus::collect() {
+    // Newest message per field across all producers
+    uint32_t latest_seq[UI_FIELD_COUNT];
+    uint32_t changed = 0;
+
+    for (uint8_t p = 0; p < UI_PRODUCER_COUNT; p++) {
+        SpscRing<UiMessage> &ring = rings[p];
+        // Only what is queued now; later posts wait for the next frame
+        uint32_t pending = ring.size();
+        for (uint32_t i = 0; i < pending; i++) {
+            const UiMessage *msg = ring.peek();
+            if (!msg) break;
+            uint32_t bit = 1u << msg->field;
+            if (changed & bit) coalesced++;
+            if (!(changed & bit) || (int32_t)(msg->seq - latest_seq[msg->field]) > 0) {
+                // Copy now: the slot is reused once released
+                memcpy(texts[msg->field], msg->text, UI_TEXT_MAX);
+                latest_seq[msg->field] = msg->seq;
+                changed |= bit;
+            }
+            ring.release();
+        }
+    }
+
+    applied += __builtin_popcount(changed);
+    return changed;
+}
+
+UiBus::Stats UiBus::getStats() const {
+    Stats st = {0, applied, coalesced, 0};
+    for (uint8_t p = 0; p < UI_PRODUCER_COUNT; p++) {
+        SpscRing<UiMessage>::Stats rs = rings[p].getStats();
+        st.posted += rs.pushed;
+        st.overflows += rs.overflows;
+    }
+    return st;
+}
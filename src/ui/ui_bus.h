@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include "audio/spsc_ring.h"
+
+// Longest text carried by one UI message (including the terminator)
+#define UI_TEXT_MAX 64
+
+/**
+ * @brief UI elements other tasks may change.
+ */
+enum UiField : uint8_t {
+    UI_FIELD_STATUS = 0,   // top status line
+    UI_FIELD_PTT = 1,      // centre PTT label
+    UI_FIELD_INCOMING = 2, // bottom "incoming" label
+    UI_FIELD_STATS = 3,    // latency stats page (empty = hidden)
+    UI_FIELD_COUNT
+};
+
+/**
+ * @brief Tasks that post UI updates. Each owns one ring, so posting stays single-producer.
+ */
+enum UiProducer : uint8_t {
+    UI_PRODUCER_MAIN = 0,    // setup() / loop()
+    UI_PRODUCER_NETWORK = 1, // network_task (WebSocket events)
+    UI_PRODUCER_COUNT
+};
+
+struct UiMessage {
+    uint32_t seq;  // global post order, so the newest update wins across producers
+    uint8_t field;
+    char text[UI_TEXT_MAX];
+};
+
+/**
+ * @brief Lock-free hand-off of UI state from any task to the UI task.
+ *
+ * Producers never touch LVGL: post() copies the text into that producer's
+ * SPSC ring and returns immediately (a full ring drops the update and counts
+ * it). Once per frame the UI task calls collect(), which drains every ring
+ * and keeps only the newest text per field, so a burst of updates costs a
+ * single LVGL change.
+ */
+class UiBus {
+public:
+    struct Stats {
+        uint32_t posted;
+        uint32_t applied;    // field changes returned by collect()
+        uint32_t coalesced;  // updates superseded within the same frame
+        uint32_t overflows;  // updates dropped on a full ring
+    };
+
+    UiBus();
+
+    /**
+     * @brief Allocate @p slots messages per producer.
+     */
+    bool begin(uint32_t slots);
+
+    /**
+     * @brief Post a new text for @p field. Never blocks.
+     * @return false if the producer's ring was full
+     */
+    bool post(UiProducer producer, UiField field, const char *text);
+
+    /**
+     * @brief UI task: drain all producers.
+     * @return Bitmask (1 << UiField) of fields whose text changed
+     */
+    uint32_t collect();
+
+    /**
+     * @brief UI task: current text of @p field (valid until the next collect()).
+     */
+    const char *text(UiField field) const { return texts[field]; }
+
+    Stats getStats() const;
+
+private:
+    SpscRing<UiMessage> rings[UI_PRODUCER_COUNT];
+    std::atomic<uint32_t> next_seq;
+
+    // Consumer-side state
+    char texts[UI_FIELD_COUNT][UI_TEXT_MAX];
+    uint32_t applied;
+    uint32_t coalesced;
+};
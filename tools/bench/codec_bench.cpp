@@ -0,0 +1,113 @@
+/*
+ * Host benchmark for the PTT audio codecs (src/audio/audio_codec.*).
+ *
+ * Usage: codec_bench [input.wav] [iterations]
+ *
+ * Encodes and decodes the input in 256-sample capture blocks (the firmware's
+ * AUDIO_BUFFER_SAMPLES) with every codec available in this build and reports
+ * per-frame cost, bitrate and SNR against the input.
+ */
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "audio/audio_codec.h"
+#include "../common/test_signal.h"
+#include "../common/wav.h"
+
+static const uint32_t SAMPLE_RATE = 16000;
+static const size_t BLOCK_SAMPLES = 256;
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_since(Clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// SNR of decoded vs input, searching a small lag window (Opus adds look-ahead delay)
+static double snr_db(const std::vector<int16_t> &ref, const std::vector<int16_t> &out) {
+    double best = -100.0;
+    for (size_t lag = 0; lag < 400 && lag < out.size(); lag++) {
+        double sig = 0.0, err = 0.0;
+        for (size_t i = 0; i + lag < out.size() && i < ref.size(); i++) {
+            double d = (double)out[i + lag] - ref[i];
+            sig += (double)ref[i] * ref[i];
+            err += d * d;
+        }
+        double snr = err > 0.0 ? 10.0 * log10(sig / err) : 99.0;
+        if (snr > best) best = snr;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    std::vector<int16_t> input;
+    uint32_t rate = SAMPLE_RATE;
+    if (argc > 1) {
+        if (!wav_read_mono16(argv[1], input, rate)) {
+            fprintf(stderr, "Cannot read 16-bit WAV: %s\n", argv[1]);
+            return 1;
+        }
+        if (rate != SAMPLE_RATE) fprintf(stderr, "Warning: %s is %u Hz, coded as %u Hz\n", argv[1], rate, SAMPLE_RATE);
+    } else {
+        input = test_signal_voice(SAMPLE_RATE, 10.0f);
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+    if (iterations < 1) iterations = 1;
+
+    size_t blocks = input.size() / BLOCK_SAMPLES;
+    double audio_s = (double)blocks * BLOCK_SAMPLES / SAMPLE_RATE;
+    printf("Input: %zu blocks of %zu samples (%.1f s), %d iterations\n\n", blocks, BLOCK_SAMPLES, audio_s, iterations);
+    printf("%-6s %10s %10s %10s %10s %8s\n", "codec", "enc ns/blk", "dec ns/pkt", "bytes/pkt", "kbit/s", "SNR dB");
+
+    for (uint8_t c = 0; c < AUDIO_CODEC_COUNT; c++) {
+        AudioCodecId id = (AudioCodecId)c;
+        if (!audio_codec_available(id)) {
+            printf("%-6s (not available in this build)\n", audio_codec_name(id));
+            continue;
+        }
+        AudioEncoder *enc = audio_encoder_create(id, SAMPLE_RATE, 16000);
+        AudioDecoder *dec = audio_decoder_create(id, SAMPLE_RATE);
+        if (!enc || !dec) {
+            printf("%-6s (init failed)\n", audio_codec_name(id));
+            continue;
+        }
+
+        std::vector<std::vector<uint8_t>> packets;
+        std::vector<int16_t> decoded;
+        std::vector<uint8_t> pkt(4000);
+        std::vector<int16_t> pcm(2000);
+        double enc_ns = 0.0, dec_ns = 0.0;
+        size_t total_bytes = 0;
+
+        for (int it = 0; it < iterations; it++) {
+            enc->reset();
+            packets.clear();
+            Clock::time_point t0 = Clock::now();
+            for (size_t b = 0; b < blocks; b++) {
+                int n = enc->encode(&input[b * BLOCK_SAMPLES], BLOCK_SAMPLES, pkt.data(), pkt.size());
+                if (n > 0) packets.emplace_back(pkt.begin(), pkt.begin() + n);
+            }
+            enc_ns += ns_since(t0);
+
+            decoded.clear();
+            t0 = Clock::now();
+            for (const std::vector<uint8_t> &p : packets) {
+                int n = dec->decode(p.data(), p.size(), pcm.data(), pcm.size());
+                if (n > 0) decoded.insert(decoded.end(), pcm.begin(), pcm.begin() + n);
+            }
+            dec_ns += ns_since(t0);
+        }
+        for (const std::vector<uint8_t> &p : packets) total_bytes += p.size();
+
+        double pkts = packets.empty() ? 1.0 : (double)packets.size();
+        printf("%-6s %10.0f %10.0f %10.1f %10.1f %8.1f\n", audio_codec_name(id),
+               enc_ns / iterations / blocks, dec_ns / iterations / pkts, total_bytes / pkts,
+               total_bytes * 8.0 / audio_s / 1000.0, snr_db(input, decoded));
+        delete enc;
+        delete dec;
+    }
+    return 0;
+}
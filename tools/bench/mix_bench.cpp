@@ -0,0 +1,84 @@
+/*
+ * Host benchmark for the receive mixer's accumulate kernel (src/audio/audio_mixer.*).
+ *
+ * Usage: mix_bench [iterations]
+ *
+ * Adds blocks of the built-in test signal into a 32-bit accumulator with the
+ * scalar reference and the kernel, checks that both agree bit for bit at
+ * unity, at the equal-power shares and at per-talker gains (including
+ * full-scale input and an odd-length tail), and reports the cost of mixing
+ * one to RX_MAX_SOURCES talkers per 256-sample block.
+ */
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "audio/audio_mixer.h"
+#include "../common/test_signal.h"
+
+static const uint32_t SAMPLE_RATE = 16000;
+static const size_t BLOCK_SAMPLES = 256;
+static const size_t MAX_TALKERS = 3; // RX_MAX_SOURCES in main.cpp
+
+typedef std::chrono::steady_clock Clock;
+typedef void (*AccumulateFn)(int32_t *, const int16_t *, size_t, uint16_t);
+
+static double ns_since(Clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Mix @p talkers copies of the signal (offset so they differ) at their share, block by block
+static double time_blocks(AccumulateFn fn, const std::vector<int16_t> &in, std::vector<int32_t> &acc, size_t talkers,
+                          int iterations) {
+    size_t blocks = (in.size() - MAX_TALKERS * 1000) / BLOCK_SAMPLES;
+    uint16_t share = AudioMixer::shareGain(talkers);
+    Clock::time_point t0 = Clock::now();
+    for (int it = 0; it < iterations; it++) {
+        for (size_t b = 0; b < blocks; b++) {
+            int32_t *dst = &acc[b * BLOCK_SAMPLES];
+            for (size_t t = 0; t < talkers; t++) fn(dst, &in[b * BLOCK_SAMPLES + t * 1000], BLOCK_SAMPLES, share);
+        }
+    }
+    return ns_since(t0) / iterations / blocks;
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    if (iterations < 1) iterations = 1;
+
+    std::vector<int16_t> in = test_signal_voice(SAMPLE_RATE, 10.0f);
+    // Extremes and an odd-length tail for the unrolled loop
+    in.push_back(INT16_MAX);
+    in.push_back(INT16_MIN);
+    in.push_back(-1);
+    std::vector<int32_t> ref(in.size()), out(in.size());
+
+    // Bit-exactness at unity, the shares, a sweep of listener gains and their products
+    std::vector<uint16_t> gains = {AUDIO_MIX_UNITY_Q15, 65535, 0, 1};
+    for (size_t n = 2; n <= MAX_TALKERS; n++) gains.push_back(AudioMixer::shareGain(n));
+    for (uint32_t g = 7; g < AUDIO_MIX_UNITY_Q15; g += 1021) {
+        gains.push_back((uint16_t)g);
+        gains.push_back(AudioMixer::applyGain(AudioMixer::shareGain(2), (uint16_t)g));
+    }
+    for (uint16_t gain : gains) {
+        for (size_t i = 0; i < in.size(); i++) ref[i] = out[i] = (int32_t)(i * 2654435761u) >> 12;
+        audio_mix_accumulate_ref(ref.data(), in.data(), in.size(), gain);
+        audio_mix_accumulate(out.data(), in.data(), in.size(), gain);
+        for (size_t i = 0; i < in.size(); i++) {
+            if (out[i] != ref[i]) {
+                fprintf(stderr, "Mismatch at gain %u, sample %zu: %d != %d\n", gain, i, out[i], ref[i]);
+                return 1;
+            }
+        }
+    }
+    printf("Kernel matches the reference for %zu gains (%zu samples each)\n\n", gains.size(), in.size());
+
+    printf("%-8s %12s %13s %9s\n", "talkers", "ref ns/blk", "kernel ns/blk", "speedup");
+    for (size_t talkers = 1; talkers <= MAX_TALKERS; talkers++) {
+        double ref_ns = time_blocks(audio_mix_accumulate_ref, in, ref, talkers, iterations);
+        double fast_ns = time_blocks(audio_mix_accumulate, in, out, talkers, iterations);
+        printf("%-8zu %12.1f %13.1f %8.1fx\n", talkers, ref_ns, fast_ns, fast_ns > 0.0 ? ref_ns / fast_ns : 0.0);
+    }
+    return 0;
+}
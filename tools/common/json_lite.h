@@ -0,0 +1,127 @@
+#pragma once
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+ * Just enough JSON for the PTT control protocol in host tools: flat objects
+ * with string/number values and string arrays. Not a general parser.
+ */
+
+// Position just after `"key":` (whitespace skipped), or npos
+static inline size_t json_find_value(const std::string &json, const char *key) {
+    std::string needle = std::string("\"") + key + "\"";
+    size_t pos = 0;
+    while ((pos = json.find(needle, pos)) != std::string::npos) {
+        size_t p = pos + needle.size();
+        while (p < json.size() && isspace((unsigned char)json[p])) p++;
+        if (p < json.size() && json[p] == ':') {
+            p++;
+            while (p < json.size() && isspace((unsigned char)json[p])) p++;
+            return p;
+        }
+        pos = p;
+    }
+    return std::string::npos;
+}
+
+// Parse a JSON string literal starting at json[p] == '"'; advances p past it
+static inline bool json_parse_string(const std::string &json, size_t &p, std::string &out) {
+    if (p >= json.size() || json[p] != '"') return false;
+    out.clear();
+    for (p++; p < json.size(); p++) {
+        char c = json[p];
+        if (c == '"') {
+            p++;
+            return true;
+        }
+        if (c == '\\' && p + 1 < json.size()) {
+            char e = json[++p];
+            switch (e) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u':
+                // Control protocol is ASCII; keep BMP escapes as '?'
+                p += 4;
+                out += '?';
+                break;
+            default: out += e; break;
+            }
+        } else {
+            out += c;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read a top-level string value; @p fallback if missing or not a string.
+ */
+static inline std::string json_get_string(const std::string &json, const char *key, const char *fallback = "") {
+    size_t p = json_find_value(json, key);
+    std::string out;
+    if (p == std::string::npos || !json_parse_string(json, p, out)) return fallback;
+    return out;
+}
+
+/**
+ * @brief Read a numeric value; @p fallback if missing.
+ */
+static inline double json_get_number(const std::string &json, const char *key, double fallback = 0.0) {
+    size_t p = json_find_value(json, key);
+    if (p == std::string::npos) return fallback;
+    char *end = nullptr;
+    double v = strtod(json.c_str() + p, &end);
+    return end == json.c_str() + p ? fallback : v;
+}
+
+/**
+ * @brief Read an array of strings (non-string elements are skipped).
+ */
+static inline std::vector<std::string> json_get_string_array(const std::string &json, const char *key) {
+    std::vector<std::string> out;
+    size_t p = json_find_value(json, key);
+    if (p == std::string::npos || json[p] != '[') return out;
+    for (p++; p < json.size() && json[p] != ']';) {
+        if (json[p] == '"') {
+            std::string s;
+            if (!json_parse_string(json, p, s)) break;
+            out.push_back(s);
+        } else {
+            p++;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Quote and escape @p s as a JSON string literal.
+ */
+static inline std::string json_quote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Deterministic voice-like test signal: a gliding harmonic series with
+ * syllable-rate amplitude modulation, short pauses and a low noise floor.
+ * Used when no WAV file is given to a host tool.
+ */
+static inline std::vector<int16_t> test_signal_voice(uint32_t sample_rate, float seconds) {
+    std::vector<int16_t> out((size_t)(sample_rate * seconds));
+    uint32_t noise = 0x12345678u;
+    double phase = 0.0;
+    for (size_t n = 0; n < out.size(); n++) {
+        double t = (double)n / sample_rate;
+        double f0 = 140.0 + 40.0 * sin(2.0 * M_PI * 0.7 * t);       // pitch glide
+        double syllable = 0.5 + 0.5 * sin(2.0 * M_PI * 4.0 * t);    // ~4 syllables/s
+        bool pause = fmod(t, 3.0) > 2.4;                            // 600 ms pause every 3 s
+        phase += 2.0 * M_PI * f0 / sample_rate;
+        double v = 0.0;
+        for (int h = 1; h <= 12; h++) v += sin(h * phase) / h;
+        v *= pause ? 0.0 : syllable * 6000.0;
+        noise = noise * 1664525u + 1013904223u;
+        v += ((int32_t)(noise >> 16) - 32768) / 256.0;              // ~-60 dBFS noise
+        out[n] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+    }
+    return out;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @brief Minimal RIFF/WAVE reader for 16-bit PCM files (host tools only).
+ *
+ * Multi-channel files are reduced to their first channel.
+ * @return true on success; @p samples and @p sample_rate are filled in
+ */
+static inline bool wav_read_mono16(const char *path, std::vector<int16_t> &samples, uint32_t &sample_rate) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    uint8_t riff[12];
+    if (fread(riff, 1, 12, f) != 12 || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        fclose(f);
+        return false;
+    }
+
+    uint16_t channels = 0, bits = 0;
+    bool ok = false;
+    uint8_t hdr[8];
+    while (fread(hdr, 1, 8, f) == 8) {
+        uint32_t size = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | ((uint32_t)hdr[7] << 24);
+        if (memcmp(hdr, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16) break;
+            channels = fmt[2] | (fmt[3] << 8);
+            sample_rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            bits = fmt[14] | (fmt[15] << 8);
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            if (bits != 16 || channels == 0) break;
+            std::vector<int16_t> raw(size / 2);
+            size_t got = fread(raw.data(), 2, raw.size(), f);
+            samples.clear();
+            for (size_t i = 0; i + channels <= got; i += channels) samples.push_back(raw[i]);
+            ok = true;
+            break;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Write 16-bit mono PCM as a WAV file.
+ */
+static inline bool wav_write_mono16(const char *path, const int16_t *samples, size_t count, uint32_t sample_rate) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    uint32_t data_bytes = (uint32_t)(count * 2);
+    uint32_t byte_rate = sample_rate * 2;
+    uint8_t h[44] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
+                     16, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 16, 0,
+                     'd', 'a', 't', 'a', 0, 0, 0, 0};
+    uint32_t riff_size = 36 + data_bytes;
+    for (int i = 0; i < 4; i++) {
+        h[4 + i] = (uint8_t)(riff_size >> (8 * i));
+        h[24 + i] = (uint8_t)(sample_rate >> (8 * i));
+        h[28 + i] = (uint8_t)(byte_rate >> (8 * i));
+        h[40 + i] = (uint8_t)(data_bytes >> (8 * i));
+    }
+    bool ok = fwrite(h, 1, 44, f) == 44 && fwrite(samples, 2, count, f) == count;
+    fclose(f);
+    return ok;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+/*
+ * RFC 6455 helpers shared by the host relay and load generator:
+ * handshake key hashing and frame header encode/parse.
+ */
+
+enum WsOpcode : uint8_t {
+    WS_OP_CONTINUATION = 0x0,
+    WS_OP_TEXT = 0x1,
+    WS_OP_BINARY = 0x2,
+    WS_OP_CLOSE = 0x8,
+    WS_OP_PING = 0x9,
+    WS_OP_PONG = 0xA
+};
+
+// Longest frame header: 2 + 8 (64-bit length) + 4 (mask)
+static const size_t WS_MAX_HEADER_BYTES = 14;
+
+struct WsFrameHeader {
+    bool fin;
+    uint8_t opcode;
+    bool masked;
+    uint8_t mask[4];
+    uint64_t payload_len;
+    size_t header_len;
+};
+
+/**
+ * @brief SHA-1 of @p len bytes (only used for Sec-WebSocket-Accept).
+ */
+static inline void ws_sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u};
+    uint64_t bit_len = (uint64_t)len * 8;
+    size_t total = ((len + 8) / 64 + 1) * 64;
+
+    for (size_t off = 0; off < total; off += 64) {
+        uint8_t block[64];
+        for (size_t i = 0; i < 64; i++) {
+            size_t p = off + i;
+            if (p < len) block[i] = data[p];
+            else if (p == len) block[i] = 0x80;
+            else if (p >= total - 8) block[i] = (uint8_t)(bit_len >> (8 * (total - 1 - p)));
+            else block[i] = 0;
+        }
+
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+                   ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+        }
+        for (int i = 16; i < 80; i++) {
+            uint32_t v = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = (v << 1) | (v >> 31);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999u; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1u; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDCu; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6u; }
+            uint32_t t = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = (b << 30) | (b >> 2);
+            b = a;
+            a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        out[4 * i] = (uint8_t)(h[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(h[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(h[i] >> 8);
+        out[4 * i + 3] = (uint8_t)h[i];
+    }
+}
+
+static inline std::string ws_base64(const uint8_t *data, size_t len) {
+    static const char *tbl = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        out += tbl[(v >> 18) & 63];
+        out += tbl[(v >> 12) & 63];
+        out += (i + 1 < len) ? tbl[(v >> 6) & 63] : '=';
+        out += (i + 2 < len) ? tbl[v & 63] : '=';
+    }
+    return out;
+}
+
+/**
+ * @brief Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key.
+ */
+static inline std::string ws_accept_key(const std::string &key) {
+    std::string s = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    uint8_t digest[20];
+    ws_sha1((const uint8_t *)s.data(), s.size(), digest);
+    return ws_base64(digest, sizeof(digest));
+}
+
+/**
+ * @brief Encode a single-fragment frame header.
+ * @param mask Client frames pass a 4-byte key; servers pass nullptr
+ * @return Header length written to @p out (at most WS_MAX_HEADER_BYTES)
+ */
+static inline size_t ws_encode_header(uint8_t *out, uint8_t opcode, uint64_t payload_len, const uint8_t *mask) {
+    size_t n = 0;
+    uint8_t mask_bit = mask ? 0x80 : 0x00;
+    out[n++] = 0x80 | opcode;
+    if (payload_len < 126) {
+        out[n++] = mask_bit | (uint8_t)payload_len;
+    } else if (payload_len <= 0xFFFF) {
+        out[n++] = mask_bit | 126;
+        out[n++] = (uint8_t)(payload_len >> 8);
+        out[n++] = (uint8_t)payload_len;
+    } else {
+        out[n++] = mask_bit | 127;
+        for (int i = 7; i >= 0; i--) out[n++] = (uint8_t)(payload_len >> (8 * i));
+    }
+    if (mask) {
+        memcpy(out + n, mask, 4);
+        n += 4;
+    }
+    return n;
+}
+
+/**
+ * @brief Parse a frame header from the start of @p buf.
+ * @return false if fewer than header_len bytes are available yet
+ */
+static inline bool ws_parse_header(const uint8_t *buf, size_t avail, WsFrameHeader &h) {
+    if (avail < 2) return false;
+    h.fin = buf[0] & 0x80;
+    h.opcode = buf[0] & 0x0F;
+    h.masked = buf[1] & 0x80;
+    h.payload_len = buf[1] & 0x7F;
+    size_t n = 2;
+    if (h.payload_len == 126) {
+        if (avail < 4) return false;
+        h.payload_len = ((uint64_t)buf[2] << 8) | buf[3];
+        n = 4;
+    } else if (h.payload_len == 127) {
+        if (avail < 10) return false;
+        h.payload_len = 0;
+        for (int i = 0; i < 8; i++) h.payload_len = (h.payload_len << 8) | buf[2 + i];
+        n = 10;
+    }
+    if (h.masked) {
+        if (avail < n + 4) return false;
+        memcpy(h.mask, buf + n, 4);
+        n += 4;
+    }
+    h.header_len = n;
+    return true;
+}
+
+/**
+ * @brief XOR @p len bytes with the frame mask (masking and unmasking are the same).
+ */
+static inline void ws_apply_mask(uint8_t *data, size_t len, const uint8_t mask[4]) {
+    for (size_t i = 0; i < len; i++) data[i] ^= mask[i & 3];
+}
@@ -0,0 +1,835 @@
+/*
+ * Load generator for the PTT client protocol: N virtual Kode Dot clients.
+ *
+ * Usage: ptt_loadgen [--host 127.0.0.1] [--port 8000] [--clients 50] [--talkers 1]
+ *                    [--talk-ms 4000] [--idle-ms 4000] [--codec pcm|adpcm|opus]
+ *                    [--wav speech.wav] [--duration 60] [--ramp-ms 10]
+ *                    [--churn-s 0] [--reconnect-ms 5000] [--report-s 5] [--user-prefix lg]
+ *                    [--udp]
+ *
+ * Every client follows the firmware: POST /token (on 401: /register, then
+ * /token again), GET /devices/me, WebSocket /ws/<id>?token=, "caps", then
+ * talk bursts of "talk_start" + paced binary frames + "talk_stop", with a
+ * "ping" every 20 s. Talk/idle durations are randomized by +-50%.
+ *
+ * Frames carry the audio (encoded once up front with the firmware codecs,
+ * in the firmware's 256-sample capture blocks) plus a 20-byte trailer with
+ * sender, sequence number and send time. Receivers use it for end-to-end
+ * latency (all clients share one clock) and loss (sequence gaps per sender).
+ * Real devices in the same talk group hear the trailer as a short click.
+ *
+ * Clients whose session drops reconnect after --reconnect-ms (the
+ * firmware's WebSocket reconnect interval); --churn-s additionally drops
+ * sessions at random (mean interval) to measure reconnect cost.
+ *
+ * --udp offers the UDP media path like the firmware ("frame":1,"udp":1 in
+ * caps, HELLO to the port from caps_ack) and, once answered, sends and
+ * receives audio as datagrams with the 8-byte frame header in front. Run
+ * twice, with and without it, under netem to compare TCP head-of-line
+ * blocking against datagram loss.
+ *
+ * One thread per client; the generator is mostly idle, so a few thousand
+ * clients fit on a laptop before it, rather than the relay, becomes the limit.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "audio/audio_codec.h"
+#include "audio/audio_frame.h"
+#include "audio/media_datagram.h"
+#include "../common/json_lite.h"
+#include "../common/test_signal.h"
+#include "../common/wav.h"
+#include "../common/ws_protocol.h"
+
+static const uint32_t SAMPLE_RATE = 16000;
+static const size_t BLOCK_SAMPLES = 256;          // firmware AUDIO_BUFFER_SAMPLES
+static const uint32_t OPUS_BITRATE = 16000;       // firmware OPUS_BITRATE
+static const int64_t KEEPALIVE_US = 20000000;     // firmware KEEPALIVE_MS
+static const int IO_TIMEOUT_MS = 5000;
+static const uint32_t TRAILER_MAGIC = 0x31474C50; // "PLG1"
+static const size_t TRAILER_BYTES = 20;
+static const int MAX_TX_LAG_FRAMES = 5;           // resync the send clock beyond this
+static const int64_t UDP_HELLO_US = 500000;       // firmware UDP_HELLO_MS
+static const int64_t UDP_KEEPALIVE_US = 15000000; // firmware UDP_KEEPALIVE_MS
+
+static std::atomic<bool> stop_requested(false);
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// =================================================================
+// --- Configuration and shared statistics ---
+// =================================================================
+struct LoadConfig {
+    std::string host = "127.0.0.1";
+    uint16_t port = 8000;
+    uint32_t clients = 50;
+    uint32_t talkers = 1;
+    uint32_t talk_ms = 4000;
+    uint32_t idle_ms = 4000;
+    AudioCodecId codec = AUDIO_CODEC_PCM16;
+    const char *wav = nullptr;
+    uint32_t duration_s = 60;
+    uint32_t ramp_ms = 10;
+    double churn_s = 0.0;
+    uint32_t reconnect_ms = 5000;
+    uint32_t report_s = 5;
+    std::string user_prefix = "lg";
+    bool udp = false;
+};
+
+static LoadConfig cfg;
+
+/**
+ * @brief Lock-free latency histogram: 10 us steps to 10 ms, 100 us to 100 ms, 1 ms to 5 s.
+ */
+class LatencyHistogram {
+public:
+    static const size_t BUCKETS = 1000 + 900 + 4900 + 1;
+
+    LatencyHistogram() {
+        for (auto &c : counts) c.store(0, std::memory_order_relaxed);
+    }
+
+    void record(int64_t us) {
+        if (us < 0) us = 0;
+        counts[bucketOf((uint64_t)us)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t prev = max_us.load(std::memory_order_relaxed);
+        while ((uint64_t)us > prev && !max_us.compare_exchange_weak(prev, (uint64_t)us)) {
+        }
+    }
+
+    std::vector<uint64_t> snapshot() const {
+        std::vector<uint64_t> out(BUCKETS);
+        for (size_t i = 0; i < BUCKETS; i++) out[i] = counts[i].load(std::memory_order_relaxed);
+        return out;
+    }
+
+    uint64_t max() const { return max_us.load(); }
+
+    // Percentile of a cumulative snapshot, capped by the exact maximum
+    double percentileMs(const std::vector<uint64_t> &c, double p) const {
+        return std::min(bucketPercentileMs(c, p), max() / 1000.0);
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 100)
+    static double bucketPercentileMs(const std::vector<uint64_t> &c, double p) {
+        uint64_t total = 0;
+        for (uint64_t v : c) total += v;
+        if (!total) return 0.0;
+        uint64_t rank = (uint64_t)ceil(total * p / 100.0);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < c.size(); i++) {
+            seen += c[i];
+            if (seen >= rank) return bucketUpper(i) / 1000.0;
+        }
+        return bucketUpper(c.size() - 1) / 1000.0;
+    }
+
+    static uint64_t total(const std::vector<uint64_t> &c) {
+        uint64_t t = 0;
+        for (uint64_t v : c) t += v;
+        return t;
+    }
+
+private:
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> max_us{0};
+
+    static size_t bucketOf(uint64_t us) {
+        if (us < 10000) return us / 10;
+        if (us < 100000) return 1000 + (us - 10000) / 100;
+        if (us < 5000000) return 1900 + (us - 100000) / 1000;
+        return BUCKETS - 1;
+    }
+    static uint64_t bucketUpper(size_t i) {
+        if (i < 1000) return (i + 1) * 10;
+        if (i < 1900) return 10000 + (i - 1000 + 1) * 100;
+        if (i < BUCKETS - 1) return 100000 + (i - 1900 + 1) * 1000;
+        return 5000000;
+    }
+};
+
+struct LoadStats {
+    std::atomic<uint32_t> sessions_up{0};
+    std::atomic<uint32_t> talking{0};
+    std::atomic<uint32_t> udp_up{0};            // sessions whose media path is answered
+    std::atomic<uint64_t> frames_sent{0};
+    std::atomic<uint64_t> bytes_sent{0};
+    std::atomic<uint64_t> frames_received{0};
+    std::atomic<uint64_t> frames_expected{0};  // per (receiver, sender): sequence span seen
+    std::atomic<uint64_t> tx_late{0};          // send clock resynced (generator or socket too slow)
+    std::atomic<uint64_t> connect_failures{0};
+    std::atomic<uint64_t> unplanned_drops{0};
+    std::atomic<uint64_t> churn_drops{0};
+    std::atomic<uint64_t> reconnects{0};
+    LatencyHistogram latency;    // frame send -> receive, all receivers
+    LatencyHistogram connect;    // login + WebSocket handshake
+    LatencyHistogram reconnect;  // session lost -> session up again (includes backoff)
+};
+
+static LoadStats stats;
+
+// Encoded audio shared by every talker
+struct EncodedFrame {
+    std::vector<uint8_t> data;
+    uint32_t samples;
+};
+static std::vector<EncodedFrame> audio_frames[AUDIO_CODEC_COUNT];
+
+// =================================================================
+// --- Blocking socket helpers ---
+// =================================================================
+static int tcp_connect(const std::string &host, uint16_t port) {
+    addrinfo hints = {}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res) return -1;
+    int fd = socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, 0);
+    if (fd >= 0) {
+        timeval tv = {IO_TIMEOUT_MS / 1000, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static bool send_all(int fd, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0) {
+        ssize_t w = send(fd, p, len, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        len -= (size_t)w;
+    }
+    return true;
+}
+
+/**
+ * @brief One HTTP/1.1 request on its own connection (Connection: close).
+ * @return Status code, or -1 on a transport error
+ */
+static int http_request(const char *method, const std::string &path, const std::string &content_type,
+                        const std::string &body, const std::string &auth, std::string &resp_body) {
+    int fd = tcp_connect(cfg.host, cfg.port);
+    if (fd < 0) return -1;
+
+    std::string req = std::string(method) + " " + path + " HTTP/1.1\r\n" +
+                      "Host: " + cfg.host + ":" + std::to_string(cfg.port) + "\r\n" +
+                      "Connection: close\r\n";
+    if (!auth.empty()) req += "Authorization: Bearer " + auth + "\r\n";
+    if (!content_type.empty()) req += "Content-Type: " + content_type + "\r\n";
+    req += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+
+    std::string resp;
+    if (send_all(fd, req.data(), req.size())) {
+        char buf[4096];
+        ssize_t r;
+        while ((r = recv(fd, buf, sizeof(buf), 0)) > 0) resp.append(buf, (size_t)r);
+    }
+    close(fd);
+
+    size_t head_end = resp.find("\r\n\r\n");
+    if (resp.compare(0, 5, "HTTP/") != 0 || head_end == std::string::npos) return -1;
+    resp_body = resp.substr(head_end + 4);
+    return atoi(resp.c_str() + resp.find(' ') + 1);
+}
+
+// =================================================================
+// --- Virtual client ---
+// =================================================================
+struct SenderTrack {
+    uint32_t last_seq;
+};
+
+class VirtualClient {
+public:
+    VirtualClient(uint32_t index, bool talker)
+        : index(index), talker(talker), rng(0x5EED0000u + index),
+          username(cfg.user_prefix + "-" + std::to_string(index)) {}
+
+    /**
+     * @brief Credentials and device id (same flow as the firmware's loginAndGetDevice()).
+     */
+    bool login();
+    void run();
+
+private:
+    uint32_t index;
+    bool talker;
+    std::mt19937 rng;
+    std::string username;
+    std::string token;
+    std::string device_id;
+
+    int fd = -1;
+    std::vector<uint8_t> rx;
+    AudioCodecId codec = AUDIO_CODEC_PCM16;
+    uint32_t seq = 0;
+    size_t audio_pos = 0;
+    std::unordered_map<uint16_t, SenderTrack> senders;
+
+    // UDP media path (--udp)
+    int udp_fd = -1;
+    uint32_t udp_token = 0;
+    bool udp_ready = false;
+    int64_t next_hello = 0;
+
+    bool openSession();
+    bool session();
+    bool sendFrame(uint8_t opcode, const uint8_t *payload, size_t len);
+    bool sendText(const std::string &text) { return sendFrame(WS_OP_TEXT, (const uint8_t *)text.data(), text.size()); }
+    bool sendAudio();
+    bool readFrames();
+    void openMediaPath(uint16_t port, uint32_t token);
+    void closeMediaPath();
+    void sendHello();
+    void readDatagrams();
+    void onBinary(const uint8_t *payload, size_t len);
+    double jitter(uint32_t ms) { return ms * std::uniform_real_distribution<double>(0.5, 1.5)(rng); }
+};
+
+bool VirtualClient::login() {
+    std::string form = "username=" + username + "&password=" + username;
+    std::string body;
+    int status = http_request("POST", "/token", "application/x-www-form-urlencoded", form, "", body);
+    if (status == 401) {
+        std::string reg = "{\"username\":" + json_quote(username) + ",\"password\":" + json_quote(username) +
+                          ",\"friendlyName\":" + json_quote(username) + "}";
+        status = http_request("POST", "/register", "application/json", reg, "", body);
+        if (status != 200 && status != 201) return false;
+        status = http_request("POST", "/token", "application/x-www-form-urlencoded", form, "", body);
+    }
+    if (status != 200) return false;
+    token = json_get_string(body, "access_token");
+
+    if (http_request("GET", "/devices/me", "", "", token, body) != 200) return false;
+    device_id = json_get_string(body, "deviceId");
+    return !token.empty() && !device_id.empty();
+}
+
+bool VirtualClient::openSession() {
+    fd = tcp_connect(cfg.host, cfg.port);
+    if (fd < 0) return false;
+
+    uint8_t key_bytes[16];
+    for (uint8_t &b : key_bytes) b = (uint8_t)rng();
+    std::string key = ws_base64(key_bytes, sizeof(key_bytes));
+    std::string req = "GET /ws/" + device_id + "?token=" + token + " HTTP/1.1\r\n" +
+                      "Host: " + cfg.host + ":" + std::to_string(cfg.port) + "\r\n" +
+                      "Connection: Upgrade\r\nUpgrade: websocket\r\nSec-WebSocket-Version: 13\r\n" +
+                      "Sec-WebSocket-Key: " + key + "\r\nSec-WebSocket-Protocol: arduino\r\n\r\n";
+    if (!send_all(fd, req.data(), req.size())) return false;
+
+    // Response head; anything after it is already frame data
+    rx.clear();
+    size_t head_end;
+    while ((head_end = std::string(rx.begin(), rx.end()).find("\r\n\r\n")) == std::string::npos) {
+        uint8_t buf[1024];
+        ssize_t r = recv(fd, buf, sizeof(buf), 0);
+        if (r <= 0) return false;
+        rx.insert(rx.end(), buf, buf + r);
+    }
+    std::string head(rx.begin(), rx.begin() + head_end);
+    rx.erase(rx.begin(), rx.begin() + head_end + 4);
+    if (head.compare(0, 12, "HTTP/1.1 101") != 0 || head.find(ws_accept_key(key)) == std::string::npos) return false;
+
+    // Same capability offer as sendCapabilities(): preferred codec, then PCM
+    codec = AUDIO_CODEC_PCM16;
+    std::string caps = "{\"type\":\"caps\",\"rate\":16000,";
+    if (cfg.udp) caps += "\"frame\":1,\"udp\":1,";
+    caps += "\"codecs\":[";
+    if (cfg.codec != AUDIO_CODEC_PCM16) caps += json_quote(audio_codec_name(cfg.codec)) + ",";
+    caps += "\"pcm\"]}";
+    return sendText(caps);
+}
+
+bool VirtualClient::sendFrame(uint8_t opcode, const uint8_t *payload, size_t len) {
+    uint8_t mask[4];
+    uint32_t m = (uint32_t)rng();
+    memcpy(mask, &m, 4);
+    std::vector<uint8_t> frame(WS_MAX_HEADER_BYTES + len);
+    size_t hlen = ws_encode_header(frame.data(), opcode, len, mask);
+    if (len) memcpy(frame.data() + hlen, payload, len);
+    ws_apply_mask(frame.data() + hlen, len, mask);
+    return send_all(fd, frame.data(), hlen + len);
+}
+
+bool VirtualClient::sendAudio() {
+    const std::vector<EncodedFrame> &frames = audio_frames[codec];
+    const EncodedFrame &f = frames[audio_pos++ % frames.size()];
+
+    // [frame header (--udp)] + audio + trailer: magic, sender, flags, seq, send time
+    uint8_t buf[MEDIA_DGRAM_PREFIX_BYTES + AUDIO_FRAME_HEADER_BYTES + 4096 + TRAILER_BYTES];
+    uint8_t *frame = buf + MEDIA_DGRAM_PREFIX_BYTES;
+    size_t hdr = cfg.udp ? AUDIO_FRAME_HEADER_BYTES : 0;
+    size_t n = std::min(f.data.size(), (size_t)4096);
+    memcpy(frame + hdr, f.data.data(), n);
+    uint16_t sender = (uint16_t)index, flags = 0;
+    uint32_t s = seq++;
+    int64_t t = now_us();
+    if (cfg.udp) {
+        AudioFrameHeader h = {AUDIO_FRAME_VERSION, 0, (uint8_t)codec, 0, (uint16_t)s, (uint32_t)t};
+        audio_frame_write_header(h, frame);
+    }
+    uint8_t *trailer = frame + hdr + n;
+    memcpy(trailer, &TRAILER_MAGIC, 4);
+    memcpy(trailer + 4, &sender, 2);
+    memcpy(trailer + 6, &flags, 2);
+    memcpy(trailer + 8, &s, 4);
+    memcpy(trailer + 12, &t, 8);
+    size_t len = hdr + n + TRAILER_BYTES;
+
+    stats.frames_sent++;
+    stats.bytes_sent += len;
+    if (udp_ready) {
+        // Lost datagrams show up as loss at the receivers; only socket errors end the session
+        media_dgram_write_prefix(MEDIA_DGRAM_AUDIO, udp_token, buf);
+        return send(udp_fd, buf, MEDIA_DGRAM_PREFIX_BYTES + len, 0) >= 0 || errno == ENOBUFS ||
+               errno == EAGAIN || errno == ECONNREFUSED;
+    }
+    return sendFrame(WS_OP_BINARY, frame, len);
+}
+
+void VirtualClient::openMediaPath(uint16_t port, uint32_t token) {
+    closeMediaPath();
+    addrinfo hints = {}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(cfg.host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res) return;
+    udp_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (udp_fd >= 0 && connect(udp_fd, res->ai_addr, res->ai_addrlen) < 0) {
+        close(udp_fd);
+        udp_fd = -1;
+    }
+    freeaddrinfo(res);
+    udp_token = token;
+    next_hello = 0;
+}
+
+void VirtualClient::closeMediaPath() {
+    if (udp_fd >= 0) close(udp_fd);
+    if (udp_ready) stats.udp_up--;
+    udp_fd = -1;
+    udp_ready = false;
+}
+
+void VirtualClient::sendHello() {
+    uint8_t hello[MEDIA_DGRAM_PREFIX_BYTES];
+    media_dgram_write_prefix(MEDIA_DGRAM_HELLO, udp_token, hello);
+    send(udp_fd, hello, sizeof(hello), 0);
+    next_hello = now_us() + (udp_ready ? UDP_KEEPALIVE_US : UDP_HELLO_US);
+}
+
+void VirtualClient::readDatagrams() {
+    uint8_t buf[MEDIA_DGRAM_PREFIX_BYTES + 8192];
+    ssize_t r;
+    while ((r = recv(udp_fd, buf, sizeof(buf), 0)) > 0) {
+        uint8_t kind;
+        uint32_t token;
+        if (!media_dgram_parse_prefix(buf, (size_t)r, &kind, &token) || token != udp_token) continue;
+        if (kind == MEDIA_DGRAM_HELLO_ACK && !udp_ready) {
+            udp_ready = true;
+            stats.udp_up++;
+        } else if (kind == MEDIA_DGRAM_AUDIO || kind == MEDIA_DGRAM_AUDIO_RED) {
+            onBinary(buf + MEDIA_DGRAM_PREFIX_BYTES, (size_t)r - MEDIA_DGRAM_PREFIX_BYTES);
+        }
+    }
+}
+
+void VirtualClient::onBinary(const uint8_t *payload, size_t len) {
+    if (len < TRAILER_BYTES) return;
+    const uint8_t *t = payload + len - TRAILER_BYTES;
+    uint32_t magic, s;
+    uint16_t sender;
+    int64_t sent_us;
+    memcpy(&magic, t, 4);
+    if (magic != TRAILER_MAGIC) return; // not from a generator client
+    memcpy(&sender, t + 4, 2);
+    memcpy(&s, t + 8, 4);
+    memcpy(&sent_us, t + 12, 8);
+
+    stats.latency.record(now_us() - sent_us);
+    stats.frames_received++;
+
+    auto it = senders.find(sender);
+    if (it == senders.end()) {
+        senders[sender] = SenderTrack{s};
+        stats.frames_expected++;
+    } else if (s > it->second.last_seq) {
+        stats.frames_expected += s - it->second.last_seq;
+        it->second.last_seq = s;
+    }
+}
+
+bool VirtualClient::readFrames() {
+    uint8_t buf[16384];
+    ssize_t r = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (r == 0) return false;
+    if (r < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    rx.insert(rx.end(), buf, buf + r);
+
+    size_t pos = 0;
+    WsFrameHeader h;
+    while (ws_parse_header(rx.data() + pos, rx.size() - pos, h) && rx.size() - pos >= h.header_len + h.payload_len) {
+        uint8_t *payload = rx.data() + pos + h.header_len;
+        size_t len = (size_t)h.payload_len;
+        if (h.masked) ws_apply_mask(payload, len, h.mask);
+        pos += h.header_len + len;
+        if (h.opcode == WS_OP_BINARY) onBinary(payload, len);
+        else if (h.opcode == WS_OP_PING) sendFrame(WS_OP_PONG, payload, len);
+        else if (h.opcode == WS_OP_CLOSE) return false;
+        else if (h.opcode == WS_OP_TEXT) {
+            std::string text((const char *)payload, len);
+            if (json_get_string(text, "type") == "caps_ack") {
+                AudioCodecId id;
+                if (audio_codec_from_name(json_get_string(text, "codec", "pcm").c_str(), &id) &&
+                    !audio_frames[id].empty()) {
+                    codec = id;
+                }
+                uint16_t port = (uint16_t)json_get_number(text, "udp", 0);
+                if (cfg.udp && port) openMediaPath(port, (uint32_t)json_get_number(text, "token", 0));
+            }
+        }
+    }
+    rx.erase(rx.begin(), rx.begin() + pos);
+    return true;
+}
+
+/**
+ * @brief Run one session until it drops, is churned, or the run ends.
+ * @return true if the client ended it on purpose
+ */
+bool VirtualClient::session() {
+    int64_t now = now_us();
+    int64_t next_ping = now + KEEPALIVE_US;
+    bool talking = false;
+    int64_t next_send = 0;
+    // Talkers start at a random point of their idle period so bursts do not line up
+    int64_t next_toggle = now + (int64_t)(std::uniform_real_distribution<double>(0.0, 1.0)(rng) * cfg.idle_ms * 1000);
+    int64_t drop_at = INT64_MAX;
+    if (cfg.churn_s > 0) drop_at = now + (int64_t)(std::exponential_distribution<double>(1.0 / cfg.churn_s)(rng) * 1e6);
+
+    bool planned = false;
+    while (!stop_requested) {
+        now = now_us();
+        int64_t deadline = std::min({next_ping, drop_at, now + 200000});
+        if (talker) deadline = std::min(deadline, next_toggle);
+        if (talking) deadline = std::min(deadline, next_send);
+
+        if (udp_fd >= 0) deadline = std::min(deadline, next_hello);
+
+        pollfd pfd[2] = {{fd, POLLIN, 0}, {udp_fd, POLLIN, 0}};
+        int wait_ms = deadline > now ? (int)((deadline - now + 999) / 1000) : 0;
+        if (poll(pfd, udp_fd >= 0 ? 2 : 1, wait_ms) > 0) {
+            if ((pfd[0].revents & (POLLIN | POLLHUP | POLLERR)) && !readFrames()) break;
+            if (udp_fd >= 0 && (pfd[1].revents & POLLIN)) readDatagrams();
+        }
+
+        now = now_us();
+        if (udp_fd >= 0 && now >= next_hello) sendHello();
+        if (talking && now >= next_send) {
+            const std::vector<EncodedFrame> &frames = audio_frames[codec];
+            int64_t frame_us = (int64_t)frames[audio_pos % frames.size()].samples * 1000000 / SAMPLE_RATE;
+            if (now - next_send > MAX_TX_LAG_FRAMES * frame_us) {
+                stats.tx_late++;
+                next_send = now;
+            }
+            if (!sendAudio()) break;
+            next_send += frame_us;
+        }
+        if (talker && now >= next_toggle) {
+            talking = !talking;
+            if (talking) {
+                std::string start = "{\"type\":\"talk_start\",\"codec\":\"" + std::string(audio_codec_name(codec)) + "\"";
+                if (!sendText(start + (cfg.udp ? ",\"frame\":1}" : "}"))) break;
+                stats.talking++;
+                next_send = now;
+                next_toggle = now + (int64_t)(jitter(cfg.talk_ms) * 1000);
+            } else {
+                stats.talking--;
+                if (!sendText("{\"type\":\"talk_stop\"}")) break;
+                next_toggle = now + (int64_t)(jitter(cfg.idle_ms) * 1000);
+            }
+        }
+        if (now >= next_ping) {
+            if (!sendText("{\"type\":\"ping\"}")) break;
+            next_ping = now + KEEPALIVE_US;
+        }
+        if (now >= drop_at) {
+            planned = true;
+            break;
+        }
+    }
+    if (talking) stats.talking--;
+    return planned || stop_requested;
+}
+
+void VirtualClient::run() {
+    bool first = true;
+    int64_t lost_at = 0;
+    while (!stop_requested) {
+        int64_t t0 = now_us();
+        bool ok = (first || login()) && openSession();
+        if (!ok) {
+            stats.connect_failures++;
+            if (fd >= 0) close(fd);
+            fd = -1;
+            if (lost_at == 0) lost_at = t0;
+            for (uint32_t waited = 0; waited < cfg.reconnect_ms && !stop_requested; waited += 50) usleep(50000);
+            first = false;
+            continue;
+        }
+        int64_t up = now_us();
+        stats.connect.record(up - t0);
+        if (lost_at) {
+            stats.reconnect.record(up - lost_at);
+            stats.reconnects++;
+        }
+        first = false;
+
+        stats.sessions_up++;
+        bool planned = session();
+        stats.sessions_up--;
+        close(fd);
+        fd = -1;
+        closeMediaPath();
+        senders.clear();
+        if (stop_requested) break;
+
+        lost_at = now_us();
+        if (planned) {
+            stats.churn_drops++;
+        } else {
+            stats.unplanned_drops++;
+            for (uint32_t waited = 0; waited < cfg.reconnect_ms && !stop_requested; waited += 50) usleep(50000);
+        }
+    }
+}
+
+// =================================================================
+// --- Reporting ---
+// =================================================================
+struct ReportState {
+    int64_t t_us;
+    uint64_t sent, received, expected;
+    std::vector<uint64_t> latency;
+};
+
+static void print_report(const char *tag, const ReportState &prev, ReportState &cur) {
+    cur.t_us = now_us();
+    cur.sent = stats.frames_sent;
+    cur.received = stats.frames_received;
+    cur.expected = stats.frames_expected;
+    cur.latency = stats.latency.snapshot();
+
+    double dt = (cur.t_us - prev.t_us) / 1e6;
+    std::vector<uint64_t> delta(cur.latency.size());
+    for (size_t i = 0; i < delta.size(); i++) delta[i] = cur.latency[i] - (prev.latency.empty() ? 0 : prev.latency[i]);
+    uint64_t expected = cur.expected - prev.expected;
+    uint64_t received = cur.received - prev.received;
+    double loss = expected ? 100.0 * (double)(expected > received ? expected - received : 0) / expected : 0.0;
+
+    printf("[LOAD]%s up=%u udp=%u talking=%u tx=%.0f/s rx=%.0f/s loss=%.2f%% lat p50=%.1fms p95=%.1fms p99=%.1fms "
+           "drops=%llu reconnects=%llu late=%llu\n",
+           tag, stats.sessions_up.load(), stats.udp_up.load(), stats.talking.load(), (cur.sent - prev.sent) / dt, received / dt, loss,
+           LatencyHistogram::bucketPercentileMs(delta, 50), LatencyHistogram::bucketPercentileMs(delta, 95),
+           LatencyHistogram::bucketPercentileMs(delta, 99),
+           (unsigned long long)(stats.unplanned_drops + stats.churn_drops),
+           (unsigned long long)stats.reconnects.load(), (unsigned long long)stats.tx_late.load());
+    fflush(stdout);
+}
+
+static void print_summary(double seconds) {
+    std::vector<uint64_t> lat = stats.latency.snapshot();
+    std::vector<uint64_t> con = stats.connect.snapshot();
+    std::vector<uint64_t> rec = stats.reconnect.snapshot();
+    uint64_t expected = stats.frames_expected, received = stats.frames_received;
+
+    printf("\n=== %u clients, %u talkers, %s%s, %.0f s ===\n", cfg.clients, cfg.talkers, audio_codec_name(cfg.codec),
+           cfg.udp ? " over UDP" : "", seconds);
+    printf("frames  sent %llu (%.1f kbit/s total)  received %llu  loss %.3f%%  tx late %llu\n",
+           (unsigned long long)stats.frames_sent.load(), stats.bytes_sent * 8.0 / 1000.0 / seconds,
+           (unsigned long long)received,
+           expected ? 100.0 * (double)(expected > received ? expected - received : 0) / expected : 0.0,
+           (unsigned long long)stats.tx_late.load());
+    printf("latency p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f ms\n", stats.latency.percentileMs(lat, 50),
+           stats.latency.percentileMs(lat, 90), stats.latency.percentileMs(lat, 99),
+           stats.latency.percentileMs(lat, 99.9), stats.latency.max() / 1000.0);
+    printf("connect p50 %.1f  p99 %.1f  max %.1f ms (%llu sessions, %llu failures)\n",
+           stats.connect.percentileMs(con, 50), stats.connect.percentileMs(con, 99),
+           stats.connect.max() / 1000.0, (unsigned long long)LatencyHistogram::total(con),
+           (unsigned long long)stats.connect_failures.load());
+    printf("reconnect p50 %.1f  p99 %.1f  max %.1f ms (%llu: %llu dropped by server, %llu churned)\n",
+           stats.reconnect.percentileMs(rec, 50), stats.reconnect.percentileMs(rec, 99),
+           stats.reconnect.max() / 1000.0, (unsigned long long)stats.reconnects.load(),
+           (unsigned long long)stats.unplanned_drops.load(), (unsigned long long)stats.churn_drops.load());
+}
+
+// =================================================================
+// --- Main ---
+// =================================================================
+static void on_signal(int) {
+    stop_requested = true;
+}
+
+static bool prepare_audio() {
+    std::vector<int16_t> pcm;
+    uint32_t rate = SAMPLE_RATE;
+    if (cfg.wav) {
+        if (!wav_read_mono16(cfg.wav, pcm, rate) || rate != SAMPLE_RATE) {
+            fprintf(stderr, "Need a 16 kHz 16-bit WAV: %s\n", cfg.wav);
+            return false;
+        }
+    } else {
+        pcm = test_signal_voice(SAMPLE_RATE, 6.0f);
+    }
+    pcm.resize(pcm.size() / BLOCK_SAMPLES * BLOCK_SAMPLES);
+    if (pcm.empty()) return false;
+
+    // Encode once per codec; talkers only copy packets
+    for (uint8_t i = 0; i < AUDIO_CODEC_COUNT; i++) {
+        AudioCodecId id = (AudioCodecId)i;
+        if (id != AUDIO_CODEC_PCM16 && id != cfg.codec) continue;
+        AudioEncoder *enc = audio_encoder_create(id, SAMPLE_RATE, OPUS_BITRATE);
+        if (!enc) continue;
+        uint8_t out[4096];
+        uint32_t pending = 0;
+        for (size_t off = 0; off < pcm.size(); off += BLOCK_SAMPLES) {
+            pending += BLOCK_SAMPLES;
+            int n = enc->encode(&pcm[off], BLOCK_SAMPLES, out, sizeof(out));
+            if (n > 0) {
+                audio_frames[id].push_back(EncodedFrame{std::vector<uint8_t>(out, out + n), pending});
+                pending = 0;
+            }
+        }
+        delete enc;
+    }
+    if (audio_frames[cfg.codec].empty()) {
+        fprintf(stderr, "Codec %s is not available in this build\n", audio_codec_name(cfg.codec));
+        return false;
+    }
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Usage: ptt_loadgen [--host 127.0.0.1] [--port 8000] [--clients 50] [--talkers 1]\n"
+            "                   [--talk-ms 4000] [--idle-ms 4000] [--codec pcm|adpcm|opus]\n"
+            "                   [--wav speech.wav] [--duration 60] [--ramp-ms 10]\n"
+            "                   [--churn-s 0] [--reconnect-ms 5000] [--report-s 5] [--user-prefix lg]\n"
+            "                   [--udp]\n");
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--udp") {
+            cfg.udp = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        const char *val = argv[++i];
+        if (arg == "--host") cfg.host = val;
+        else if (arg == "--port") cfg.port = (uint16_t)atoi(val);
+        else if (arg == "--clients") cfg.clients = (uint32_t)atoi(val);
+        else if (arg == "--talkers") cfg.talkers = (uint32_t)atoi(val);
+        else if (arg == "--talk-ms") cfg.talk_ms = (uint32_t)atoi(val);
+        else if (arg == "--idle-ms") cfg.idle_ms = (uint32_t)atoi(val);
+        else if (arg == "--wav") cfg.wav = val;
+        else if (arg == "--duration") cfg.duration_s = (uint32_t)atoi(val);
+        else if (arg == "--ramp-ms") cfg.ramp_ms = (uint32_t)atoi(val);
+        else if (arg == "--churn-s") cfg.churn_s = atof(val);
+        else if (arg == "--reconnect-ms") cfg.reconnect_ms = (uint32_t)atoi(val);
+        else if (arg == "--report-s") cfg.report_s = (uint32_t)atoi(val);
+        else if (arg == "--user-prefix") cfg.user_prefix = val;
+        else if (arg == "--codec") {
+            if (!audio_codec_from_name(val, &cfg.codec)) {
+                fprintf(stderr, "Unknown codec: %s\n", val);
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (cfg.talkers > cfg.clients) cfg.talkers = cfg.clients;
+    if (!prepare_audio()) return 1;
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    // Talkers are spread evenly, so with the relay's --group-size each group gets its share
+    std::vector<std::unique_ptr<VirtualClient>> clients;
+    std::vector<std::thread> threads;
+    uint32_t stride = cfg.talkers ? cfg.clients / cfg.talkers : 0;
+    int64_t start = now_us();
+
+    // Log in sequentially (registration order is the relay's group order), start each session right away
+    for (uint32_t i = 0; i < cfg.clients && !stop_requested; i++) {
+        bool talker = stride && i % stride == 0 && i / stride < cfg.talkers;
+        clients.emplace_back(new VirtualClient(i, talker));
+        VirtualClient *c = clients.back().get();
+        if (!c->login()) {
+            fprintf(stderr, "Client %u: login failed (is the relay running on %s:%u?)\n", i, cfg.host.c_str(),
+                    cfg.port);
+            stop_requested = true;
+            break;
+        }
+        threads.emplace_back([c] { c->run(); });
+        if (cfg.ramp_ms) usleep(cfg.ramp_ms * 1000);
+    }
+
+    ReportState prev = {now_us(), 0, 0, 0, {}};
+    int64_t end = start + (int64_t)cfg.duration_s * 1000000;
+    while (!stop_requested && now_us() < end) {
+        usleep(100000);
+        if (cfg.report_s && now_us() - prev.t_us >= (int64_t)cfg.report_s * 1000000) {
+            ReportState cur;
+            print_report("", prev, cur);
+            prev = cur;
+        }
+    }
+    stop_requested = true;
+    for (std::thread &t : threads) t.join();
+
+    print_summary((now_us() - start) / 1e6);
+    return 0;
+}
@@ -0,0 +1,1267 @@
+/*
+ * Local reference relay for the PTT client protocol (Linux, epoll).
+ *
+ * Usage: ptt_relay [--port 8000] [--group-size N] [--codecs opus,adpcm,pcm]
+ *                  [--queue-kb 256] [--idle-s 60] [--stats-s 10] [--echo]
+ *                  [--udp-port 0] [--udp-loss PCT]
+ *
+ * Implements what the firmware speaks:
+ *   POST /register    {"username","password","friendlyName"} -> 201
+ *   POST /token       username=..&password=.. -> {"access_token"} (401 if unknown)
+ *   GET  /devices/me  Authorization: Bearer <token> -> {"deviceId"}
+ *   GET  /ws/<deviceId>?token=<token>  WebSocket session
+ *   GET  /metrics     Prometheus text format
+ *
+ * Session messages: "caps" -> "caps_ack" (first offered codec in --codecs),
+ * "talk_start"/"talk_stop" forwarded to the group with the talker's codec,
+ * "lat_report"/"loss_report" (answers to the talker) forwarded to the group, "ping" ->
+ * "pong". Binary frames are relayed verbatim to every other session of the
+ * sender's group (--group-size N splits devices into groups of N in
+ * registration order; 0 = one group). Clients that offer "frame":1 in caps
+ * get the 8-byte audio frame header (src/audio/audio_frame.h) as sent; the
+ * relay strips it for peers that did not negotiate it. Likewise "red":1
+ * bursts (redundant copies, src/audio/redundancy.h) reach peers without
+ * "red" in caps as the primary payload only. Comfort noise descriptors of
+ * "dtx":1 talkers (src/audio/comfort_noise.h) only reach peers that offered
+ * "dtx" themselves. Clients that offer "mix":1 (with "frame":1) play several
+ * talkers at once: every member of a group gets a source id (1..255), sent
+ * to them as "src" in talk_start/talk_stop and as one byte in front of each
+ * relayed frame (src/audio/audio_frame.h, AUDIO_FRAME_SOURCE_BYTES).
+ *
+ * With --udp-port, clients that offer "udp":1 get a media port and token in
+ * caps_ack; once their HELLO datagram arrives, their audio is exchanged as
+ * datagrams (src/audio/media_datagram.h) while control stays on the
+ * WebSocket. --udp-loss drops that share of outgoing datagrams, for loss
+ * tests without netem.
+ *
+ * Fan-out is zero-copy: each incoming frame is encoded once into a shared,
+ * reference-counted buffer and every recipient's send queue points into it.
+ * A recipient whose queue exceeds --queue-kb drops frames instead of
+ * stalling the others. Single-threaded: one epoll loop serves everything.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/json_lite.h"
+#include "../common/ws_protocol.h"
+
+static const size_t READ_CHUNK_BYTES = 16384;
+static const size_t MAX_HTTP_BYTES = 64 * 1024;    // request head + body
+static const size_t MAX_MESSAGE_BYTES = 64 * 1024; // WebSocket message
+static const int MAX_IOV = 64;
+static const int MAX_EVENTS = 256;
+static const int AUDIO_FRAME_VERSION = 1;       // matches src/audio/audio_frame.h
+static const size_t AUDIO_FRAME_HEADER_BYTES = 8;
+static const uint8_t AUDIO_FRAME_CODEC_CN = 15; // comfort noise descriptor (codec bits of header byte 0)
+static const size_t AUDIO_FRAME_SOURCE_BYTES = 1; // talker's source id in front of frames to "mix" peers
+static const size_t AUDIO_RED_BLOCK_HEADER_BYTES = 4; // matches src/audio/redundancy.h
+// Media datagrams, matching src/audio/media_datagram.h
+static const size_t MEDIA_DGRAM_PREFIX_BYTES = 5;
+static const uint8_t MEDIA_DGRAM_HELLO = 1;
+static const uint8_t MEDIA_DGRAM_HELLO_ACK = 2;
+static const uint8_t MEDIA_DGRAM_AUDIO = 3;
+static const uint8_t MEDIA_DGRAM_AUDIO_RED = 4;
+static const size_t MAX_DATAGRAM_BYTES = 2048;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+// Locate the primary inside a redundant payload (count byte, block headers, primary, copies)
+static bool red_primary(const uint8_t *payload, size_t len, size_t *offset, size_t *primary_len) {
+    if (len < 1) return false;
+    size_t prefix = 1 + (size_t)payload[0] * AUDIO_RED_BLOCK_HEADER_BYTES;
+    if (len < prefix) return false;
+    size_t copies = 0;
+    for (uint8_t i = 0; i < payload[0]; i++) {
+        const uint8_t *h = payload + 1 + (size_t)i * AUDIO_RED_BLOCK_HEADER_BYTES;
+        copies += (size_t)(h[2] | (h[3] << 8));
+    }
+    if (len < prefix + copies) return false;
+    *offset = prefix;
+    *primary_len = len - prefix - copies;
+    return true;
+}
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// =================================================================
+// --- Configuration and metrics ---
+// =================================================================
+struct RelayConfig {
+    uint16_t port = 8000;
+    uint32_t group_size = 0;
+    std::vector<std::string> codecs = {"opus", "adpcm", "pcm"};
+    size_t queue_limit = 256 * 1024;
+    uint32_t idle_s = 60;
+    uint32_t stats_s = 10;
+    bool echo = false;
+    uint16_t udp_port = 0;    // media datagrams (0 = WebSocket only)
+    double udp_loss_pct = 0.0; // outgoing datagrams dropped on purpose
+};
+
+// Relay latency: frame read from the talker -> last byte handed to the recipient's socket
+static const uint32_t LATENCY_BOUNDS_US[] = {50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+static const size_t LATENCY_BUCKETS = sizeof(LATENCY_BOUNDS_US) / sizeof(LATENCY_BOUNDS_US[0]);
+
+struct Metrics {
+    uint64_t http_requests = 0;
+    uint64_t ws_accepted = 0;
+    uint64_t ws_rejected = 0;
+    uint64_t sessions_replaced = 0;
+    uint64_t idle_timeouts = 0;
+    uint64_t control_messages = 0;
+    uint64_t frames_in = 0;
+    uint64_t bytes_in = 0;          // audio payload bytes received
+    uint64_t frame_buffers = 0;     // shared buffers allocated for fan-out
+    uint64_t deliveries = 0;        // frame references queued to recipients
+    uint64_t frames_dropped = 0;    // recipient queue full
+    uint64_t bytes_out = 0;         // all bytes written to sockets
+    uint64_t writev_calls = 0;
+    uint64_t datagrams_in = 0;
+    uint64_t datagrams_out = 0;
+    uint64_t datagrams_impaired = 0; // dropped by --udp-loss
+    size_t queue_bytes_max = 0;
+    int64_t loop_busy_us = 0;
+    uint64_t latency_counts[LATENCY_BUCKETS + 1] = {};
+    uint64_t latency_sum_us = 0;
+    uint64_t latency_samples = 0;
+
+    void recordLatency(int64_t us) {
+        size_t i = 0;
+        while (i < LATENCY_BUCKETS && us > (int64_t)LATENCY_BOUNDS_US[i]) i++;
+        latency_counts[i]++;
+        latency_sum_us += (uint64_t)us;
+        latency_samples++;
+    }
+};
+
+// =================================================================
+// --- Connections ---
+// =================================================================
+
+/**
+ * @brief Bytes queued for sending, shared by every connection that sends them.
+ */
+struct SharedBuffer {
+    std::vector<uint8_t> bytes;
+    int64_t recv_us; // audio frames: when the source frame was read (0 = not timed)
+};
+typedef std::shared_ptr<const SharedBuffer> BufferRef;
+
+struct OutChunk {
+    BufferRef buf;
+    size_t offset;
+};
+
+struct User {
+    std::string password;
+    std::string friendly_name;
+    std::string device_id;
+    uint32_t group;
+};
+
+struct Conn {
+    int fd = -1;
+    bool websocket = false;
+    bool closing = false;           // queued for close at the end of the loop iteration
+    bool close_after_flush = false;
+    bool epollout = false;
+    bool dirty = false;             // in the flush list
+
+    std::vector<uint8_t> in;
+    size_t in_pos = 0;
+    std::deque<OutChunk> out;
+    size_t out_bytes = 0;
+
+    // WebSocket session
+    std::string device_id;
+    std::string username;
+    uint32_t group = 0;
+    std::string talk_codec;
+    uint8_t frame_version = 0;      // frame header version agreed in caps_ack (0 = bare payloads)
+    uint8_t talk_frame = 0;         // header version of the current burst, from talk_start
+    bool red_ok = false;            // accepts redundant payloads (caps "red":1, needs frame headers)
+    bool talk_red = false;          // current burst carries redundant copies
+    bool dtx_ok = false;            // accepts comfort noise descriptors (caps "dtx":1, needs frame headers)
+    bool mix_ok = false;            // frames and talk messages carry source ids (caps "mix":1, needs frame headers)
+    uint8_t source_id = 0;          // unique in the group while connected (0: all 255 taken)
+    uint32_t udp_token = 0;         // media datagram session token (0 = no UDP path)
+    bool udp_ready = false;         // HELLO received: audio to this session goes as datagrams
+    sockaddr_in udp_addr = {};
+    bool talking = false;
+    std::vector<uint8_t> message;
+    uint8_t message_opcode = 0;
+    int64_t last_rx_us = 0;
+    uint64_t dropped = 0;
+};
+
+struct HttpRequest {
+    std::string method;
+    std::string target;
+    std::string version;
+    std::unordered_map<std::string, std::string> headers; // lower-case names
+    std::string body;
+};
+
+class Relay {
+public:
+    explicit Relay(const RelayConfig &cfg) : cfg(cfg), rng(std::random_device{}()) {}
+
+    bool listenOn(uint16_t port);
+    bool openMediaPort(uint16_t port);
+    void run();
+    void printStats(bool final_line);
+
+private:
+    RelayConfig cfg;
+    Metrics metrics;
+    std::mt19937_64 rng;
+    int epfd = -1;
+    int listen_fd = -1;
+    int udp_fd = -1;
+
+    std::unordered_map<std::string, User> users;          // by username
+    std::unordered_map<std::string, std::string> tokens;  // token -> username
+    std::unordered_map<std::string, Conn *> sessions;     // device id -> session
+    std::unordered_map<uint32_t, std::vector<Conn *>> groups;
+    std::unordered_map<uint32_t, Conn *> udp_sessions;   // media token -> session
+    size_t connection_count = 0;
+    std::vector<Conn *> dirty;
+    std::vector<Conn *> to_close;
+
+    // Rate bookkeeping for the periodic stats line
+    int64_t last_stats_us = 0;
+    uint64_t last_frames_in = 0;
+    uint64_t last_deliveries = 0;
+    uint64_t last_dropped = 0;
+    int64_t last_busy_us = 0;
+
+    std::string randomHex(size_t bytes);
+    void acceptAll();
+    void onReadable(Conn *c);
+    void processHttp(Conn *c);
+    void handleHttp(Conn *c, HttpRequest &req);
+    void handleUpgrade(Conn *c, HttpRequest &req, const std::string &device_id, const std::string &token);
+    void processWebSocket(Conn *c);
+    void handleMessage(Conn *c, uint8_t opcode, uint8_t *payload, size_t len);
+    void handleControl(Conn *c, const std::string &text);
+    void relayAudio(Conn *sender, const uint8_t *payload, size_t len);
+    void receiveDatagrams();
+    void sendDatagram(Conn *peer, uint8_t kind, const uint8_t *a, size_t a_len, const uint8_t *b = nullptr,
+                      size_t b_len = 0, const uint8_t *source = nullptr, int64_t recv_us = 0);
+    BufferRef makeFrame(uint8_t opcode, const uint8_t *payload, size_t len, int64_t recv_us);
+    void broadcastText(Conn *sender, const std::string &text, const std::string *framed_text = nullptr,
+                       const std::string *red_text = nullptr);
+    std::string metricsText();
+
+    void sendHttp(Conn *c, int status, const char *content_type, const std::string &body, bool keep_alive);
+    void sendFrame(Conn *c, uint8_t opcode, const uint8_t *payload, size_t len);
+    void enqueue(Conn *c, const BufferRef &buf);
+    void flush(Conn *c);
+    void setEpollOut(Conn *c, bool on);
+    void requestClose(Conn *c);
+    void destroy(Conn *c);
+    void sweepIdle(int64_t now);
+    void drain();
+};
+
+std::string Relay::randomHex(size_t bytes) {
+    static const char *hex = "0123456789abcdef";
+    std::string s;
+    for (size_t i = 0; i < bytes; i++) {
+        uint8_t b = (uint8_t)rng();
+        s += hex[b >> 4];
+        s += hex[b & 15];
+    }
+    return s;
+}
+
+bool Relay::listenOn(uint16_t port) {
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) return false;
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 1024) < 0) {
+        perror("bind/listen");
+        return false;
+    }
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr; // nullptr = listening socket
+    return epfd >= 0 && epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev) == 0;
+}
+
+bool Relay::openMediaPort(uint16_t port) {
+    udp_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (udp_fd < 0) return false;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(udp_fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind udp");
+        return false;
+    }
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &udp_fd; // tags the media socket
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, udp_fd, &ev) == 0;
+}
+
+void Relay::run() {
+    epoll_event events[MAX_EVENTS];
+    last_stats_us = now_us();
+    int64_t last_sweep_us = last_stats_us;
+
+    while (!stop_requested) {
+        int n = epoll_wait(epfd, events, MAX_EVENTS, 1000);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+        int64_t t0 = now_us();
+
+        for (int i = 0; i < n; i++) {
+            Conn *c = (Conn *)events[i].data.ptr;
+            if (!c) {
+                acceptAll();
+                continue;
+            }
+            if (events[i].data.ptr == &udp_fd) {
+                receiveDatagrams();
+                continue;
+            }
+            if (c->closing) continue;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) onReadable(c);
+            if (!c->closing && (events[i].events & EPOLLOUT) && !c->dirty) {
+                c->dirty = true;
+                dirty.push_back(c);
+            }
+        }
+
+        if (t0 - last_sweep_us >= 1000000) {
+            last_sweep_us = t0;
+            sweepIdle(t0);
+        }
+        drain();
+
+        int64_t t1 = now_us();
+        metrics.loop_busy_us += t1 - t0;
+        if (cfg.stats_s && t1 - last_stats_us >= (int64_t)cfg.stats_s * 1000000) printStats(false);
+    }
+}
+
+void Relay::acceptAll() {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("accept4");
+            return;
+        }
+        // Audio frames are small and latency-bound
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        Conn *c = new Conn();
+        c->fd = fd;
+        c->last_rx_us = now_us();
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            delete c;
+            continue;
+        }
+        connection_count++;
+    }
+}
+
+void Relay::onReadable(Conn *c) {
+    while (true) {
+        size_t used = c->in.size();
+        c->in.resize(used + READ_CHUNK_BYTES);
+        ssize_t r = read(c->fd, c->in.data() + used, READ_CHUNK_BYTES);
+        c->in.resize(used + (r > 0 ? (size_t)r : 0));
+        if (r > 0) {
+            c->last_rx_us = now_us();
+            if ((size_t)r < READ_CHUNK_BYTES) break;
+            continue;
+        }
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (r < 0 && errno == EINTR) continue;
+        requestClose(c); // EOF or error
+        return;
+    }
+
+    if (!c->websocket) processHttp(c);
+    if (c->websocket && !c->closing) processWebSocket(c);
+
+    // Compact consumed input
+    if (c->in_pos > 0) {
+        c->in.erase(c->in.begin(), c->in.begin() + c->in_pos);
+        c->in_pos = 0;
+    }
+}
+
+// =================================================================
+// --- HTTP ---
+// =================================================================
+static std::string url_decode(const std::string &s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < s.size()) {
+            out += (char)strtol(s.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+// Value of @p key in "a=1&b=2" (form bodies and query strings)
+static std::string form_value(const std::string &form, const char *key) {
+    size_t klen = strlen(key);
+    size_t p = 0;
+    while (p <= form.size()) {
+        size_t amp = form.find('&', p);
+        if (amp == std::string::npos) amp = form.size();
+        if (amp - p > klen && form.compare(p, klen, key) == 0 && form[p + klen] == '=') {
+            return url_decode(form.substr(p + klen + 1, amp - p - klen - 1));
+        }
+        p = amp + 1;
+    }
+    return "";
+}
+
+void Relay::processHttp(Conn *c) {
+    while (!c->websocket && !c->closing && !c->close_after_flush) {
+        const char *base = (const char *)c->in.data() + c->in_pos;
+        size_t avail = c->in.size() - c->in_pos;
+        std::string head_view(base, avail);
+        size_t head_end = head_view.find("\r\n\r\n");
+        if (head_end == std::string::npos) {
+            if (avail > MAX_HTTP_BYTES) requestClose(c);
+            return;
+        }
+
+        HttpRequest req;
+        size_t line_end = head_view.find("\r\n");
+        std::string line = head_view.substr(0, line_end);
+        size_t sp1 = line.find(' ');
+        size_t sp2 = line.find(' ', sp1 == std::string::npos ? 0 : sp1 + 1);
+        if (sp1 == std::string::npos || sp2 == std::string::npos) {
+            sendHttp(c, 400, "text/plain", "bad request\n", false);
+            return;
+        }
+        req.method = line.substr(0, sp1);
+        req.target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+        req.version = line.substr(sp2 + 1);
+
+        size_t p = line_end + 2;
+        while (p < head_end) {
+            size_t e = head_view.find("\r\n", p);
+            std::string h = head_view.substr(p, e - p);
+            size_t colon = h.find(':');
+            if (colon != std::string::npos) {
+                std::string name = h.substr(0, colon);
+                for (char &ch : name) ch = (char)tolower((unsigned char)ch);
+                size_t v = colon + 1;
+                while (v < h.size() && h[v] == ' ') v++;
+                req.headers[name] = h.substr(v);
+            }
+            p = e + 2;
+        }
+
+        size_t body_len = 0;
+        auto cl = req.headers.find("content-length");
+        if (cl != req.headers.end()) body_len = strtoul(cl->second.c_str(), nullptr, 10);
+        if (body_len > MAX_HTTP_BYTES) {
+            sendHttp(c, 413, "text/plain", "too large\n", false);
+            return;
+        }
+        if (avail < head_end + 4 + body_len) return; // body not complete yet
+        req.body.assign(base + head_end + 4, body_len);
+        c->in_pos += head_end + 4 + body_len;
+
+        metrics.http_requests++;
+        handleHttp(c, req);
+    }
+}
+
+void Relay::handleHttp(Conn *c, HttpRequest &req) {
+    std::string conn_hdr = req.headers["connection"];
+    for (char &ch : conn_hdr) ch = (char)tolower((unsigned char)ch);
+    bool keep_alive = req.version == "HTTP/1.1" && conn_hdr.find("close") == std::string::npos;
+
+    std::string path = req.target;
+    std::string query;
+    size_t q = path.find('?');
+    if (q != std::string::npos) {
+        query = path.substr(q + 1);
+        path = path.substr(0, q);
+    }
+
+    if (req.method == "POST" && path == "/register") {
+        std::string username = json_get_string(req.body, "username");
+        std::string password = json_get_string(req.body, "password");
+        if (username.empty() || password.empty()) {
+            sendHttp(c, 400, "application/json", "{\"detail\":\"username and password required\"}", keep_alive);
+            return;
+        }
+        if (users.count(username)) {
+            sendHttp(c, 400, "application/json", "{\"detail\":\"Username already registered\"}", keep_alive);
+            return;
+        }
+        User u;
+        u.password = password;
+        u.friendly_name = json_get_string(req.body, "friendlyName", username.c_str());
+        u.device_id = randomHex(8);
+        u.group = cfg.group_size ? (uint32_t)(users.size() / cfg.group_size) : 0;
+        users[username] = u;
+        sendHttp(c, 201, "application/json",
+                 "{\"username\":" + json_quote(username) + ",\"deviceId\":" + json_quote(u.device_id) + "}",
+                 keep_alive);
+        return;
+    }
+
+    if (req.method == "POST" && path == "/token") {
+        std::string username = form_value(req.body, "username");
+        auto it = users.find(username);
+        if (it == users.end() || it->second.password != form_value(req.body, "password")) {
+            sendHttp(c, 401, "application/json", "{\"detail\":\"Incorrect username or password\"}", keep_alive);
+            return;
+        }
+        std::string token = randomHex(16);
+        tokens[token] = username;
+        sendHttp(c, 200, "application/json",
+                 "{\"access_token\":" + json_quote(token) + ",\"token_type\":\"bearer\"}", keep_alive);
+        return;
+    }
+
+    if (req.method == "GET" && path == "/devices/me") {
+        std::string auth = req.headers["authorization"];
+        auto t = auth.compare(0, 7, "Bearer ") == 0 ? tokens.find(auth.substr(7)) : tokens.end();
+        if (t == tokens.end()) {
+            sendHttp(c, 401, "application/json", "{\"detail\":\"Not authenticated\"}", keep_alive);
+            return;
+        }
+        const User &u = users[t->second];
+        sendHttp(c, 200, "application/json",
+                 "{\"deviceId\":" + json_quote(u.device_id) + ",\"friendlyName\":" + json_quote(u.friendly_name) +
+                     ",\"group\":" + std::to_string(u.group) + "}",
+                 keep_alive);
+        return;
+    }
+
+    if (req.method == "GET" && path == "/metrics") {
+        sendHttp(c, 200, "text/plain; version=0.0.4", metricsText(), keep_alive);
+        return;
+    }
+
+    if (req.method == "GET" && path.compare(0, 4, "/ws/") == 0) {
+        handleUpgrade(c, req, path.substr(4), form_value(query, "token"));
+        return;
+    }
+
+    sendHttp(c, 404, "application/json", "{\"detail\":\"Not Found\"}", keep_alive);
+}
+
+void Relay::handleUpgrade(Conn *c, HttpRequest &req, const std::string &device_id, const std::string &token) {
+    std::string upgrade = req.headers["upgrade"];
+    for (char &ch : upgrade) ch = (char)tolower((unsigned char)ch);
+    const std::string &key = req.headers["sec-websocket-key"];
+    if (upgrade != "websocket" || key.empty()) {
+        metrics.ws_rejected++;
+        sendHttp(c, 400, "text/plain", "websocket upgrade required\n", false);
+        return;
+    }
+
+    auto t = tokens.find(token);
+    if (t == tokens.end() || users[t->second].device_id != device_id) {
+        metrics.ws_rejected++;
+        sendHttp(c, 403, "text/plain", "forbidden\n", false);
+        return;
+    }
+
+    std::string resp = "HTTP/1.1 101 Switching Protocols\r\n"
+                       "Upgrade: websocket\r\n"
+                       "Connection: Upgrade\r\n"
+                       "Sec-WebSocket-Accept: " + ws_accept_key(key) + "\r\n";
+    auto proto = req.headers.find("sec-websocket-protocol");
+    if (proto != req.headers.end()) {
+        // Echo the first offered subprotocol (the Arduino client sends "arduino")
+        resp += "Sec-WebSocket-Protocol: " + proto->second.substr(0, proto->second.find(',')) + "\r\n";
+    }
+    resp += "\r\n";
+    auto buf = std::make_shared<SharedBuffer>();
+    buf->bytes.assign(resp.begin(), resp.end());
+    buf->recv_us = 0;
+    enqueue(c, buf);
+
+    // A reconnecting device replaces its stale session
+    auto old = sessions.find(device_id);
+    if (old != sessions.end() && old->second != c) {
+        metrics.sessions_replaced++;
+        requestClose(old->second);
+    }
+
+    const User &u = users[t->second];
+    c->websocket = true;
+    c->device_id = device_id;
+    c->username = t->second;
+    c->group = u.group;
+    sessions[device_id] = c;
+    // Lowest source id no other member holds
+    std::vector<Conn *> &g = groups[c->group];
+    std::vector<bool> taken(256, false);
+    for (Conn *m : g) taken[m->source_id] = true;
+    for (int id = 1; id < 256 && !c->source_id; id++) {
+        if (!taken[id]) c->source_id = (uint8_t)id;
+    }
+    g.push_back(c);
+    metrics.ws_accepted++;
+}
+
+void Relay::sendHttp(Conn *c, int status, const char *content_type, const std::string &body, bool keep_alive) {
+    const char *reason = status == 200 ? "OK" : status == 201 ? "Created" : status == 400 ? "Bad Request"
+                       : status == 401 ? "Unauthorized" : status == 403 ? "Forbidden"
+                       : status == 404 ? "Not Found" : status == 413 ? "Payload Too Large" : "Error";
+    std::string resp = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n" +
+                       "Content-Type: " + content_type + "\r\n" +
+                       "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                       (keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n") + "\r\n" + body;
+    auto buf = std::make_shared<SharedBuffer>();
+    buf->bytes.assign(resp.begin(), resp.end());
+    buf->recv_us = 0;
+    enqueue(c, buf);
+    if (!keep_alive) c->close_after_flush = true;
+}
+
+// =================================================================
+// --- WebSocket sessions ---
+// =================================================================
+void Relay::processWebSocket(Conn *c) {
+    while (!c->closing && !c->close_after_flush) {
+        uint8_t *base = c->in.data() + c->in_pos;
+        size_t avail = c->in.size() - c->in_pos;
+        WsFrameHeader h;
+        if (!ws_parse_header(base, avail, h)) return;
+        if (!h.masked || h.payload_len > MAX_MESSAGE_BYTES) {
+            // Clients must mask (RFC 6455 5.1); oversized frames are a protocol error here too
+            uint8_t code[2] = {0x03, (uint8_t)(h.masked ? 0xF1 : 0xEA)}; // 1009 / 1002
+            sendFrame(c, WS_OP_CLOSE, code, 2);
+            c->close_after_flush = true;
+            return;
+        }
+        if (avail < h.header_len + h.payload_len) return;
+
+        uint8_t *payload = base + h.header_len;
+        size_t len = (size_t)h.payload_len;
+        ws_apply_mask(payload, len, h.mask);
+        c->in_pos += h.header_len + len;
+
+        if (h.opcode >= WS_OP_CLOSE) {
+            handleMessage(c, h.opcode, payload, len); // control frames are never fragmented
+        } else if (h.opcode != WS_OP_CONTINUATION && h.fin) {
+            handleMessage(c, h.opcode, payload, len);
+        } else {
+            if (h.opcode != WS_OP_CONTINUATION) {
+                c->message.clear();
+                c->message_opcode = h.opcode;
+            }
+            if (c->message.size() + len > MAX_MESSAGE_BYTES) {
+                requestClose(c);
+                return;
+            }
+            c->message.insert(c->message.end(), payload, payload + len);
+            if (h.fin) {
+                handleMessage(c, c->message_opcode, c->message.data(), c->message.size());
+                c->message.clear();
+            }
+        }
+    }
+}
+
+void Relay::handleMessage(Conn *c, uint8_t opcode, uint8_t *payload, size_t len) {
+    switch (opcode) {
+    case WS_OP_BINARY:
+        relayAudio(c, payload, len);
+        break;
+    case WS_OP_TEXT:
+        handleControl(c, std::string((const char *)payload, len));
+        break;
+    case WS_OP_PING:
+        sendFrame(c, WS_OP_PONG, payload, len);
+        break;
+    case WS_OP_CLOSE:
+        sendFrame(c, WS_OP_CLOSE, payload, len >= 2 ? 2 : 0);
+        c->close_after_flush = true;
+        break;
+    default:
+        break;
+    }
+}
+
+void Relay::handleControl(Conn *c, const std::string &text) {
+    metrics.control_messages++;
+    std::string type = json_get_string(text, "type");
+
+    if (type == "caps") {
+        // First codec the client offers that this relay's groups accept; PCM always works
+        std::string chosen = "pcm";
+        for (const std::string &offered : json_get_string_array(text, "codecs")) {
+            bool allowed = false;
+            for (const std::string &a : cfg.codecs) allowed |= (a == offered);
+            if (allowed) {
+                chosen = offered;
+                break;
+            }
+        }
+        c->frame_version = (int)json_get_number(text, "frame", 0) == AUDIO_FRAME_VERSION ? AUDIO_FRAME_VERSION : 0;
+        c->red_ok = c->frame_version && (int)json_get_number(text, "red", 0) == 1;
+        c->dtx_ok = c->frame_version && (int)json_get_number(text, "dtx", 0) == 1;
+        c->mix_ok = c->frame_version && (int)json_get_number(text, "mix", 0) == 1;
+        std::string ack = "{\"type\":\"caps_ack\",\"codec\":" + json_quote(chosen) +
+                          (c->frame_version ? ",\"frame\":1" : "") + (c->red_ok ? ",\"red\":1" : "") +
+                          (c->dtx_ok ? ",\"dtx\":1" : "") + (c->mix_ok ? ",\"mix\":1" : "");
+        // Datagrams carry the frame header, so UDP needs it too
+        if (cfg.udp_port && c->frame_version && (int)json_get_number(text, "udp", 0) == 1 && !c->udp_token) {
+            do {
+                c->udp_token = (uint32_t)rng();
+            } while (c->udp_token == 0 || udp_sessions.count(c->udp_token));
+            udp_sessions[c->udp_token] = c;
+        }
+        if (c->udp_token) {
+            ack += ",\"udp\":" + std::to_string(cfg.udp_port) + ",\"token\":" + std::to_string(c->udp_token);
+        }
+        ack += "}";
+        sendFrame(c, WS_OP_TEXT, (const uint8_t *)ack.data(), ack.size());
+    } else if (type == "talk_start") {
+        c->talking = true;
+        c->talk_codec = json_get_string(text, "codec", "pcm");
+        c->talk_frame = (int)json_get_number(text, "frame", 0) == AUDIO_FRAME_VERSION ? AUDIO_FRAME_VERSION : 0;
+        c->talk_red = c->talk_frame && (int)json_get_number(text, "red", 0) == 1;
+        std::string msg = "{\"type\":\"talk_start\",\"codec\":" + json_quote(c->talk_codec) +
+                          ",\"from\":" + json_quote(c->device_id);
+        if (c->talk_frame) {
+            // Only peers that negotiated headers (and redundancy) are told frames carry them
+            std::string framed = msg + ",\"frame\":1}";
+            std::string red = msg + ",\"frame\":1,\"red\":1}";
+            broadcastText(c, msg + "}", &framed, c->talk_red ? &red : nullptr);
+        } else {
+            broadcastText(c, msg + "}");
+        }
+    } else if (type == "talk_stop") {
+        c->talking = false;
+        broadcastText(c, "{\"type\":\"talk_stop\",\"from\":" + json_quote(c->device_id) + "}");
+    } else if (type == "lat_report" || type == "loss_report") {
+        // Probe and loss answers go back through the group; the talker picks its own by "to"
+        size_t end = text.rfind('}');
+        if (end != std::string::npos) {
+            broadcastText(c, text.substr(0, end) + ",\"from\":" + json_quote(c->device_id) + "}");
+        }
+    } else if (type == "ping") {
+        static const char pong[] = "{\"type\":\"pong\"}";
+        sendFrame(c, WS_OP_TEXT, (const uint8_t *)pong, sizeof(pong) - 1);
+    }
+}
+
+void Relay::broadcastText(Conn *sender, const std::string &text, const std::string *framed_text,
+                          const std::string *red_text) {
+    BufferRef buf = makeFrame(WS_OP_TEXT, (const uint8_t *)text.data(), text.size(), 0);
+    BufferRef framed = framed_text ? makeFrame(WS_OP_TEXT, (const uint8_t *)framed_text->data(),
+                                               framed_text->size(), 0)
+                                   : buf;
+    BufferRef red = red_text ? makeFrame(WS_OP_TEXT, (const uint8_t *)red_text->data(), red_text->size(), 0)
+                             : framed;
+    // Mixing peers get the same text plus the sender's "src", built only if one is in the group
+    BufferRef mix_framed = nullptr;
+    BufferRef mix_red = nullptr;
+
+    for (Conn *peer : groups[sender->group]) {
+        if (peer->closing || (peer == sender && !cfg.echo)) continue;
+        if (peer->mix_ok) {
+            BufferRef &tagged = peer->red_ok ? mix_red : mix_framed;
+            if (!tagged) {
+                const std::string &base = (peer->red_ok && red_text) ? *red_text : framed_text ? *framed_text : text;
+                size_t end = base.rfind('}');
+                std::string msg = base.substr(0, end) + ",\"src\":" + std::to_string(sender->source_id) + "}";
+                tagged = makeFrame(WS_OP_TEXT, (const uint8_t *)msg.data(), msg.size(), 0);
+            }
+            enqueue(peer, tagged);
+            continue;
+        }
+        enqueue(peer, peer->red_ok ? red : peer->frame_version ? framed : buf);
+    }
+}
+
+void Relay::relayAudio(Conn *sender, const uint8_t *payload, size_t len) {
+    metrics.frames_in++;
+    metrics.bytes_in += len;
+
+    // Encode the outgoing frame once; every recipient references the same bytes.
+    // Peers without frame headers share a second, header-stripped copy; in a
+    // redundant burst, peers without "red" share a copy reduced to the primary.
+    bool has_header = sender->talk_frame && len >= AUDIO_FRAME_HEADER_BYTES;
+    size_t red_offset = 0;
+    size_t primary_len = has_header ? len - AUDIO_FRAME_HEADER_BYTES : len;
+    bool has_red = has_header && sender->talk_red &&
+                   red_primary(payload + AUDIO_FRAME_HEADER_BYTES, len - AUDIO_FRAME_HEADER_BYTES, &red_offset,
+                               &primary_len);
+    const uint8_t *primary = payload + (has_header ? AUDIO_FRAME_HEADER_BYTES : 0) + red_offset;
+    // A descriptor would play as noise bursts on peers that do not know it
+    bool is_cn = has_header && (payload[0] & 0x0F) == AUDIO_FRAME_CODEC_CN;
+    BufferRef full = makeFrame(WS_OP_BINARY, payload, len, sender->last_rx_us);
+    BufferRef framed = has_red ? nullptr : full;
+    BufferRef bare = has_header ? nullptr : full;
+    // Copies for mixing peers, with the talker's source id in front
+    BufferRef mix_full = nullptr;
+    BufferRef mix_framed = nullptr;
+    metrics.frame_buffers++;
+
+    for (Conn *peer : groups[sender->group]) {
+        if (peer->closing || (peer == sender && !cfg.echo)) continue;
+        if (is_cn && !peer->dtx_ok) continue;
+        if (has_header && peer->udp_ready) {
+            // Datagrams are never queued: the kernel drops them under pressure instead
+            const uint8_t *source = peer->mix_ok ? &sender->source_id : nullptr;
+            if (has_red && !peer->red_ok) {
+                sendDatagram(peer, MEDIA_DGRAM_AUDIO, payload, AUDIO_FRAME_HEADER_BYTES, primary, primary_len,
+                             source, sender->last_rx_us);
+            } else {
+                sendDatagram(peer, has_red ? MEDIA_DGRAM_AUDIO_RED : MEDIA_DGRAM_AUDIO, payload, len, nullptr, 0,
+                             source, sender->last_rx_us);
+            }
+            metrics.deliveries++;
+            continue;
+        }
+        if (peer->mix_ok) {
+            bool primary_only = has_red && !peer->red_ok;
+            BufferRef &tagged = primary_only ? mix_framed : mix_full;
+            if (!tagged) {
+                std::vector<uint8_t> bytes(AUDIO_FRAME_SOURCE_BYTES, sender->source_id);
+                if (primary_only) {
+                    bytes.insert(bytes.end(), payload, payload + AUDIO_FRAME_HEADER_BYTES);
+                    bytes.insert(bytes.end(), primary, primary + primary_len);
+                } else {
+                    bytes.insert(bytes.end(), payload, payload + len);
+                }
+                tagged = makeFrame(WS_OP_BINARY, bytes.data(), bytes.size(), sender->last_rx_us);
+                metrics.frame_buffers++;
+            }
+        }
+        if (!peer->mix_ok && has_header && !peer->frame_version && !bare) {
+            bare = makeFrame(WS_OP_BINARY, primary, primary_len, sender->last_rx_us);
+            metrics.frame_buffers++;
+        }
+        if (!peer->mix_ok && has_red && peer->frame_version && !peer->red_ok && !framed) {
+            std::vector<uint8_t> stripped(payload, payload + AUDIO_FRAME_HEADER_BYTES);
+            stripped.insert(stripped.end(), primary, primary + primary_len);
+            framed = makeFrame(WS_OP_BINARY, stripped.data(), stripped.size(), sender->last_rx_us);
+            metrics.frame_buffers++;
+        }
+        const BufferRef &ref = peer->mix_ok                         ? (has_red && !peer->red_ok ? mix_framed : mix_full)
+                               : !(has_header && peer->frame_version) ? bare
+                               : (has_red && peer->red_ok)          ? full
+                                                                    : framed;
+        if (peer->out_bytes + ref->bytes.size() > cfg.queue_limit) {
+            // Slow consumer: drop for this peer only
+            peer->dropped++;
+            metrics.frames_dropped++;
+            continue;
+        }
+        enqueue(peer, ref);
+        metrics.deliveries++;
+    }
+}
+
+void Relay::receiveDatagrams() {
+    uint8_t buf[MAX_DATAGRAM_BYTES];
+    while (true) {
+        sockaddr_in from = {};
+        socklen_t from_len = sizeof(from);
+        ssize_t n = recvfrom(udp_fd, buf, sizeof(buf), 0, (sockaddr *)&from, &from_len);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("recvfrom");
+            return;
+        }
+        if ((size_t)n < MEDIA_DGRAM_PREFIX_BYTES) continue;
+        metrics.datagrams_in++;
+        uint32_t token = (uint32_t)buf[1] | ((uint32_t)buf[2] << 8) | ((uint32_t)buf[3] << 16) |
+                         ((uint32_t)buf[4] << 24);
+        auto it = udp_sessions.find(token);
+        if (it == udp_sessions.end() || it->second->closing) continue;
+        Conn *c = it->second;
+
+        if (buf[0] == MEDIA_DGRAM_HELLO) {
+            // The HELLO's source is the session's (possibly NATed) media address
+            if (!c->udp_ready || memcmp(&c->udp_addr, &from, sizeof(from)) != 0) {
+                c->udp_addr = from;
+                c->udp_ready = true;
+            }
+            c->last_rx_us = now_us();
+            sendDatagram(c, MEDIA_DGRAM_HELLO_ACK, nullptr, 0);
+        } else if ((buf[0] == MEDIA_DGRAM_AUDIO || buf[0] == MEDIA_DGRAM_AUDIO_RED) && c->udp_ready &&
+                   memcmp(&c->udp_addr, &from, sizeof(from)) == 0) {
+            // Self-describing: may overtake the talk_start still in the TCP stream
+            c->last_rx_us = now_us();
+            c->talk_frame = AUDIO_FRAME_VERSION;
+            c->talk_red = buf[0] == MEDIA_DGRAM_AUDIO_RED;
+            relayAudio(c, buf + MEDIA_DGRAM_PREFIX_BYTES, (size_t)n - MEDIA_DGRAM_PREFIX_BYTES);
+        }
+    }
+}
+
+void Relay::sendDatagram(Conn *peer, uint8_t kind, const uint8_t *a, size_t a_len, const uint8_t *b, size_t b_len,
+                         const uint8_t *source, int64_t recv_us) {
+    if (cfg.udp_loss_pct > 0 && kind != MEDIA_DGRAM_HELLO_ACK &&
+        std::uniform_real_distribution<double>(0.0, 100.0)(rng) < cfg.udp_loss_pct) {
+        metrics.datagrams_impaired++;
+        return;
+    }
+    uint8_t prefix[MEDIA_DGRAM_PREFIX_BYTES] = {kind, (uint8_t)peer->udp_token, (uint8_t)(peer->udp_token >> 8),
+                                                (uint8_t)(peer->udp_token >> 16), (uint8_t)(peer->udp_token >> 24)};
+    iovec iov[4];
+    size_t parts = 0;
+    iov[parts++] = {prefix, sizeof(prefix)};
+    if (source) iov[parts++] = {(void *)source, AUDIO_FRAME_SOURCE_BYTES};
+    if (a) iov[parts++] = {(void *)a, a_len};
+    if (b) iov[parts++] = {(void *)b, b_len};
+    msghdr msg = {};
+    msg.msg_name = &peer->udp_addr;
+    msg.msg_namelen = sizeof(peer->udp_addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = parts;
+    ssize_t n = sendmsg(udp_fd, &msg, 0);
+    if (n > 0) {
+        metrics.datagrams_out++;
+        metrics.bytes_out += (uint64_t)n;
+        // Handed to the kernel: the datagram counterpart of a WebSocket frame fully written
+        if (recv_us) metrics.recordLatency(now_us() - recv_us);
+    }
+}
+
+void Relay::sendFrame(Conn *c, uint8_t opcode, const uint8_t *payload, size_t len) {
+    enqueue(c, makeFrame(opcode, payload, len, 0));
+}
+
+BufferRef Relay::makeFrame(uint8_t opcode, const uint8_t *payload, size_t len, int64_t recv_us) {
+    auto buf = std::make_shared<SharedBuffer>();
+    uint8_t hdr[WS_MAX_HEADER_BYTES];
+    size_t hlen = ws_encode_header(hdr, opcode, len, nullptr);
+    buf->bytes.reserve(hlen + len);
+    buf->bytes.assign(hdr, hdr + hlen);
+    if (len) buf->bytes.insert(buf->bytes.end(), payload, payload + len);
+    buf->recv_us = recv_us;
+    return buf;
+}
+
+// =================================================================
+// --- Output ---
+// =================================================================
+void Relay::enqueue(Conn *c, const BufferRef &buf) {
+    c->out.push_back(OutChunk{buf, 0});
+    c->out_bytes += buf->bytes.size();
+    if (c->out_bytes > metrics.queue_bytes_max) metrics.queue_bytes_max = c->out_bytes;
+    if (!c->dirty) {
+        c->dirty = true;
+        dirty.push_back(c);
+    }
+}
+
+void Relay::flush(Conn *c) {
+    while (!c->out.empty()) {
+        iovec iov[MAX_IOV];
+        int n = 0;
+        for (auto it = c->out.begin(); it != c->out.end() && n < MAX_IOV; ++it, ++n) {
+            iov[n].iov_base = (void *)(it->buf->bytes.data() + it->offset);
+            iov[n].iov_len = it->buf->bytes.size() - it->offset;
+        }
+        ssize_t w = writev(c->fd, iov, n);
+        metrics.writev_calls++;
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                setEpollOut(c, true);
+                return;
+            }
+            requestClose(c);
+            return;
+        }
+        metrics.bytes_out += (uint64_t)w;
+        c->out_bytes -= (size_t)w;
+
+        int64_t now = now_us();
+        size_t left = (size_t)w;
+        while (left > 0) {
+            OutChunk &front = c->out.front();
+            size_t remain = front.buf->bytes.size() - front.offset;
+            if (left < remain) {
+                front.offset += left;
+                break;
+            }
+            left -= remain;
+            if (front.buf->recv_us) metrics.recordLatency(now - front.buf->recv_us);
+            c->out.pop_front();
+        }
+    }
+
+    setEpollOut(c, false);
+    if (c->close_after_flush) requestClose(c);
+}
+
+// Send everything queued during this iteration (as few writev()s as possible),
+// then free closed connections; closing a talker queues a talk_stop, so repeat
+void Relay::drain() {
+    while (!dirty.empty() || !to_close.empty()) {
+        std::vector<Conn *> batch;
+        batch.swap(dirty);
+        for (Conn *c : batch) {
+            c->dirty = false;
+            if (!c->closing) flush(c);
+        }
+        std::vector<Conn *> doomed;
+        doomed.swap(to_close);
+        for (Conn *c : doomed) destroy(c);
+    }
+}
+
+void Relay::setEpollOut(Conn *c, bool on) {
+    if (c->epollout == on) return;
+    c->epollout = on;
+    epoll_event ev = {};
+    ev.events = on ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.ptr = c;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+void Relay::requestClose(Conn *c) {
+    if (c->closing) return;
+    c->closing = true;
+    to_close.push_back(c);
+}
+
+void Relay::destroy(Conn *c) {
+    if (c->websocket) {
+        auto s = sessions.find(c->device_id);
+        if (s != sessions.end() && s->second == c) sessions.erase(s);
+        std::vector<Conn *> &g = groups[c->group];
+        for (size_t i = 0; i < g.size(); i++) {
+            if (g[i] == c) {
+                g[i] = g.back();
+                g.pop_back();
+                break;
+            }
+        }
+        if (c->udp_token) udp_sessions.erase(c->udp_token);
+        // Peers must not wait for a talk_stop that will never come
+        if (c->talking) broadcastText(c, "{\"type\":\"talk_stop\",\"from\":" + json_quote(c->device_id) + "}");
+    }
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, nullptr);
+    close(c->fd);
+    connection_count--;
+    delete c;
+}
+
+void Relay::sweepIdle(int64_t now) {
+    if (!cfg.idle_s) return;
+    int64_t limit = (int64_t)cfg.idle_s * 1000000;
+    for (auto &kv : sessions) {
+        Conn *c = kv.second;
+        if (!c->closing && now - c->last_rx_us > limit) {
+            metrics.idle_timeouts++;
+            requestClose(c);
+        }
+    }
+}
+
+// =================================================================
+// --- Metrics ---
+// =================================================================
+std::string Relay::metricsText() {
+    std::string s;
+    char line[512];
+    auto counter = [&](const char *name, const char *help, uint64_t v) {
+        snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", name, help, name, name,
+                 (unsigned long long)v);
+        s += line;
+    };
+    auto gauge = [&](const char *name, const char *help, double v) {
+        snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s gauge\n%s %.6g\n", name, help, name, name, v);
+        s += line;
+    };
+
+    size_t talkers = 0;
+    for (auto &kv : sessions) talkers += kv.second->talking ? 1 : 0;
+
+    gauge("ptt_relay_connections", "Open TCP connections", (double)connection_count);
+    gauge("ptt_relay_sessions", "Authenticated WebSocket sessions", (double)sessions.size());
+    gauge("ptt_relay_talkers", "Sessions between talk_start and talk_stop", (double)talkers);
+    gauge("ptt_relay_users", "Registered users", (double)users.size());
+    gauge("ptt_relay_queue_bytes_max", "Largest per-connection send queue seen", (double)metrics.queue_bytes_max);
+    counter("ptt_relay_http_requests_total", "HTTP requests parsed", metrics.http_requests);
+    counter("ptt_relay_ws_accepted_total", "WebSocket upgrades accepted", metrics.ws_accepted);
+    counter("ptt_relay_ws_rejected_total", "WebSocket upgrades rejected", metrics.ws_rejected);
+    counter("ptt_relay_sessions_replaced_total", "Sessions closed by a reconnect of the same device",
+            metrics.sessions_replaced);
+    counter("ptt_relay_idle_timeouts_total", "Sessions closed for inactivity", metrics.idle_timeouts);
+    counter("ptt_relay_control_messages_total", "JSON control messages received", metrics.control_messages);
+    counter("ptt_relay_frames_in_total", "Binary audio frames received", metrics.frames_in);
+    counter("ptt_relay_bytes_in_total", "Audio payload bytes received", metrics.bytes_in);
+    counter("ptt_relay_frame_buffers_total", "Shared fan-out buffers allocated", metrics.frame_buffers);
+    counter("ptt_relay_deliveries_total", "Audio frame references queued to recipients", metrics.deliveries);
+    counter("ptt_relay_frames_dropped_total", "Audio frames dropped for slow recipients", metrics.frames_dropped);
+    counter("ptt_relay_bytes_out_total", "Bytes written to sockets", metrics.bytes_out);
+    counter("ptt_relay_writev_calls_total", "writev() calls", metrics.writev_calls);
+    counter("ptt_relay_datagrams_in_total", "Media datagrams received", metrics.datagrams_in);
+    counter("ptt_relay_datagrams_out_total", "Media datagrams sent", metrics.datagrams_out);
+    counter("ptt_relay_datagrams_impaired_total", "Media datagrams dropped by --udp-loss",
+            metrics.datagrams_impaired);
+    gauge("ptt_relay_loop_busy_seconds_total", "Time spent handling events", metrics.loop_busy_us / 1e6);
+
+    s += "# HELP ptt_relay_forward_latency_us Frame receive to last byte written, per recipient\n"
+         "# TYPE ptt_relay_forward_latency_us histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= LATENCY_BUCKETS; i++) {
+        cumulative += metrics.latency_counts[i];
+        if (i < LATENCY_BUCKETS) {
+            snprintf(line, sizeof(line), "ptt_relay_forward_latency_us_bucket{le=\"%u\"} %llu\n",
+                     (unsigned)LATENCY_BOUNDS_US[i], (unsigned long long)cumulative);
+        } else {
+            snprintf(line, sizeof(line), "ptt_relay_forward_latency_us_bucket{le=\"+Inf\"} %llu\n",
+                     (unsigned long long)cumulative);
+        }
+        s += line;
+    }
+    snprintf(line, sizeof(line), "ptt_relay_forward_latency_us_sum %llu\nptt_relay_forward_latency_us_count %llu\n",
+             (unsigned long long)metrics.latency_sum_us, (unsigned long long)metrics.latency_samples);
+    s += line;
+    return s;
+}
+
+void Relay::printStats(bool final_line) {
+    int64_t now = now_us();
+    double dt = (now - last_stats_us) / 1e6;
+    if (dt <= 0) dt = 1;
+    double avg_lat = metrics.latency_samples ? (double)metrics.latency_sum_us / metrics.latency_samples : 0.0;
+    printf("[RELAY]%s conns=%zu sessions=%zu in=%.0f/s out=%.0f/s dropped=%llu (+%llu) fanout=%.2f "
+           "avg_lat=%.0fus queue_max=%zuB busy=%.1f%%\n",
+           final_line ? "[final]" : "", connection_count, sessions.size(),
+           (metrics.frames_in - last_frames_in) / dt, (metrics.deliveries - last_deliveries) / dt,
+           (unsigned long long)metrics.frames_dropped, (unsigned long long)(metrics.frames_dropped - last_dropped),
+           metrics.frame_buffers ? (double)metrics.deliveries / metrics.frame_buffers : 0.0, avg_lat,
+           metrics.queue_bytes_max, (metrics.loop_busy_us - last_busy_us) / (dt * 1e4));
+    fflush(stdout);
+    last_stats_us = now;
+    last_frames_in = metrics.frames_in;
+    last_deliveries = metrics.deliveries;
+    last_dropped = metrics.frames_dropped;
+    last_busy_us = metrics.loop_busy_us;
+}
+
+// =================================================================
+// --- Main ---
+// =================================================================
+static void on_signal(int) {
+    stop_requested = 1;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Usage: ptt_relay [--port 8000] [--group-size N] [--codecs opus,adpcm,pcm]\n"
+            "                 [--queue-kb 256] [--idle-s 60] [--stats-s 10] [--echo]\n"
+            "                 [--udp-port 0] [--udp-loss PCT]\n");
+}
+
+int main(int argc, char **argv) {
+    RelayConfig cfg;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--echo") {
+            cfg.echo = true;
+            continue;
+        }
+        if (!val) {
+            usage();
+            return 1;
+        }
+        i++;
+        if (arg == "--port") cfg.port = (uint16_t)atoi(val);
+        else if (arg == "--group-size") cfg.group_size = (uint32_t)atoi(val);
+        else if (arg == "--queue-kb") cfg.queue_limit = (size_t)atoi(val) * 1024;
+        else if (arg == "--idle-s") cfg.idle_s = (uint32_t)atoi(val);
+        else if (arg == "--stats-s") cfg.stats_s = (uint32_t)atoi(val);
+        else if (arg == "--udp-port") cfg.udp_port = (uint16_t)atoi(val);
+        else if (arg == "--udp-loss") cfg.udp_loss_pct = atof(val);
+        else if (arg == "--codecs") {
+            cfg.codecs.clear();
+            std::string list = val;
+            size_t p = 0;
+            while (p <= list.size()) {
+                size_t comma = list.find(',', p);
+                if (comma == std::string::npos) comma = list.size();
+                if (comma > p) cfg.codecs.push_back(list.substr(p, comma - p));
+                p = comma + 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    Relay relay(cfg);
+    if (!relay.listenOn(cfg.port)) {
+        fprintf(stderr, "Cannot listen on port %u\n", cfg.port);
+        return 1;
+    }
+    if (cfg.udp_port && !relay.openMediaPort(cfg.udp_port)) {
+        fprintf(stderr, "Cannot open media port %u\n", cfg.udp_port);
+        return 1;
+    }
+    printf("PTT relay on :%u (group size %u, queue %zu KB%s)", cfg.port, cfg.group_size, cfg.queue_limit / 1024,
+           cfg.echo ? ", echo" : "");
+    if (cfg.udp_port) printf(", media udp :%u (loss %.1f%%)", cfg.udp_port, cfg.udp_loss_pct);
+    printf("\n");
+    fflush(stdout);
+    relay.run();
+    relay.printStats(true);
+    return 0;
+}